@@ -0,0 +1,505 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingIngestServer.h"
+
+#include <atomic>
+
+#include "BowlingIngestProtocol.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreIngest.h"
+#include "Containers/Queue.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "SocketSubsystem.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/*
+ * FSocket can only wait on one socket at a time, so the ingest sockets are native ones that the worker waits on
+ * together with poll (WSAPoll on Windows).
+ */
+namespace BowlingIngestSockets
+{
+#if PLATFORM_WINDOWS
+	using FNativeSocket = SOCKET;
+	constexpr FNativeSocket InvalidSocket = INVALID_SOCKET;
+
+	int32 Poll(pollfd* Sockets, int32 NumSockets, int32 TimeoutMs) { return WSAPoll(Sockets, NumSockets, TimeoutMs); }
+	void Close(FNativeSocket Socket) { closesocket(Socket); }
+	bool WouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+	bool WasInterrupted() { return WSAGetLastError() == WSAEINTR; }
+
+	bool SetNonBlocking(FNativeSocket Socket)
+	{
+		u_long NonBlocking = 1;
+		return ioctlsocket(Socket, FIONBIO, &NonBlocking) == 0;
+	}
+#else
+	using FNativeSocket = int;
+	constexpr FNativeSocket InvalidSocket = -1;
+
+	int32 Poll(pollfd* Sockets, int32 NumSockets, int32 TimeoutMs) { return poll(Sockets, NumSockets, TimeoutMs); }
+	void Close(FNativeSocket Socket) { close(Socket); }
+	bool WouldBlock() { return errno == EAGAIN or errno == EWOULDBLOCK; }
+	bool WasInterrupted() { return errno == EINTR; }
+
+	bool SetNonBlocking(FNativeSocket Socket)
+	{
+		const auto Flags = fcntl(Socket, F_GETFL, 0);
+		return Flags >= 0 and fcntl(Socket, F_SETFL, Flags | O_NONBLOCK) == 0;
+	}
+#endif
+
+	// Receive into a buffer. Returns the bytes read, 0 when there's nothing to read yet and -1 once the socket is
+	// closed or failed.
+	int32 Recv(FNativeSocket Socket, uint8* Buffer, int32 Size)
+	{
+		const auto BytesRead = static_cast<int32>(recv(Socket, reinterpret_cast<char*>(Buffer), Size, 0));
+		if (BytesRead > 0) { return BytesRead; }
+		return BytesRead < 0 and WouldBlock() ? 0 : -1;
+	}
+
+	// Open a non-blocking IPv4 socket bound to a port on loopback or every address, 0 for any free port
+	FNativeSocket Open(int32 Type, int32 Port, bool bLoopbackOnly)
+	{
+		const auto Socket = socket(AF_INET, Type, 0);
+		if (Socket == InvalidSocket) { return InvalidSocket; }
+
+		const int32 Enable = 1;
+		setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&Enable), sizeof(Enable));
+
+		sockaddr_in Address = {};
+		Address.sin_family = AF_INET;
+		Address.sin_addr.s_addr = htonl(bLoopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+		Address.sin_port = htons(static_cast<uint16>(Port));
+
+		auto bOpened = SetNonBlocking(Socket)
+			and bind(Socket, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) == 0;
+		if (bOpened and Type == SOCK_STREAM)
+		{
+			bOpened = listen(Socket, SOMAXCONN) == 0;
+		}
+
+		if (not bOpened)
+		{
+			Close(Socket);
+			return InvalidSocket;
+		}
+		return Socket;
+	}
+
+	// Port a socket is bound to, -1 if it isn't
+	int32 GetPort(FNativeSocket Socket)
+	{
+		sockaddr_in Address = {};
+		socklen_t AddressSize = sizeof(Address);
+		if (getsockname(Socket, reinterpret_cast<sockaddr*>(&Address), &AddressSize) != 0) { return -1; }
+		return ntohs(Address.sin_port);
+	}
+
+	// Loopback datagram socket connected to itself, for waking a thread blocked in Poll by sending it a byte
+	FNativeSocket OpenWakeSocket()
+	{
+		const auto Socket = Open(SOCK_DGRAM, 0, true);
+		if (Socket == InvalidSocket) { return InvalidSocket; }
+
+		sockaddr_in Address = {};
+		Address.sin_family = AF_INET;
+		Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		Address.sin_port = htons(static_cast<uint16>(GetPort(Socket)));
+		if (connect(Socket, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0)
+		{
+			Close(Socket);
+			return InvalidSocket;
+		}
+		return Socket;
+	}
+}
+
+using namespace BowlingIngestSockets;
+
+/*
+ * Reads every socket on its own thread and queues the messages for the game thread.
+ *
+ * The thread blocks in a single poll across the listen socket, the datagram socket and every connection, so it only
+ * wakes when one of them has something and never sits waiting on one lane while another has data. Each wake accepts
+ * and drains whatever the ready sockets have. Stopping sends a byte to a loopback socket that's part of the same poll.
+ */
+class FBowlingIngestWorker : public FRunnable
+{
+public:
+	// Takes ownership of the sockets. The wake socket has to be connected to itself, see OpenWakeSocket.
+	FBowlingIngestWorker(FNativeSocket InListenSocket, FNativeSocket InDatagramSocket, FNativeSocket InWakeSocket)
+		: ListenSocket(InListenSocket), DatagramSocket(InDatagramSocket), WakeSocket(InWakeSocket)
+	{
+		Thread = FRunnableThread::Create(this, TEXT("BowlingIngest"), 0, TPri_AboveNormal);
+	}
+
+	virtual ~FBowlingIngestWorker() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+			delete Thread;
+		}
+
+		for (auto&& Connection : Connections)
+		{
+			Close(Connection.Socket);
+		}
+		for (const auto Socket : {ListenSocket, DatagramSocket, WakeSocket})
+		{
+			if (Socket != InvalidSocket) { Close(Socket); }
+		}
+	}
+
+	virtual uint32 Run() override
+	{
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+
+		while (not bStopping)
+		{
+			if (not WaitForData()) { continue; }
+
+			// Connections are last and in the same order as Connections, so they're read back to front before any
+			// are added or removed
+			for (auto Idx = PollSockets.Num() - 1; Idx >= NumFixedSockets; Idx--)
+			{
+				if (PollSockets[Idx].revents != 0) { ReadConnection(Idx - NumFixedSockets); }
+			}
+			for (auto Idx = 0; Idx < NumFixedSockets; Idx++)
+			{
+				if (PollSockets[Idx].revents == 0) { continue; }
+
+				const auto Socket = PollSockets[Idx].fd;
+				if (Socket == DatagramSocket) { ReadDatagrams(); }
+				else if (Socket == ListenSocket) { AcceptConnections(); }
+				else { DrainWakes(); }
+			}
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+
+		const uint8 Wake = 0;
+		if (WakeSocket != InvalidSocket) { send(WakeSocket, reinterpret_cast<const char*>(&Wake), 1, 0); }
+	}
+
+	// Parsed messages, in the order they arrived on each socket
+	TQueue<FBowlingIngestMessage, EQueueMode::Spsc> Messages;
+
+	std::atomic<int64> NumMalformed = 0;
+
+private:
+	// Big enough for a few hundred messages per read
+	static constexpr int32 ReadSize = 4096;
+
+	struct FConnection
+	{
+		FNativeSocket Socket = InvalidSocket;
+
+		// Bytes of a message split across reads
+		TArray<uint8, TInlineAllocator<FBowlingIngestMessage::Size>> Partial;
+	};
+
+	// Block until any socket has something to read. Returns false if the wait failed or was interrupted.
+	bool WaitForData()
+	{
+		// TCP or UDP may be turned off, so only the sockets that are open come ahead of the connections
+		PollSockets.Reset();
+		for (const auto Socket : {WakeSocket, ListenSocket, DatagramSocket})
+		{
+			if (Socket != InvalidSocket) { PollSockets.Add({Socket, POLLIN, 0}); }
+		}
+		NumFixedSockets = PollSockets.Num();
+		for (auto&& Connection : Connections)
+		{
+			PollSockets.Add({Connection.Socket, POLLIN, 0});
+		}
+
+		const auto NumReady = Poll(PollSockets.GetData(), PollSockets.Num(), -1);
+		if (NumReady < 0 and not WasInterrupted())
+		{
+			UE_LOG(LogBowlingIngest, Error, TEXT("Waiting on ingest sockets failed, stopping"));
+			bStopping = true;
+		}
+		return NumReady > 0;
+	}
+
+	void AcceptConnections()
+	{
+		for (;;)
+		{
+			const auto Socket = accept(ListenSocket, nullptr, nullptr);
+			if (Socket == InvalidSocket) { break; }
+
+			const int32 NoDelay = 1;
+			setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&NoDelay), sizeof(NoDelay));
+			if (not SetNonBlocking(Socket))
+			{
+				Close(Socket);
+				continue;
+			}
+			Connections.Add({Socket});
+		}
+	}
+
+	void ReadConnection(int32 Idx)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingIngestWorker::ReadConnection);
+
+		auto& Connection = Connections[Idx];
+
+		int32 BytesRead = 0;
+		do
+		{
+			BytesRead = Recv(Connection.Socket, Buffer, ReadSize);
+			if (BytesRead > 0) { ParseStream(Connection, BytesRead); }
+		}
+		while (BytesRead == ReadSize);
+
+		if (BytesRead < 0)
+		{
+			NumMalformed += Connection.Partial.Num();
+			Close(Connection.Socket);
+			Connections.RemoveAtSwap(Idx);
+		}
+	}
+
+	void ReadDatagrams()
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingIngestWorker::ReadDatagrams);
+
+		for (;;)
+		{
+			const auto BytesRead = Recv(DatagramSocket, Buffer, ReadSize);
+			if (BytesRead <= 0) { break; }
+
+			// Each datagram holds whole messages, anything left over was cut short
+			const auto NumMessages = BytesRead / FBowlingIngestMessage::Size;
+			for (auto Message = 0; Message < NumMessages; Message++)
+			{
+				Enqueue(Buffer + Message * FBowlingIngestMessage::Size);
+			}
+			NumMalformed += BytesRead % FBowlingIngestMessage::Size;
+		}
+	}
+
+	// The bytes sent by Stop are only there to end the poll
+	void DrainWakes()
+	{
+		while (Recv(WakeSocket, Buffer, ReadSize) > 0) {}
+	}
+
+	void ParseStream(FConnection& Connection, int32 BytesRead)
+	{
+		const uint8* Data = Buffer;
+		const auto* End = Buffer + BytesRead;
+
+		// Finish the message left over from the last read
+		if (Connection.Partial.Num() > 0)
+		{
+			const auto Missing = FMath::Min(FBowlingIngestMessage::Size - Connection.Partial.Num(),
+			                                static_cast<int32>(End - Data));
+			Connection.Partial.Append(Data, Missing);
+			Data += Missing;
+			if (Connection.Partial.Num() < FBowlingIngestMessage::Size) { return; }
+
+			Enqueue(Connection.Partial.GetData());
+			Connection.Partial.Reset();
+		}
+
+		for (; End - Data >= FBowlingIngestMessage::Size; Data += FBowlingIngestMessage::Size)
+		{
+			Enqueue(Data);
+		}
+		Connection.Partial.Append(Data, static_cast<int32>(End - Data));
+	}
+
+	void Enqueue(const uint8* Data)
+	{
+		FBowlingIngestMessage Message;
+		if (Message.Read(Data))
+		{
+			Messages.Enqueue(Message);
+		}
+		else
+		{
+			NumMalformed += FBowlingIngestMessage::Size;
+		}
+	}
+
+	FNativeSocket ListenSocket = InvalidSocket;
+	FNativeSocket DatagramSocket = InvalidSocket;
+	FNativeSocket WakeSocket = InvalidSocket;
+	TArray<FConnection> Connections;
+
+	// Every open socket and then every connection, as handed to the last poll
+	TArray<pollfd> PollSockets;
+	int32 NumFixedSockets = 0;
+
+	uint8 Buffer[ReadSize];
+
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopping = false;
+};
+
+bool UBowlingIngestServer::Start(int32 InStreamPort, int32 InDatagramPort, bool bLoopbackOnly)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	Stop();
+
+	// Loads the socket subsystem, which is what starts Winsock on Windows
+	if (not ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)) { return false; }
+
+	auto ListenSocket = InvalidSocket;
+	auto DatagramSocket = InvalidSocket;
+	auto WakeSocket = OpenWakeSocket();
+	auto bOpened = WakeSocket != InvalidSocket;
+	if (bOpened and InStreamPort >= 0)
+	{
+		ListenSocket = Open(SOCK_STREAM, InStreamPort, bLoopbackOnly);
+		bOpened = ListenSocket != InvalidSocket;
+	}
+	if (bOpened and InDatagramPort >= 0)
+	{
+		DatagramSocket = Open(SOCK_DGRAM, InDatagramPort, bLoopbackOnly);
+		bOpened = DatagramSocket != InvalidSocket;
+	}
+
+	if (not bOpened)
+	{
+		UE_LOG(LogBowlingIngest, Error, TEXT("Could not open sockets on TCP %d, UDP %d"), InStreamPort, InDatagramPort);
+		for (const auto Socket : {ListenSocket, DatagramSocket, WakeSocket})
+		{
+			if (Socket != InvalidSocket) { Close(Socket); }
+		}
+		return false;
+	}
+
+	StreamPort = ListenSocket != InvalidSocket ? GetPort(ListenSocket) : -1;
+	DatagramPort = DatagramSocket != InvalidSocket ? GetPort(DatagramSocket) : -1;
+	Worker = MakeShared<FBowlingIngestWorker>(ListenSocket, DatagramSocket, WakeSocket);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UBowlingIngestServer::Tick));
+
+	UE_LOG(LogBowlingIngest, Display, TEXT("Listening for lanes on TCP %d, UDP %d"), StreamPort, DatagramPort);
+	return true;
+}
+
+void UBowlingIngestServer::Stop()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+
+	// Joins the thread and closes the sockets
+	Worker.Reset();
+	StreamPort = -1;
+	DatagramPort = -1;
+}
+
+void UBowlingIngestServer::AddLane(int32 LaneId, UBowlingScoreComponent* BowlingScoreComponent)
+{
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+
+	Lanes.Add(LaneId, BowlingScoreComponent);
+	LaneSequences.Remove(LaneId);
+}
+
+void UBowlingIngestServer::RemoveLane(int32 LaneId)
+{
+	Lanes.Remove(LaneId);
+	LaneSequences.Remove(LaneId);
+}
+
+int32 UBowlingIngestServer::ApplyPending()
+{
+	if (not Worker) { return 0; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingIngestServer::ApplyPending);
+
+	auto NumHandled = 0;
+	FBowlingIngestMessage Message;
+	while (NumHandled < MaxMessagesPerTick and Worker->Messages.Dequeue(Message))
+	{
+		NumHandled++;
+
+		auto* BowlingScoreComponent = Lanes.FindRef(Message.LaneId);
+		if (not IsValid(BowlingScoreComponent))
+		{
+			NumRejected++;
+			continue;
+		}
+
+		// Datagrams can be repeated or arrive late, only ever move a lane's sequence forward
+		if (Message.Sequence != 0)
+		{
+			auto& LastSequence = LaneSequences.FindOrAdd(Message.LaneId, 0);
+			if (LastSequence != 0 and static_cast<int32>(Message.Sequence - LastSequence) <= 0)
+			{
+				NumRejected++;
+				continue;
+			}
+			LastSequence = Message.Sequence;
+		}
+
+		switch (Message.Type)
+		{
+		case FBowlingIngestMessage::EType::Shot:
+			if (BowlingScoreComponent->SetScore(Message.Pins))
+			{
+				NumApplied++;
+			}
+			else
+			{
+				UE_LOG(LogBowlingIngest, Warning, TEXT("Lane %d: rejected shot of %d"), Message.LaneId, Message.Pins);
+				NumRejected++;
+			}
+			break;
+		case FBowlingIngestMessage::EType::Reset:
+			BowlingScoreComponent->Reset();
+			NumApplied++;
+			break;
+		}
+	}
+	return NumHandled;
+}
+
+int64 UBowlingIngestServer::GetNumMalformed() const
+{
+	return Worker ? Worker->NumMalformed.load() : 0;
+}
+
+void UBowlingIngestServer::BeginDestroy()
+{
+	Stop();
+
+	Super::BeginDestroy();
+}
+
+bool UBowlingIngestServer::Tick(float DeltaTime)
+{
+	ApplyPending();
+	return true;
+}
@@ -0,0 +1,19 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BowlingScoreIngest.h"
+
+DEFINE_LOG_CATEGORY(LogBowlingIngest);
+
+#define LOCTEXT_NAMESPACE "FBowlingScoreIngestModule"
+
+void FBowlingScoreIngestModule::StartupModule()
+{
+}
+
+void FBowlingScoreIngestModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FBowlingScoreIngestModule, BowlingScoreIngest)
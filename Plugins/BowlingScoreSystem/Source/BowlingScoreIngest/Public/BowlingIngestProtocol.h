@@ -0,0 +1,58 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Message from a lane controller or pinsetter. Every message is 8 bytes, little endian: Type, Pins, LaneId (2 bytes)
+ * and Sequence (4 bytes). Messages are sent back to back over TCP, or packed several to a UDP datagram.
+ */
+struct FBowlingIngestMessage
+{
+	static constexpr int32 Size = 8;
+
+	enum class EType : uint8
+	{
+		Shot = 1,
+		Reset = 2,
+	};
+
+	EType Type = EType::Shot;
+
+	// Pinfall, for shots
+	uint8 Pins = 0;
+
+	// Lane the message is for, numbered from 1
+	uint16 LaneId = 0;
+
+	// Increases with every message a lane sends, so repeated and late datagrams can be dropped.
+	// 0 for messages that are always applied, e.g. over TCP where they can't arrive out of order.
+	uint32 Sequence = 0;
+
+	void Write(uint8* Out) const
+	{
+		Out[0] = static_cast<uint8>(Type);
+		Out[1] = Pins;
+		Out[2] = static_cast<uint8>(LaneId);
+		Out[3] = static_cast<uint8>(LaneId >> 8);
+		for (auto Byte = 0; Byte < 4; Byte++)
+		{
+			Out[4 + Byte] = static_cast<uint8>(Sequence >> (Byte * 8));
+		}
+	}
+
+	// Returns false if the message isn't one we know
+	bool Read(const uint8* In)
+	{
+		Type = static_cast<EType>(In[0]);
+		Pins = In[1];
+		LaneId = static_cast<uint16>(In[2] | In[3] << 8);
+		Sequence = 0;
+		for (auto Byte = 0; Byte < 4; Byte++)
+		{
+			Sequence |= static_cast<uint32>(In[4 + Byte]) << (Byte * 8);
+		}
+		return (Type == EType::Shot or Type == EType::Reset) and LaneId != 0;
+	}
+};
@@ -0,0 +1,92 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/Object.h"
+#include "BowlingIngestServer.generated.h"
+
+class FBowlingIngestWorker;
+class UBowlingScoreComponent;
+
+/*
+ * Accepts shots from lane controllers and pinsetters, see FBowlingIngestMessage.
+ *
+ * Sockets are read on a dedicated thread, which blocks in one wait across every socket and only reads the ones that
+ * are ready, so an idle center costs nothing and a busy lane is never waiting behind a quiet one. Parsed messages are
+ * queued for the game thread, which applies everything that's arrived to each lane's game once per tick.
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCOREINGEST_API UBowlingIngestServer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Start listening for TCP connections and UDP datagrams. Ports of 0 pick any free port and -1 turns the socket off.
+	// Returns false if a socket couldn't be opened.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	bool Start(int32 StreamPort, int32 DatagramPort, bool bLoopbackOnly = false);
+
+	// Close every socket, dropping messages not applied yet
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void Stop();
+
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	bool IsRunning() const { return Worker.IsValid(); }
+
+	// Ports actually being listened on, -1 if not
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	int32 GetStreamPort() const { return StreamPort; }
+
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	int32 GetDatagramPort() const { return DatagramPort; }
+
+	// Send messages for a lane to a game. Lanes are numbered from 1.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddLane(int32 LaneId, UBowlingScoreComponent* BowlingScoreComponent);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveLane(int32 LaneId);
+
+	// Apply every message received so far. Called every tick while running. Returns the number of messages handled.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 ApplyPending();
+
+	// Messages applied to a game
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	int64 GetNumApplied() const { return NumApplied; }
+
+	// Messages for unknown lanes, repeated or late datagrams, and shots the game wouldn't take
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	int64 GetNumRejected() const { return NumRejected; }
+
+	// Bytes that couldn't be parsed as messages
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	int64 GetNumMalformed() const;
+
+	// Most messages applied in one tick, the rest wait for the next tick
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling, meta=(ClampMin=1))
+	int32 MaxMessagesPerTick = 10000;
+
+	virtual void BeginDestroy() override;
+
+protected:
+	bool Tick(float DeltaTime);
+
+	UPROPERTY()
+	TMap<int32, TObjectPtr<UBowlingScoreComponent>> Lanes;
+
+	// Last sequence number applied for each lane
+	TMap<int32, uint32> LaneSequences;
+
+	TSharedPtr<FBowlingIngestWorker> Worker;
+
+	FTSTicker::FDelegateHandle TickHandle;
+
+	int32 StreamPort = -1;
+	int32 DatagramPort = -1;
+
+	int64 NumApplied = 0;
+	int64 NumRejected = 0;
+};
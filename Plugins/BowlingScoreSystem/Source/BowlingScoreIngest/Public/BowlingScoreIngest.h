@@ -0,0 +1,16 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Modules/ModuleManager.h"
+
+BOWLINGSCOREINGEST_API DECLARE_LOG_CATEGORY_EXTERN(LogBowlingIngest, Log, All);
+
+class FBowlingScoreIngestModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
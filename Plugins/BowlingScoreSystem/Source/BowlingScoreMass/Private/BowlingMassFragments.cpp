@@ -0,0 +1,31 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingMassFragments.h"
+
+const FBowlingRuleSet& FBowlingRulesFragment::GetRuleSet() const
+{
+	switch (Variant)
+	{
+	case EBowlingVariant::NinePin: return FBowlingRuleSet::Get<FNinePinRules>();
+	case EBowlingVariant::FivePin: return FBowlingRuleSet::Get<FFivePinRules>();
+	case EBowlingVariant::Candlepin: return FBowlingRuleSet::Get<FCandlepinRules>();
+	default: return FBowlingRuleSet::Get<FTenPinRules>();
+	}
+}
+
+bool FBowlingRulesFragment::FindVariant(const FBowlingRuleSet& RuleSet, EBowlingVariant& OutVariant)
+{
+	FBowlingRulesFragment Rules;
+	for (auto Variant : {EBowlingVariant::TenPin, EBowlingVariant::NinePin, EBowlingVariant::FivePin,
+	                     EBowlingVariant::Candlepin})
+	{
+		// By name, a copy of the rules is still the same variant
+		Rules.Variant = Variant;
+		if (FCString::Strcmp(Rules.GetRuleSet().Name, RuleSet.Name) == 0)
+		{
+			OutVariant = Variant;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,226 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingMassProcessors.h"
+
+#include "MassExecutionContext.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+	using FBowlingFrames = TArray<FBowlingFrameScore, TInlineAllocator<FBowlingRulesFragment::MaxFrames>>;
+
+	// Lay a game's shots out as frames for the rule set's scorer
+	void GetFrames(const FBowlingRuleSet& RuleSet, const FBowlingShotsFragment& Shots, FBowlingFrames& OutFrames)
+	{
+		OutFrames.SetNum(RuleSet.NumFrames);
+		for (auto FrameIdx = 0; FrameIdx < RuleSet.NumFrames; FrameIdx++)
+		{
+			auto& FrameShots = OutFrames[FrameIdx].Shots;
+			FrameShots.SetNum(RuleSet.GetNumShots(FrameIdx));
+			for (auto ShotIdx = 0; ShotIdx < FrameShots.Num(); ShotIdx++)
+			{
+				FrameShots[ShotIdx] = Shots.GetShot(FrameIdx, ShotIdx);
+			}
+		}
+	}
+}
+
+UBowlingScoringProcessor::UBowlingScoringProcessor()
+{
+	// Run by UBowlingMassSubsystem
+	bAutoRegisterWithProcessingPhases = false;
+}
+
+void UBowlingScoringProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FBowlingShotsFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FBowlingCursorFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FBowlingPendingFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FBowlingTotalsFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FBowlingRulesFragment>();
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UBowlingScoringProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoringProcessor::Execute);
+
+	EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& ChunkContext)
+	{
+		const auto& RuleSet = ChunkContext.GetConstSharedFragment<FBowlingRulesFragment>().GetRuleSet();
+		const auto ShotsList = ChunkContext.GetMutableFragmentView<FBowlingShotsFragment>();
+		const auto Cursors = ChunkContext.GetMutableFragmentView<FBowlingCursorFragment>();
+		const auto PendingList = ChunkContext.GetMutableFragmentView<FBowlingPendingFragment>();
+		const auto TotalsList = ChunkContext.GetMutableFragmentView<FBowlingTotalsFragment>();
+
+		FBowlingFrames Frames;
+		for (auto EntityIdx = 0; EntityIdx < ChunkContext.GetNumEntities(); EntityIdx++)
+		{
+			// Most games are waiting on a bowler
+			auto& Pending = PendingList[EntityIdx];
+			if (not Pending.HasWork()) { continue; }
+
+			auto& Shots = ShotsList[EntityIdx];
+			auto& Cursor = Cursors[EntityIdx];
+			auto& Totals = TotalsList[EntityIdx];
+
+			// Starting over, or being handed a whole game, can change any frame
+			const auto AllFrames = (1 << RuleSet.NumFrames) - 1;
+			auto ChangedFrames = Pending.bRescore ? AllFrames : 0;
+			if (Pending.bReset)
+			{
+				Shots = {};
+				Cursor = {};
+				Totals.NumRejected = 0;
+				ChangedFrames = AllFrames;
+			}
+
+			GetFrames(RuleSet, Shots, Frames);
+
+			int32 FrameIdx = Cursor.FrameIdx;
+			int32 ShotIdx = Cursor.ShotIdx;
+			for (auto PendingIdx = 0; PendingIdx < Pending.NumShots; PendingIdx++)
+			{
+				// Also turns away shots after the game is over
+				const auto Pins = Pending.Shots[PendingIdx];
+				if (not RuleSet.IsValidShotScore(Frames, Pins, FrameIdx, ShotIdx))
+				{
+					Totals.NumRejected++;
+					continue;
+				}
+
+				Frames[FrameIdx].Shots[ShotIdx] = Pins;
+				Shots.SetShot(FrameIdx, ShotIdx, Pins);
+				ChangedFrames |= 1 << FrameIdx;
+				RuleSet.Advance(Frames, FrameIdx, ShotIdx);
+				Cursor.NumShotsRecorded++;
+			}
+			Cursor.FrameIdx = static_cast<int8>(FrameIdx);
+			Cursor.ShotIdx = static_cast<int8>(ShotIdx);
+
+			// Totals are redone for the whole game, since a shot can add bonus to the frames before it
+			auto Total = 0;
+			Totals.NumStrikes = 0;
+			Totals.NumSpares = 0;
+			for (auto Idx = 0; Idx < RuleSet.NumFrames; Idx++)
+			{
+				Total += RuleSet.GetFrameScore(Frames, Idx);
+				if (Totals.FrameTotals[Idx] != Total)
+				{
+					Totals.FrameTotals[Idx] = static_cast<uint16>(Total);
+					ChangedFrames |= 1 << Idx;
+				}
+
+				for (auto Shot = 0; Shot < Frames[Idx].Shots.Num(); Shot++)
+				{
+					if (RuleSet.IsStrike(Frames, Idx, Shot)) { Totals.NumStrikes++; }
+					else if (RuleSet.IsSpare(Frames, Idx, Shot)) { Totals.NumSpares++; }
+				}
+			}
+
+			const auto bGameOver = FrameIdx >= RuleSet.NumFrames;
+			Totals.MaxPossibleScore = static_cast<uint16>(
+				bGameOver ? Total : RuleSet.GetMaxPossibleScore(Frames, FrameIdx, ShotIdx));
+			Cursor.PinsStanding = static_cast<uint8>(bGameOver ? 0 : RuleSet.GetRack(Frames[FrameIdx], ShotIdx).Standing);
+
+			Totals.ChangedFrames = static_cast<uint16>(ChangedFrames);
+			Totals.Version++;
+			Pending = {};
+		}
+	});
+}
+
+UBowlingDisplayProcessor::UBowlingDisplayProcessor()
+{
+	bAutoRegisterWithProcessingPhases = false;
+}
+
+void UBowlingDisplayProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FBowlingCursorFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FBowlingTotalsFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FBowlingDisplayFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FBowlingRulesFragment>();
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UBowlingDisplayProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingDisplayProcessor::Execute);
+
+	EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& ChunkContext)
+	{
+		const auto NumFrames = ChunkContext.GetConstSharedFragment<FBowlingRulesFragment>().GetRuleSet().NumFrames;
+		const auto Cursors = ChunkContext.GetFragmentView<FBowlingCursorFragment>();
+		const auto TotalsList = ChunkContext.GetFragmentView<FBowlingTotalsFragment>();
+		const auto Displays = ChunkContext.GetMutableFragmentView<FBowlingDisplayFragment>();
+
+		for (auto EntityIdx = 0; EntityIdx < ChunkContext.GetNumEntities(); EntityIdx++)
+		{
+			const auto& Cursor = Cursors[EntityIdx];
+			const auto& Totals = TotalsList[EntityIdx];
+			auto& Display = Displays[EntityIdx];
+
+			Display.bGameOver = Cursor.FrameIdx >= NumFrames;
+			Display.CurrentFrame = static_cast<uint8>(Display.bGameOver ? 0 : Cursor.FrameIdx + 1);
+			Display.CurrentShot = static_cast<uint8>(Display.bGameOver ? 0 : Cursor.ShotIdx + 1);
+
+			// Only the frames of the update that hasn't been shown yet need redrawing
+			Display.ChangedFrames = Display.ShownVersion != Totals.Version ? Totals.ChangedFrames : 0;
+			Display.ShownVersion = Totals.Version;
+		}
+	});
+}
+
+UBowlingStatsProcessor::UBowlingStatsProcessor()
+{
+	bAutoRegisterWithProcessingPhases = false;
+}
+
+void UBowlingStatsProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FBowlingCursorFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FBowlingTotalsFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddConstSharedRequirement<FBowlingRulesFragment>();
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+void UBowlingStatsProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingStatsProcessor::Execute);
+
+	Stats = {};
+	EntityQuery.ParallelForEachEntityChunk(EntityManager, Context, [this](FMassExecutionContext& ChunkContext)
+	{
+		const auto NumFrames = ChunkContext.GetConstSharedFragment<FBowlingRulesFragment>().GetRuleSet().NumFrames;
+		const auto Cursors = ChunkContext.GetFragmentView<FBowlingCursorFragment>();
+		const auto TotalsList = ChunkContext.GetFragmentView<FBowlingTotalsFragment>();
+
+		FBowlingMassStats ChunkStats;
+		for (auto EntityIdx = 0; EntityIdx < ChunkContext.GetNumEntities(); EntityIdx++)
+		{
+			const auto& Cursor = Cursors[EntityIdx];
+			const auto& Totals = TotalsList[EntityIdx];
+
+			ChunkStats.NumGames++;
+			ChunkStats.NumShots += Cursor.NumShotsRecorded;
+			ChunkStats.NumStrikes += Totals.NumStrikes;
+			ChunkStats.NumSpares += Totals.NumSpares;
+			ChunkStats.TotalScore += Totals.GetScore();
+			if (Cursor.FrameIdx >= NumFrames)
+			{
+				ChunkStats.NumGamesOver++;
+				ChunkStats.HighScore = FMath::Max(ChunkStats.HighScore, Totals.GetScore());
+			}
+		}
+
+		FScopeLock Lock(&StatsLock);
+		Stats.NumGames += ChunkStats.NumGames;
+		Stats.NumGamesOver += ChunkStats.NumGamesOver;
+		Stats.NumShots += ChunkStats.NumShots;
+		Stats.NumStrikes += ChunkStats.NumStrikes;
+		Stats.NumSpares += ChunkStats.NumSpares;
+		Stats.TotalScore += ChunkStats.TotalScore;
+		Stats.HighScore = FMath::Max(Stats.HighScore, ChunkStats.HighScore);
+	});
+}
@@ -0,0 +1,228 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingMassSubsystem.h"
+
+#include "BowlingMassProcessors.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutor.h"
+#include "MassProcessingTypes.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+void UBowlingMassSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EntitySubsystem = Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	Archetype = GetEntityManager().CreateArchetype({
+		FBowlingShotsFragment::StaticStruct(),
+		FBowlingCursorFragment::StaticStruct(),
+		FBowlingPendingFragment::StaticStruct(),
+		FBowlingTotalsFragment::StaticStruct(),
+		FBowlingDisplayFragment::StaticStruct(),
+	});
+
+	ScoringProcessor = NewObject<UBowlingScoringProcessor>(this);
+	DisplayProcessor = NewObject<UBowlingDisplayProcessor>(this);
+	StatsProcessor = NewObject<UBowlingStatsProcessor>(this);
+	ScoringProcessor->CallInitialize(this);
+	DisplayProcessor->CallInitialize(this);
+	StatsProcessor->CallInitialize(this);
+}
+
+void UBowlingMassSubsystem::Deinitialize()
+{
+	for (auto&& [BowlingScoreComponent, Bound] : BoundComponents)
+	{
+		if (auto* Component = BowlingScoreComponent.Get())
+		{
+			Component->OnShotRecorded.Remove(Bound.ShotRecordedHandle);
+			Component->OnGameStateChanged.Remove(Bound.GameStateChangedHandle);
+			Component->OnReset.RemoveDynamic(this, &UBowlingMassSubsystem::ComponentReset);
+		}
+	}
+	BoundComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+void UBowlingMassSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	Process(DeltaTime);
+}
+
+TStatId UBowlingMassSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBowlingMassSubsystem, STATGROUP_Tickables);
+}
+
+FMassEntityHandle UBowlingMassSubsystem::CreateGame(EBowlingVariant Variant)
+{
+	LLM_SCOPE_BYTAG(Bowling_Games);
+
+	auto& EntityManager = GetEntityManager();
+
+	// Games are grouped into chunks by their rules
+	FBowlingRulesFragment Rules;
+	Rules.Variant = Variant;
+	FMassArchetypeSharedFragmentValues SharedValues;
+	SharedValues.AddConstSharedFragment(EntityManager.GetOrCreateConstSharedFragment(Rules));
+	SharedValues.Sort();
+
+	const auto Game = EntityManager.CreateEntity(Archetype, SharedValues);
+	EntityManager.GetFragmentDataChecked<FBowlingPendingFragment>(Game).bReset = true;
+	return Game;
+}
+
+void UBowlingMassSubsystem::DestroyGame(FMassEntityHandle Game)
+{
+	auto& EntityManager = GetEntityManager();
+	if (EntityManager.IsEntityValid(Game))
+	{
+		EntityManager.DestroyEntity(Game);
+	}
+}
+
+bool UBowlingMassSubsystem::SubmitShot(FMassEntityHandle Game, int32 Pins)
+{
+	auto& EntityManager = GetEntityManager();
+	if (not EntityManager.IsEntityValid(Game)) { return false; }
+
+	auto& Pending = EntityManager.GetFragmentDataChecked<FBowlingPendingFragment>(Game);
+	if (Pending.NumShots >= FBowlingPendingFragment::MaxShots) { return false; }
+
+	// Anything past a byte is as invalid as any other score the game won't take
+	Pending.Shots[Pending.NumShots++] = static_cast<uint8>(FMath::Clamp(Pins, 0, MAX_uint8));
+	return true;
+}
+
+bool UBowlingMassSubsystem::ResetGame(FMassEntityHandle Game)
+{
+	auto& EntityManager = GetEntityManager();
+	if (not EntityManager.IsEntityValid(Game)) { return false; }
+
+	auto& Pending = EntityManager.GetFragmentDataChecked<FBowlingPendingFragment>(Game);
+	Pending = {};
+	Pending.bReset = true;
+	return true;
+}
+
+void UBowlingMassSubsystem::Process(float DeltaTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingMassSubsystem::Process);
+
+	// Display and stats only read what scoring writes, so scoring goes first
+	FMassProcessingContext ProcessingContext(GetEntityManager(), DeltaTime);
+	UE::Mass::Executor::Run(*ScoringProcessor, ProcessingContext);
+	UE::Mass::Executor::Run(*DisplayProcessor, ProcessingContext);
+	UE::Mass::Executor::Run(*StatsProcessor, ProcessingContext);
+}
+
+FBowlingMassStats UBowlingMassSubsystem::GetStats() const
+{
+	return StatsProcessor ? StatsProcessor->GetStats() : FBowlingMassStats();
+}
+
+void UBowlingMassSubsystem::BindComponent(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+	if (BoundComponents.Contains(BowlingScoreComponent)) { return; }
+
+	EBowlingVariant Variant;
+	if (not ensureMsgf(FBowlingRulesFragment::FindVariant(BowlingScoreComponent->GetRuleSet(), Variant),
+	                   TEXT("%s isn't playing any variant Mass knows"), *BowlingScoreComponent->GetReadableName()))
+	{
+		return;
+	}
+
+	auto& Bound = BoundComponents.Add(BowlingScoreComponent);
+	Bound.Game = CreateGame(Variant);
+	Bound.ShotRecordedHandle = BowlingScoreComponent->OnShotRecorded.AddUObject(
+		this, &UBowlingMassSubsystem::ComponentShotRecorded);
+	Bound.GameStateChangedHandle = BowlingScoreComponent->OnGameStateChanged.AddUObject(
+		this, &UBowlingMassSubsystem::ComponentStateChanged);
+	BowlingScoreComponent->OnReset.AddUniqueDynamic(this, &UBowlingMassSubsystem::ComponentReset);
+
+	// Catch up on anything bowled before binding
+	SyncComponent(BowlingScoreComponent);
+}
+
+void UBowlingMassSubsystem::UnbindComponent(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	FBoundComponent Bound;
+	if (not BoundComponents.RemoveAndCopyValue(BowlingScoreComponent, Bound)) { return; }
+
+	DestroyGame(Bound.Game);
+
+	if (IsValid(BowlingScoreComponent))
+	{
+		BowlingScoreComponent->OnShotRecorded.Remove(Bound.ShotRecordedHandle);
+		BowlingScoreComponent->OnGameStateChanged.Remove(Bound.GameStateChangedHandle);
+		BowlingScoreComponent->OnReset.RemoveDynamic(this, &UBowlingMassSubsystem::ComponentReset);
+	}
+}
+
+FMassEntityHandle UBowlingMassSubsystem::FindGame(const UBowlingScoreComponent* BowlingScoreComponent) const
+{
+	const auto* Bound = BoundComponents.Find(BowlingScoreComponent);
+	return Bound ? Bound->Game : FMassEntityHandle();
+}
+
+FMassEntityManager& UBowlingMassSubsystem::GetEntityManager() const
+{
+	return EntitySubsystem->GetMutableEntityManager();
+}
+
+void UBowlingMassSubsystem::SyncComponent(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	const auto Game = FindGame(BowlingScoreComponent);
+	auto& EntityManager = GetEntityManager();
+	if (not EntityManager.IsEntityValid(Game)) { return; }
+
+	auto& Shots = EntityManager.GetFragmentDataChecked<FBowlingShotsFragment>(Game);
+	Shots = {};
+	const auto& Frames = BowlingScoreComponent->GetFrameScores();
+	for (auto FrameIdx = 0; FrameIdx < FMath::Min(Frames.Num(), FBowlingRulesFragment::MaxFrames); FrameIdx++)
+	{
+		const auto& FrameShots = Frames[FrameIdx].Shots;
+		for (auto ShotIdx = 0; ShotIdx < FMath::Min(FrameShots.Num(), FBowlingRulesFragment::MaxShots); ShotIdx++)
+		{
+			Shots.SetShot(FrameIdx, ShotIdx, FrameShots[ShotIdx]);
+		}
+	}
+
+	auto& Cursor = EntityManager.GetFragmentDataChecked<FBowlingCursorFragment>(Game);
+	const auto bGameOver = BowlingScoreComponent->IsGameOver();
+	Cursor.FrameIdx = static_cast<int8>(bGameOver ? BowlingScoreComponent->GetNumFrames() : BowlingScoreComponent->GetCurrentFrameNum() - 1);
+	Cursor.ShotIdx = static_cast<int8>(bGameOver ? 0 : BowlingScoreComponent->GetCurrentShotNum() - 1);
+	Cursor.NumShotsRecorded = static_cast<uint8>(BowlingScoreComponent->GetNumShotsRecorded());
+
+	// The component already decided which shots count, the update only has to score them
+	auto& Pending = EntityManager.GetFragmentDataChecked<FBowlingPendingFragment>(Game);
+	Pending = {};
+	Pending.bRescore = true;
+}
+
+void UBowlingMassSubsystem::ComponentShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame,
+                                                  int32 Shot, int32 Score)
+{
+	SyncComponent(BowlingScoreComponent);
+}
+
+void UBowlingMassSubsystem::ComponentReset(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	SyncComponent(BowlingScoreComponent);
+}
+
+void UBowlingMassSubsystem::ComponentStateChanged(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	// Its entity and binding go with it, rather than waiting on a weak key that will never be looked up again
+	if (BowlingScoreComponent->IsDestroyed())
+	{
+		UnbindComponent(BowlingScoreComponent);
+	}
+}
@@ -0,0 +1,17 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BowlingScoreMass.h"
+
+#define LOCTEXT_NAMESPACE "FBowlingScoreMassModule"
+
+void FBowlingScoreMassModule::StartupModule()
+{
+}
+
+void FBowlingScoreMassModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FBowlingScoreMassModule, BowlingScoreMass)
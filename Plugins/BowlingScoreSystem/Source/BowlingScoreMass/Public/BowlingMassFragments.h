@@ -0,0 +1,195 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingRuleSets.h"
+#include "MassEntityTypes.h"
+#include "BowlingMassFragments.generated.h"
+
+/*
+ * Fragments for games run as Mass entities, for when there are too many games for a UBowlingScoreComponent each.
+ * Every fragment is plain data sized for the longest game of any variant, so games pack tightly into chunks.
+ *
+ * Shots are submitted to FBowlingPendingFragment, then each update UBowlingScoringProcessor applies them and keeps
+ * the totals, UBowlingDisplayProcessor derives what a scoreboard shows and UBowlingStatsProcessor adds up every game.
+ */
+
+UENUM(BlueprintType)
+enum class EBowlingVariant : uint8
+{
+	TenPin,
+	NinePin,
+	FivePin,
+	Candlepin,
+};
+
+// Rules every game in a chunk is played by
+USTRUCT()
+struct BOWLINGSCOREMASS_API FBowlingRulesFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	// Every variant is ten frames of at most three shots
+	static constexpr int32 MaxFrames = FTenPinRules::NumFrames;
+	static constexpr int32 MaxShots = 3;
+
+	UPROPERTY()
+	EBowlingVariant Variant = EBowlingVariant::TenPin;
+
+	const FBowlingRuleSet& GetRuleSet() const;
+
+	// Find which variant a rule set is. Returns false if it isn't one of them.
+	static bool FindVariant(const FBowlingRuleSet& RuleSet, EBowlingVariant& OutVariant);
+};
+
+// Every shot of the game, later shots are zero
+USTRUCT()
+struct BOWLINGSCOREMASS_API FBowlingShotsFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	int32 GetShot(int32 FrameIdx, int32 ShotIdx) const { return Shots[FrameIdx * FBowlingRulesFragment::MaxShots + ShotIdx]; }
+	void SetShot(int32 FrameIdx, int32 ShotIdx, int32 Pins)
+	{
+		Shots[FrameIdx * FBowlingRulesFragment::MaxShots + ShotIdx] = static_cast<uint8>(Pins);
+	}
+
+	UPROPERTY()
+	uint8 Shots[FBowlingRulesFragment::MaxFrames * FBowlingRulesFragment::MaxShots] = {};
+};
+
+// Frame and shot indices up next, FrameIdx is the number of frames once the game is over
+USTRUCT()
+struct BOWLINGSCOREMASS_API FBowlingCursorFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int8 FrameIdx = 0;
+
+	UPROPERTY()
+	int8 ShotIdx = 0;
+
+	// Pins set up for the shot up next, 0 once the game is over
+	UPROPERTY()
+	uint8 PinsStanding = 0;
+
+	UPROPERTY()
+	uint8 NumShotsRecorded = 0;
+};
+
+// Changes waiting for the next update
+USTRUCT()
+struct BOWLINGSCOREMASS_API FBowlingPendingFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	static constexpr int32 MaxShots = 4;
+
+	bool HasWork() const { return bReset or bRescore or NumShots > 0; }
+
+	// Shots to record, in order
+	UPROPERTY()
+	uint8 Shots[MaxShots] = {};
+
+	UPROPERTY()
+	uint8 NumShots = 0;
+
+	// Start the game over before recording Shots
+	UPROPERTY()
+	bool bReset = false;
+
+	// Shots and cursor were written directly (see UBowlingMassSubsystem::BindComponent), only the totals need updating
+	UPROPERTY()
+	bool bRescore = false;
+};
+
+// Cumulative score of every frame and what's left to play for, kept by UBowlingScoringProcessor
+USTRUCT()
+struct BOWLINGSCOREMASS_API FBowlingTotalsFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	int32 GetScore() const { return FrameTotals[FBowlingRulesFragment::MaxFrames - 1]; }
+
+	UPROPERTY()
+	uint16 FrameTotals[FBowlingRulesFragment::MaxFrames] = {};
+
+	// Best final score the game can still reach
+	UPROPERTY()
+	uint16 MaxPossibleScore = 0;
+
+	UPROPERTY()
+	uint8 NumStrikes = 0;
+
+	UPROPERTY()
+	uint8 NumSpares = 0;
+
+	// Shots the game wouldn't take
+	UPROPERTY()
+	uint16 NumRejected = 0;
+
+	// Bit per frame (bit 0 for frame 1) whose shots or total changed in the latest update of the game
+	UPROPERTY()
+	uint16 ChangedFrames = 0;
+
+	// Bumped by every update of the game, which only happens when it had changes waiting
+	UPROPERTY()
+	uint32 Version = 0;
+};
+
+// What a scoreboard shows, derived by UBowlingDisplayProcessor
+USTRUCT()
+struct BOWLINGSCOREMASS_API FBowlingDisplayFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// Frame and shot up next starting from 1, 0 once the game is over
+	UPROPERTY()
+	uint8 CurrentFrame = 0;
+
+	UPROPERTY()
+	uint8 CurrentShot = 0;
+
+	UPROPERTY()
+	bool bGameOver = false;
+
+	// Frames to redraw, as FBowlingTotalsFragment::ChangedFrames if the last update changed the game and 0 if not
+	UPROPERTY()
+	uint16 ChangedFrames = 0;
+
+	// Totals version already shown
+	UPROPERTY()
+	uint32 ShownVersion = 0;
+};
+
+// Totals across every game
+USTRUCT(BlueprintType)
+struct BOWLINGSCOREMASS_API FBowlingMassStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 NumGames = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 NumGamesOver = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int64 NumShots = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int64 NumStrikes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int64 NumSpares = 0;
+
+	// Pinfall of every game, finished or not
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int64 TotalScore = 0;
+
+	// Best score of a finished game
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 HighScore = 0;
+};
@@ -0,0 +1,69 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingMassFragments.h"
+#include "MassEntityQuery.h"
+#include "MassProcessor.h"
+#include "BowlingMassProcessors.generated.h"
+
+/*
+ * Processors for games run as Mass entities. They're run in order by UBowlingMassSubsystem rather than registered
+ * with the processing phases, so games update with or without the Mass simulation running. Each one works through
+ * the chunks in parallel.
+ */
+
+// Record pending shots and resets, then bring each changed game's totals up to date
+UCLASS()
+class BOWLINGSCOREMASS_API UBowlingScoringProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingScoringProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
+
+// Derive what a scoreboard shows from each game's cursor and totals
+UCLASS()
+class BOWLINGSCOREMASS_API UBowlingDisplayProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingDisplayProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
+
+// Add up every game, each chunk is counted on its own and then combined
+UCLASS()
+class BOWLINGSCOREMASS_API UBowlingStatsProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingStatsProcessor();
+
+	// Totals as of the last run
+	const FBowlingMassStats& GetStats() const { return Stats; }
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+
+	FBowlingMassStats Stats;
+	FCriticalSection StatsLock;
+};
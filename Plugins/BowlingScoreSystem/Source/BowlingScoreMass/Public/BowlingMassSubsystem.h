@@ -0,0 +1,112 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingMassFragments.h"
+#include "MassArchetypeTypes.h"
+#include "MassEntityManager.h"
+#include "MassEntityTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BowlingMassSubsystem.generated.h"
+
+class UBowlingDisplayProcessor;
+class UBowlingScoreComponent;
+class UBowlingScoringProcessor;
+class UBowlingStatsProcessor;
+class UMassEntitySubsystem;
+
+/*
+ * Runs bowling games as Mass entities, for simulated tournaments and center visualizations with thousands of games.
+ *
+ * Games are created and fed shots here, then every tick the bowling processors update them all at once (see
+ * BowlingMassFragments.h). Everything is game thread only, outside of the update.
+ *
+ * Existing UBowlingScoreComponent games can be bound to an entity, so Blueprints, widgets and anything else using the
+ * component keep working while the game also counts towards everything run through Mass.
+ */
+UCLASS()
+class BOWLINGSCOREMASS_API UBowlingMassSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Start a game, which is set up by the next update
+	FMassEntityHandle CreateGame(EBowlingVariant Variant = EBowlingVariant::TenPin);
+
+	void DestroyGame(FMassEntityHandle Game);
+
+	// Queue a shot for the next update. Returns false if the game is gone or already has as many shots waiting as it
+	// can hold. Shots the game won't take are counted in FBowlingTotalsFragment::NumRejected by the update.
+	bool SubmitShot(FMassEntityHandle Game, int32 Pins);
+
+	// Start the game over with the next update, dropping any shots still waiting. Returns false if the game is gone.
+	bool ResetGame(FMassEntityHandle Game);
+
+	// Update every game now rather than waiting for the next tick
+	void Process(float DeltaTime = 0.f);
+
+	// Get a game's fragment as of the last update, null if the game is gone
+	template <typename TFragment>
+	const TFragment* GetFragment(FMassEntityHandle Game) const
+	{
+		const auto& EntityManager = GetEntityManager();
+		return EntityManager.IsEntityValid(Game) ? EntityManager.GetFragmentDataPtr<TFragment>(Game) : nullptr;
+	}
+
+	// Totals across every game as of the last update
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	FBowlingMassStats GetStats() const;
+
+	// Mirror a component's game into an entity from now on, until it's unbound or destroyed
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void BindComponent(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void UnbindComponent(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Get the entity a component is bound to, invalid if it isn't
+	FMassEntityHandle FindGame(const UBowlingScoreComponent* BowlingScoreComponent) const;
+
+protected:
+	FMassEntityManager& GetEntityManager() const;
+
+	// Copy a bound component's whole game into its entity, for the next update to score
+	void SyncComponent(UBowlingScoreComponent* BowlingScoreComponent);
+
+	void ComponentShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score);
+
+	UFUNCTION()
+	void ComponentReset(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Unbinds a component once it's destroyed
+	void ComponentStateChanged(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UPROPERTY()
+	TObjectPtr<UMassEntitySubsystem> EntitySubsystem;
+
+	UPROPERTY()
+	TObjectPtr<UBowlingScoringProcessor> ScoringProcessor;
+
+	UPROPERTY()
+	TObjectPtr<UBowlingDisplayProcessor> DisplayProcessor;
+
+	UPROPERTY()
+	TObjectPtr<UBowlingStatsProcessor> StatsProcessor;
+
+	FMassArchetypeHandle Archetype;
+
+	struct FBoundComponent
+	{
+		FMassEntityHandle Game;
+		FDelegateHandle ShotRecordedHandle;
+		FDelegateHandle GameStateChangedHandle;
+	};
+
+	TMap<TWeakObjectPtr<UBowlingScoreComponent>, FBoundComponent> BoundComponents;
+};
@@ -28,8 +28,10 @@ public class BowlingScoreSystem : ModuleRules
 			new string[]
 			{
 				"Core",
-				"UMG"
+				"CoreUObject",
+				"Engine",
 				// ... add other public dependencies that you statically link with here ...
+				// No UMG or Slate, the headless lane server runs from this module. Widgets are in BowlingScoreUI.
 			}
 		);
 
@@ -37,10 +39,6 @@ public class BowlingScoreSystem : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"CoreUObject",
-				"Engine",
-				"Slate",
-				"SlateCore",
 				// ... add private dependencies that you statically link with here ...	
 			}
 		);
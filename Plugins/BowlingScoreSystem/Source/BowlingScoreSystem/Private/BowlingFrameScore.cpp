@@ -0,0 +1,17 @@
+﻿// Partly Atomic LLC 2025
+#include "BowlingFrameScore.h"
+
+FBowlingFrameScore::FBowlingFrameScore()
+{
+	Shots.SetNum(3);
+}
+
+FBowlingFrameScore::FBowlingFrameScore(int32 Shot1, int32 Shot2) : FBowlingFrameScore()
+{
+	Shots = {Shot1, Shot2};
+}
+
+FBowlingFrameScore::FBowlingFrameScore(int32 Shot1, int32 Shot2, int32 Shot3) : FBowlingFrameScore()
+{
+	Shots = {Shot1, Shot2, Shot3};
+}
@@ -0,0 +1,38 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingGameCodec.h"
+
+#include "Algo/IsSorted.h"
+
+void FBowlingGameArchive::Empty()
+{
+	Data.Reset();
+	BlockOffsets.Reset();
+	NumGames = 0;
+}
+
+FArchive& operator<<(FArchive& Ar, FBowlingGameArchive& Archive)
+{
+	Ar << Archive.NumGames;
+	Ar << Archive.GamesPerBlock;
+	Ar << Archive.BlockOffsets;
+	Ar << Archive.Data;
+
+	// Don't trust a damaged archive to index into its data
+	if (Ar.IsLoading())
+	{
+		const auto ExpectedBlocks = Archive.GamesPerBlock > 0
+			? (Archive.NumGames + Archive.GamesPerBlock - 1) / Archive.GamesPerBlock
+			: -1;
+		const auto bValid = ExpectedBlocks == Archive.BlockOffsets.Num()
+			and Algo::IsSorted(Archive.BlockOffsets)
+			and (Archive.BlockOffsets.IsEmpty() or Archive.BlockOffsets.Last() <= static_cast<uint32>(Archive.Data.Num()));
+		if (not bValid)
+		{
+			Ar.SetError();
+			Archive.Empty();
+		}
+	}
+
+	return Ar;
+}
@@ -0,0 +1,77 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingGameFlow.h"
+
+#include "Async/Async.h"
+#include "BowlingScoreComponent.h"
+
+FBowlingGameAwaiter::FBowlingGameAwaiter(UBowlingScoreComponent& InBowlingScoreComponent, EWaitFor InWaitFor)
+	: BowlingScoreComponent(&InBowlingScoreComponent), WaitFor(InWaitFor)
+{
+}
+
+FBowlingGameAwaiter::~FBowlingGameAwaiter()
+{
+	if (auto* Component = BowlingScoreComponent.Get(); Component and GameStateChangedHandle.IsValid())
+	{
+		Component->OnGameStateChanged.Remove(GameStateChangedHandle);
+	}
+}
+
+void FBowlingGameAwaiter::await_suspend(std::coroutine_handle<> InHandle)
+{
+	check(IsInGameThread());
+	Handle = InHandle;
+
+	if (IsReady())
+	{
+		Resume();
+		return;
+	}
+
+	GameStateChangedHandle = BowlingScoreComponent->OnGameStateChanged.AddRaw(this, &FBowlingGameAwaiter::GameStateChanged);
+}
+
+bool FBowlingGameAwaiter::IsReady() const
+{
+	const auto* Component = BowlingScoreComponent.Get();
+	if (not IsValid(Component) or Component->IsDestroyed()) { return true; }
+
+	return WaitFor == EWaitFor::GameOver ? Component->IsGameOver() : not Component->IsGameOver();
+}
+
+void FBowlingGameAwaiter::GameStateChanged(UBowlingScoreComponent* InBowlingScoreComponent)
+{
+	if (not IsReady()) { return; }
+
+	InBowlingScoreComponent->OnGameStateChanged.Remove(GameStateChangedHandle);
+	GameStateChangedHandle.Reset();
+	Resume();
+}
+
+void FBowlingGameAwaiter::Resume()
+{
+	AsyncTask(ENamedThreads::GameThread, [Handle = Handle]
+	{
+		Handle.resume();
+	});
+}
+
+FBowlingShotRequest FBowlingShotRequestAwaiter::await_resume() const
+{
+	FBowlingShotRequest Request;
+	const auto* Component = BowlingScoreComponent.Get();
+	if (IsValid(Component) and not Component->IsDestroyed())
+	{
+		Request.Frame = Component->GetCurrentFrameNum();
+		Request.Shot = Component->GetCurrentShotNum();
+		Request.PinsStanding = Component->GetPinsStanding();
+	}
+	return Request;
+}
+
+int32 FBowlingGameOverAwaiter::await_resume() const
+{
+	const auto* Component = BowlingScoreComponent.Get();
+	return IsValid(Component) and Component->IsGameOver() ? Component->GetScore(Component->GetNumFrames()) : 0;
+}
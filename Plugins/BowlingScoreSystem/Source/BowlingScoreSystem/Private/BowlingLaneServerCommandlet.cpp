@@ -0,0 +1,249 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingLaneServerCommandlet.h"
+
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreSystem.h"
+#include "BowlingShotLog.h"
+#include "BowlingVariantScoreComponents.h"
+#include "CoreGlobals.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+	// Checked by hand since FString::IsNumeric would also accept "1.5", "+3" and "-0". No rack has more than 99 pins.
+	bool IsPinCount(const FString& Command)
+	{
+		if (Command.IsEmpty() or Command.Len() > 2) { return false; }
+		for (const auto Character : Command)
+		{
+			if (not FChar::IsDigit(Character)) { return false; }
+		}
+		return true;
+	}
+}
+
+UBowlingLaneServerCommandlet::UBowlingLaneServerCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = false;
+}
+
+int32 UBowlingLaneServerCommandlet::Main(const FString& Params)
+{
+	const auto StartTime = FPlatformTime::Seconds();
+
+	auto NumLanes = 1;
+	FParse::Value(*Params, TEXT("Lanes="), NumLanes);
+	auto PollInterval = 0.05f;
+	FParse::Value(*Params, TEXT("PollInterval="), PollInterval);
+	const auto bFollow = FParse::Param(*Params, TEXT("Follow"));
+
+	FString InputPath;
+	if (not FParse::Value(*Params, TEXT("Input="), InputPath))
+	{
+		UE_LOG(LogBowling, Error, TEXT("Missing -Input=<Path> for shots to score"));
+		return 1;
+	}
+
+	auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// Allow writes so a lane controller can keep appending to the file while it's being followed
+	TUniquePtr<IFileHandle> InputHandle(PlatformFile.OpenRead(*InputPath, true));
+	if (not InputHandle)
+	{
+		UE_LOG(LogBowling, Error, TEXT("Could not open input %s"), *InputPath);
+		return 1;
+	}
+
+	FString OutputPath;
+	if (FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputHandle.Reset(PlatformFile.OpenWrite(*OutputPath, true, true));
+		if (not OutputHandle)
+		{
+			UE_LOG(LogBowling, Error, TEXT("Could not open output %s"), *OutputPath);
+			return 1;
+		}
+	}
+
+	// Every lane plays the same variant
+	FString RuleSetName = TEXT("TenPin");
+	FParse::Value(*Params, TEXT("RuleSet="), RuleSetName);
+	const TMap<FString, UClass*> LaneClasses = {
+		{TEXT("TenPin"), UBowlingScoreComponent::StaticClass()},
+		{TEXT("NinePin"), UNinePinScoreComponent::StaticClass()},
+		{TEXT("FivePin"), UFivePinScoreComponent::StaticClass()},
+		{TEXT("Candlepin"), UCandlepinScoreComponent::StaticClass()},
+
+		// Scored by the same rules as candlepin
+		{TEXT("Duckpin"), UCandlepinScoreComponent::StaticClass()},
+	};
+	auto* LaneClass = LaneClasses.FindRef(RuleSetName);
+	if (not LaneClass)
+	{
+		UE_LOG(LogBowling, Error, TEXT("Unknown -RuleSet=%s, expected TenPin, NinePin, FivePin, Candlepin or Duckpin"),
+		       *RuleSetName);
+		return 1;
+	}
+
+	// Components don't need an owning actor or world to score a game
+	Lanes.Reserve(NumLanes);
+	for (auto LaneIdx = 0; LaneIdx < NumLanes; LaneIdx++)
+	{
+		Lanes.Add(NewObject<UBowlingScoreComponent>(this, LaneClass));
+	}
+
+	// Pick up any games that were in progress when the server last stopped
+	FString ShotLogPath;
+	if (FParse::Value(*Params, TEXT("ShotLog="), ShotLogPath))
+	{
+		ShotLog = NewObject<UBowlingShotLog>(this);
+		if (not ShotLog->Open(ShotLogPath)) { return 1; }
+
+		for (auto LaneIdx = 0; LaneIdx < NumLanes; LaneIdx++)
+		{
+			ShotLog->AddLane(LaneIdx + 1, Lanes[LaneIdx]);
+		}
+
+		const auto Recovered = ShotLog->Recover();
+		UE_LOG(LogBowling, Display, TEXT("Recovered %d events from %s"), Recovered, *ShotLogPath);
+
+		// Input that was already applied is in the recovered games, only what came after it is still to do
+		const auto InputOffset = static_cast<int64>(ShotLog->GetRecoveredInputOffset());
+		if (InputOffset > InputHandle->Size())
+		{
+			UE_LOG(LogBowling, Error, TEXT("Input %s is shorter than the %lld bytes %s already applied"), *InputPath,
+			       InputOffset, *ShotLogPath);
+			return 1;
+		}
+		InputHandle->Seek(InputOffset);
+	}
+
+	const auto Now = FPlatformTime::Seconds();
+	UE_LOG(LogBowling, Display, TEXT("Bowling lane server hosting %d lanes, ready in %.3fs (%.3fs since process start)"),
+	       NumLanes, Now - StartTime, Now - GStartTime);
+
+	auto bRunning = ReadInput(*InputHandle);
+	while (bRunning and bFollow and not IsEngineExitRequested())
+	{
+		// Nothing happens between shots, so sleep rather than spin to keep an idle center at near-zero CPU
+		FPlatformProcess::Sleep(PollInterval);
+		bRunning = ReadInput(*InputHandle);
+	}
+
+	if (ShotLog) { ShotLog->Close(); }
+	OutputHandle.Reset();
+	return 0;
+}
+
+bool UBowlingLaneServerCommandlet::ReadInput(IFileHandle& InputHandle)
+{
+	const auto Position = InputHandle.Tell();
+	const auto Size = InputHandle.Size();
+	if (Size <= Position) { return true; }
+
+	// Where in the input the partial line left over from the last read starts
+	const auto ReadStart = PendingInput.Num();
+	const auto PendingOffset = Position - ReadStart;
+	const auto ReadSize = static_cast<int32>(Size - Position);
+	PendingInput.AddUninitialized(ReadSize);
+	if (not InputHandle.Read(reinterpret_cast<uint8*>(PendingInput.GetData() + ReadStart), ReadSize))
+	{
+		UE_LOG(LogBowling, Error, TEXT("Failed reading input"));
+		return false;
+	}
+
+	// Only apply complete lines, anything after the last newline waits for the next read
+	auto LineStart = 0;
+	for (auto CharIdx = ReadStart; CharIdx < PendingInput.Num(); CharIdx++)
+	{
+		if (PendingInput[CharIdx] != '\n') { continue; }
+
+		auto Line = FString(CharIdx - LineStart, PendingInput.GetData() + LineStart);
+		LineStart = CharIdx + 1;
+
+		// Logged with the line's shot, so a restart picks up after it
+		if (ShotLog) { ShotLog->SetInputOffset(PendingOffset + LineStart); }
+
+		if (not ApplyCommand(Line.TrimStartAndEnd())) { return false; }
+	}
+	PendingInput.RemoveAt(0, LineStart, EAllowShrinking::No);
+
+	return true;
+}
+
+bool UBowlingLaneServerCommandlet::ApplyCommand(const FString& Line)
+{
+	if (Line.IsEmpty() or Line.StartsWith(TEXT("#"))) { return true; }
+	if (Line == TEXT("quit")) { return false; }
+
+	FString LaneText;
+	FString Command;
+	if (not Line.Split(TEXT(" "), &LaneText, &Command))
+	{
+		UE_LOG(LogBowling, Warning, TEXT("Ignoring malformed command \"%s\""), *Line);
+		return true;
+	}
+	Command.TrimStartInline();
+
+	const auto LaneIdx = FCString::Atoi(*LaneText) - 1;
+	if (not Lanes.IsValidIndex(LaneIdx))
+	{
+		UE_LOG(LogBowling, Warning, TEXT("Ignoring command for unknown lane \"%s\""), *Line);
+		return true;
+	}
+	auto* Lane = Lanes[LaneIdx].Get();
+
+	if (Command == TEXT("reset"))
+	{
+		Lane->Reset();
+	}
+	else if (IsPinCount(Command))
+	{
+		if (not Lane->SetScore(FCString::Atoi(*Command)))
+		{
+			UE_LOG(LogBowling, Warning, TEXT("Lane %d rejected shot \"%s\""), LaneIdx + 1, *Command);
+			return true;
+		}
+	}
+	else
+	{
+		UE_LOG(LogBowling, Warning, TEXT("Ignoring unknown command \"%s\""), *Line);
+		return true;
+	}
+
+	PublishLane(LaneIdx);
+	return true;
+}
+
+void UBowlingLaneServerCommandlet::PublishLane(int32 LaneIdx)
+{
+	auto* Lane = Lanes[LaneIdx].Get();
+
+	PublishBuffer.Reset();
+	PublishBuffer.Appendf(TEXT("{\"lane\":%d,\"frame\":%d,\"shot\":%d,\"over\":%s,\"scores\":["),
+	                      LaneIdx + 1, Lane->GetCurrentFrameNum(), Lane->GetCurrentShotNum(),
+	                      Lane->IsGameOver() ? TEXT("true") : TEXT("false"));
+	for (auto Frame = 1; Frame <= Lane->GetNumFrames(); Frame++)
+	{
+		PublishBuffer.Appendf(TEXT("%s%d"), Frame > 1 ? TEXT(",") : TEXT(""), Lane->GetScore(Frame));
+	}
+	PublishBuffer += TEXT("]}");
+
+	if (OutputHandle)
+	{
+		PublishBuffer += TEXT("\n");
+		const FTCHARToUTF8 Utf8(*PublishBuffer);
+		OutputHandle->Write(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		OutputHandle->Flush();
+	}
+	else
+	{
+		UE_LOG(LogBowling, Display, TEXT("%s"), *PublishBuffer);
+	}
+}
@@ -0,0 +1,290 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingLatencyTracker.h"
+
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarLatencyEnabled(
+		TEXT("Bowling.Latency.Enabled"),
+		false,
+		TEXT("Time every shot from SetScore to the first frame drawn after it"));
+
+	FAutoConsoleCommandWithOutputDevice LatencyCommand(
+		TEXT("Bowling.Latency"),
+		TEXT("Print p50/p99/p999 shot-to-pixel latency of every lane"),
+		FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			FBowlingLatencyTracker::Get().Report(Ar);
+		}));
+
+	FAutoConsoleCommandWithArgsAndOutputDevice LatencyDumpCommand(
+		TEXT("Bowling.Latency.Dump"),
+		TEXT("Write shot-to-pixel latency of every lane as CSV, to the path given or Saved/Profiling/BowlingLatency.csv"),
+		FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, FOutputDevice& Ar)
+		{
+			const auto Path = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("BowlingLatency.csv");
+			if (FBowlingLatencyTracker::Get().DumpCsv(Path))
+			{
+				Ar.Logf(TEXT("Wrote %s"), *Path);
+			}
+			else
+			{
+				Ar.Logf(ELogVerbosity::Error, TEXT("Could not write %s"), *Path);
+			}
+		}));
+
+	FAutoConsoleCommand LatencyResetCommand(
+		TEXT("Bowling.Latency.Reset"),
+		TEXT("Throw away every shot-to-pixel latency recorded so far"),
+		FConsoleCommandDelegate::CreateLambda([]
+		{
+			FBowlingLatencyTracker::Get().Reset();
+		}));
+
+	uint64 CyclesToMicros(uint64 Cycles)
+	{
+		return static_cast<uint64>(FPlatformTime::ToSeconds64(Cycles) * 1000000.0);
+	}
+}
+
+void FBowlingLatencyHistogram::Record(uint64 Micros)
+{
+	const auto Clamped = static_cast<uint32>(FMath::Min<uint64>(Micros, MAX_uint32));
+	Counts[GetBucket(Clamped)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64 FBowlingLatencyHistogram::GetCount() const
+{
+	uint64 Count = 0;
+	for (auto&& BucketCount : Counts)
+	{
+		Count += BucketCount.load(std::memory_order_relaxed);
+	}
+	return Count;
+}
+
+uint64 FBowlingLatencyHistogram::GetPercentile(double Percentile) const
+{
+	const auto Count = GetCount();
+	if (Count == 0) { return 0; }
+
+	const auto Target = FMath::Clamp<uint64>(static_cast<uint64>(FMath::CeilToDouble(Percentile * Count)), 1, Count);
+	uint64 Seen = 0;
+	for (auto Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		Seen += Counts[Bucket].load(std::memory_order_relaxed);
+		if (Seen >= Target) { return GetBucketMax(Bucket); }
+	}
+
+	// Recordings came in while counting
+	return GetBucketMax(NumBuckets - 1);
+}
+
+void FBowlingLatencyHistogram::Reset()
+{
+	for (auto&& BucketCount : Counts)
+	{
+		BucketCount.store(0, std::memory_order_relaxed);
+	}
+}
+
+int32 FBowlingLatencyHistogram::GetBucket(uint32 Micros)
+{
+	if (Micros < SubBuckets) { return static_cast<int32>(Micros); }
+
+	// Each power of two past the first gets SubBuckets buckets of its own
+	const auto Shift = static_cast<int32>(FPlatformMath::FloorLog2(Micros)) - SubBucketBits;
+	return (Shift + 1) * SubBuckets + static_cast<int32>(Micros >> Shift) - SubBuckets;
+}
+
+uint32 FBowlingLatencyHistogram::GetBucketMin(int32 Bucket)
+{
+	if (Bucket < SubBuckets) { return static_cast<uint32>(Bucket); }
+
+	const auto Shift = Bucket / SubBuckets - 1;
+	return static_cast<uint32>(Bucket % SubBuckets + SubBuckets) << Shift;
+}
+
+uint32 FBowlingLatencyHistogram::GetBucketMax(int32 Bucket)
+{
+	if (Bucket < SubBuckets) { return static_cast<uint32>(Bucket); }
+
+	const auto Shift = Bucket / SubBuckets - 1;
+	return GetBucketMin(Bucket) + ((1u << Shift) - 1);
+}
+
+FBowlingLatencyTracker& FBowlingLatencyTracker::Get()
+{
+	static FBowlingLatencyTracker Tracker;
+	return Tracker;
+}
+
+FBowlingLatencyTracker::FBowlingLatencyTracker()
+{
+	PendingRender.Reserve(MaxPendingRender);
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FBowlingLatencyTracker::EndFrame);
+}
+
+void FBowlingLatencyTracker::Record(const UBowlingScoreComponent& BowlingScoreComponent, EBowlingLatencyStage Stage)
+{
+	if (not CVarLatencyEnabled.GetValueOnGameThread()) { return; }
+
+	const auto Arrival = BowlingScoreComponent.GetShotArrivalCycles();
+	if (Arrival == 0) { return; }
+
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+	auto Lane = FindOrAddLane(BowlingScoreComponent);
+	auto& RecordedArrival = Lane->RecordedArrivals[static_cast<int32>(Stage)];
+	if (RecordedArrival == Arrival) { return; }
+	RecordedArrival = Arrival;
+
+	Lane->Histograms[static_cast<int32>(Stage)].Record(CyclesToMicros(FPlatformTime::Cycles64() - Arrival));
+
+	// Once everyone has been told, all that's left is drawing it, if anything draws. Shots past the limit when
+	// frames stall aren't worth growing the list for, they're only counted.
+	if (Stage == EBowlingLatencyStage::Broadcast and RenderFence)
+	{
+		if (PendingRender.Num() < MaxPendingRender)
+		{
+			PendingRender.Emplace(Lane, Arrival);
+		}
+		else
+		{
+			NumUntimedRenders++;
+		}
+	}
+}
+
+const FBowlingLatencyHistogram* FBowlingLatencyTracker::Find(const UBowlingScoreComponent& BowlingScoreComponent,
+                                                             EBowlingLatencyStage Stage) const
+{
+	const auto* Lane = Lanes.Find(&BowlingScoreComponent);
+	return Lane ? &(*Lane)->Histograms[static_cast<int32>(Stage)] : nullptr;
+}
+
+void FBowlingLatencyTracker::Remove(const UBowlingScoreComponent& BowlingScoreComponent)
+{
+	// Shots still waiting on the render thread keep their lane alive until they're timed
+	Lanes.Remove(&BowlingScoreComponent);
+}
+
+void FBowlingLatencyTracker::Report(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("%-40s %-14s %10s %10s %10s %10s"), TEXT("Lane"), TEXT("Stage"), TEXT("Shots"), TEXT("p50 us"),
+	        TEXT("p99 us"), TEXT("p999 us"));
+	ForEachLane([&Ar](const FLane& Lane)
+	{
+		for (auto Stage = 0; Stage < static_cast<int32>(EBowlingLatencyStage::Num); Stage++)
+		{
+			const auto& Histogram = Lane.Histograms[Stage];
+			Ar.Logf(TEXT("%-40s %-14s %10llu %10llu %10llu %10llu"), *Lane.Name,
+			        GetStageName(static_cast<EBowlingLatencyStage>(Stage)), Histogram.GetCount(),
+			        Histogram.GetPercentile(0.5), Histogram.GetPercentile(0.99), Histogram.GetPercentile(0.999));
+		}
+	});
+
+	if (NumUntimedRenders > 0)
+	{
+		Ar.Logf(ELogVerbosity::Warning,
+		        TEXT("%llu shots weren't timed to the screen, more than %d were waiting on a frame"), NumUntimedRenders,
+		        MaxPendingRender);
+	}
+}
+
+bool FBowlingLatencyTracker::DumpCsv(const FString& Path) const
+{
+	FString Csv = TEXT("Lane,Stage,Shots,P50Us,P99Us,P999Us\n");
+	ForEachLane([&Csv](const FLane& Lane)
+	{
+		for (auto Stage = 0; Stage < static_cast<int32>(EBowlingLatencyStage::Num); Stage++)
+		{
+			const auto& Histogram = Lane.Histograms[Stage];
+			Csv += FString::Printf(TEXT("%s,%s,%llu,%llu,%llu,%llu\n"), *Lane.Name,
+			                       GetStageName(static_cast<EBowlingLatencyStage>(Stage)), Histogram.GetCount(),
+			                       Histogram.GetPercentile(0.5), Histogram.GetPercentile(0.99),
+			                       Histogram.GetPercentile(0.999));
+		}
+	});
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+void FBowlingLatencyTracker::Reset()
+{
+	for (auto&& [Key, Lane] : Lanes)
+	{
+		for (auto& Histogram : Lane->Histograms)
+		{
+			Histogram.Reset();
+		}
+	}
+	NumUntimedRenders = 0;
+}
+
+void FBowlingLatencyTracker::SetRenderFence(TFunction<void(TFunction<void()>&& OnceDrawn)>&& InRenderFence)
+{
+	RenderFence = MoveTemp(InRenderFence);
+
+	// Nothing will draw what's waiting
+	if (not RenderFence) { PendingRender.Reset(); }
+}
+
+const TCHAR* FBowlingLatencyTracker::GetStageName(EBowlingLatencyStage Stage)
+{
+	switch (Stage)
+	{
+	case EBowlingLatencyStage::Recorded: return TEXT("Recorded");
+	case EBowlingLatencyStage::GameAdvanced: return TEXT("GameAdvanced");
+	case EBowlingLatencyStage::UpdateScore: return TEXT("UpdateScore");
+	case EBowlingLatencyStage::Broadcast: return TEXT("Broadcast");
+	case EBowlingLatencyStage::Rendered: return TEXT("Rendered");
+	default: return TEXT("Unknown");
+	}
+}
+
+FBowlingLatencyTracker::FLaneRef FBowlingLatencyTracker::FindOrAddLane(const UBowlingScoreComponent& BowlingScoreComponent)
+{
+	if (const auto* Lane = Lanes.Find(&BowlingScoreComponent))
+	{
+		return *Lane;
+	}
+
+	auto Lane = MakeShared<FLane, ESPMode::ThreadSafe>();
+	Lane->Name = BowlingScoreComponent.GetReadableName();
+	Lanes.Add(&BowlingScoreComponent, Lane);
+	return Lane;
+}
+
+void FBowlingLatencyTracker::EndFrame()
+{
+	if (PendingRender.IsEmpty() or not RenderFence) { return; }
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	// Copied rather than moved, so the list keeps its memory for the next frame
+	RenderFence([Shots = PendingRender]
+	{
+		const auto Now = FPlatformTime::Cycles64();
+		for (auto&& [Lane, Arrival] : Shots)
+		{
+			Lane->Histograms[static_cast<int32>(EBowlingLatencyStage::Rendered)].Record(CyclesToMicros(Now - Arrival));
+		}
+	});
+	PendingRender.Reset();
+}
+
+void FBowlingLatencyTracker::ForEachLane(TFunctionRef<void(const FLane& Lane)> Visit) const
+{
+	TArray<FLaneRef> Sorted;
+	Lanes.GenerateValueArray(Sorted);
+	Sorted.Sort([](const FLaneRef& A, const FLaneRef& B) { return A->Name < B->Name; });
+	for (auto&& Lane : Sorted)
+	{
+		Visit(*Lane);
+	}
+}
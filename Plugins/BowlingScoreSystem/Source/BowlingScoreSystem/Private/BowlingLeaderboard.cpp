@@ -0,0 +1,339 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingLeaderboard.h"
+
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+
+FBowlingLeaderboard::FBowlingLeaderboard(int32 RandomSeed) : RandomStream(RandomSeed)
+{
+	Empty();
+}
+
+void FBowlingLeaderboard::Empty()
+{
+	Nodes.Reset();
+	FreeNodes.Reset();
+	BowlerNodes.Reset();
+	Level = 1;
+
+	// Head node spans the whole (empty) list on every level
+	AllocateNode(FBowlingLeaderboardEntry(), MaxLevel);
+}
+
+bool FBowlingLeaderboard::IsAhead(const FBowlingLeaderboardEntry& A, const FBowlingLeaderboardEntry& B)
+{
+	const auto TotalA = A.GetTotal();
+	const auto TotalB = B.GetTotal();
+	return TotalA > TotalB or (TotalA == TotalB and A.BowlerId < B.BowlerId);
+}
+
+void FBowlingLeaderboard::Update(const FBowlingLeaderboardEntry& Entry)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	if (const auto* NodeIdx = BowlerNodes.Find(Entry.BowlerId))
+	{
+		auto& Existing = Nodes[*NodeIdx].Entry;
+
+		// Position only depends on the total, so most updates (like max possible score changing) stay in place
+		if (Existing.GetTotal() == Entry.GetTotal())
+		{
+			Existing = Entry;
+			return;
+		}
+
+		Erase(Existing);
+	}
+
+	Insert(Entry);
+}
+
+bool FBowlingLeaderboard::Remove(int32 BowlerId)
+{
+	const auto* NodeIdx = BowlerNodes.Find(BowlerId);
+	if (not NodeIdx) { return false; }
+
+	Erase(Nodes[*NodeIdx].Entry);
+	return true;
+}
+
+const FBowlingLeaderboardEntry* FBowlingLeaderboard::Find(int32 BowlerId) const
+{
+	const auto* NodeIdx = BowlerNodes.Find(BowlerId);
+	return NodeIdx ? &Nodes[*NodeIdx].Entry : nullptr;
+}
+
+int32 FBowlingLeaderboard::GetRank(int32 BowlerId) const
+{
+	const auto* Entry = Find(BowlerId);
+	if (not Entry) { return INDEX_NONE; }
+
+	// Walk forward over every node that isn't placed behind the entry, counting the positions skipped
+	auto Rank = 0;
+	auto NodeIdx = HeadNode;
+	for (auto LevelIdx = Level - 1; LevelIdx >= 0; LevelIdx--)
+	{
+		for (auto NextIdx = Nodes[NodeIdx].Next[LevelIdx];
+		     NextIdx != INDEX_NONE and not IsAhead(*Entry, Nodes[NextIdx].Entry);
+		     NextIdx = Nodes[NodeIdx].Next[LevelIdx])
+		{
+			Rank += Nodes[NodeIdx].Span[LevelIdx];
+			NodeIdx = NextIdx;
+		}
+
+		if (Nodes[NodeIdx].Entry.BowlerId == BowlerId and NodeIdx != HeadNode) { return Rank; }
+	}
+
+	return INDEX_NONE;
+}
+
+void FBowlingLeaderboard::GetRange(int32 FirstRank, int32 Count, TArray<FBowlingLeaderboardEntry>& OutEntries) const
+{
+	OutEntries.Reset();
+
+	// Only the first node needs to be searched for, after that the bottom level is already in order
+	auto NodeIdx = GetNodeAtRank(FMath::Max(FirstRank, 1));
+	for (auto Num = 0; Num < Count and NodeIdx != INDEX_NONE; Num++)
+	{
+		OutEntries.Add(Nodes[NodeIdx].Entry);
+		NodeIdx = Nodes[NodeIdx].Next[0];
+	}
+}
+
+int32 FBowlingLeaderboard::GetNodeAtRank(int32 Rank) const
+{
+	if (Rank > Num()) { return INDEX_NONE; }
+
+	auto Traversed = 0;
+	auto NodeIdx = HeadNode;
+	for (auto LevelIdx = Level - 1; LevelIdx >= 0; LevelIdx--)
+	{
+		while (Nodes[NodeIdx].Next[LevelIdx] != INDEX_NONE and Traversed + Nodes[NodeIdx].Span[LevelIdx] <= Rank)
+		{
+			Traversed += Nodes[NodeIdx].Span[LevelIdx];
+			NodeIdx = Nodes[NodeIdx].Next[LevelIdx];
+		}
+
+		if (Traversed == Rank) { return NodeIdx; }
+	}
+
+	return INDEX_NONE;
+}
+
+void FBowlingLeaderboard::Insert(const FBowlingLeaderboardEntry& Entry)
+{
+	// Find the last node ahead of the entry on every level, and its position
+	int32 Previous[MaxLevel];
+	int32 PreviousRank[MaxLevel];
+	auto NodeIdx = HeadNode;
+	for (auto LevelIdx = Level - 1; LevelIdx >= 0; LevelIdx--)
+	{
+		PreviousRank[LevelIdx] = LevelIdx == Level - 1 ? 0 : PreviousRank[LevelIdx + 1];
+		for (auto NextIdx = Nodes[NodeIdx].Next[LevelIdx];
+		     NextIdx != INDEX_NONE and IsAhead(Nodes[NextIdx].Entry, Entry);
+		     NextIdx = Nodes[NodeIdx].Next[LevelIdx])
+		{
+			PreviousRank[LevelIdx] += Nodes[NodeIdx].Span[LevelIdx];
+			NodeIdx = NextIdx;
+		}
+		Previous[LevelIdx] = NodeIdx;
+	}
+
+	const auto NewLevel = RandomLevel();
+	if (NewLevel > Level)
+	{
+		for (auto LevelIdx = Level; LevelIdx < NewLevel; LevelIdx++)
+		{
+			PreviousRank[LevelIdx] = 0;
+			Previous[LevelIdx] = HeadNode;
+			Nodes[HeadNode].Span[LevelIdx] = Num();
+		}
+		Level = NewLevel;
+	}
+
+	const auto NewIdx = AllocateNode(Entry, NewLevel);
+	for (auto LevelIdx = 0; LevelIdx < NewLevel; LevelIdx++)
+	{
+		auto& PreviousNode = Nodes[Previous[LevelIdx]];
+		auto& NewNode = Nodes[NewIdx];
+		const auto Skipped = PreviousRank[0] - PreviousRank[LevelIdx];
+
+		NewNode.Next[LevelIdx] = PreviousNode.Next[LevelIdx];
+		NewNode.Span[LevelIdx] = PreviousNode.Span[LevelIdx] - Skipped;
+		PreviousNode.Next[LevelIdx] = NewIdx;
+		PreviousNode.Span[LevelIdx] = Skipped + 1;
+	}
+
+	// Links above the new node now skip over one more position
+	for (auto LevelIdx = NewLevel; LevelIdx < Level; LevelIdx++)
+	{
+		Nodes[Previous[LevelIdx]].Span[LevelIdx]++;
+	}
+
+	BowlerNodes.Add(Entry.BowlerId, NewIdx);
+}
+
+void FBowlingLeaderboard::Erase(const FBowlingLeaderboardEntry& Entry)
+{
+	const auto BowlerId = Entry.BowlerId;
+	const auto ErasedIdx = BowlerNodes.FindChecked(BowlerId);
+
+	// Find the last node ahead of the entry on every level
+	int32 Previous[MaxLevel];
+	auto NodeIdx = HeadNode;
+	for (auto LevelIdx = Level - 1; LevelIdx >= 0; LevelIdx--)
+	{
+		for (auto NextIdx = Nodes[NodeIdx].Next[LevelIdx];
+		     NextIdx != INDEX_NONE and IsAhead(Nodes[NextIdx].Entry, Entry);
+		     NextIdx = Nodes[NodeIdx].Next[LevelIdx])
+		{
+			NodeIdx = NextIdx;
+		}
+		Previous[LevelIdx] = NodeIdx;
+	}
+
+	const auto& ErasedNode = Nodes[ErasedIdx];
+	for (auto LevelIdx = 0; LevelIdx < Level; LevelIdx++)
+	{
+		auto& PreviousNode = Nodes[Previous[LevelIdx]];
+		if (PreviousNode.Next[LevelIdx] == ErasedIdx)
+		{
+			PreviousNode.Span[LevelIdx] += ErasedNode.Span[LevelIdx] - 1;
+			PreviousNode.Next[LevelIdx] = ErasedNode.Next[LevelIdx];
+		}
+		else
+		{
+			PreviousNode.Span[LevelIdx]--;
+		}
+	}
+
+	while (Level > 1 and Nodes[HeadNode].Next[Level - 1] == INDEX_NONE)
+	{
+		Level--;
+	}
+
+	BowlerNodes.Remove(BowlerId);
+	FreeNodes.Push(ErasedIdx);
+}
+
+int32 FBowlingLeaderboard::AllocateNode(const FBowlingLeaderboardEntry& Entry, int32 NodeLevel)
+{
+	const auto NodeIdx = FreeNodes.Num() > 0 ? FreeNodes.Pop(EAllowShrinking::No) : Nodes.AddDefaulted();
+
+	auto& Node = Nodes[NodeIdx];
+	Node.Entry = Entry;
+	Node.Level = NodeLevel;
+	for (auto LevelIdx = 0; LevelIdx < MaxLevel; LevelIdx++)
+	{
+		Node.Next[LevelIdx] = INDEX_NONE;
+		Node.Span[LevelIdx] = 0;
+	}
+
+	return NodeIdx;
+}
+
+int32 FBowlingLeaderboard::RandomLevel()
+{
+	// Each level holds roughly a quarter of the nodes of the level below it
+	auto NewLevel = 1;
+	while (NewLevel < MaxLevel and (RandomStream.GetUnsignedInt() & 3) == 0)
+	{
+		NewLevel++;
+	}
+	return NewLevel;
+}
+
+void UBowlingLeaderboard::AddBowler(UBowlingScoreComponent* BowlingScoreComponent, int32 BowlerId)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+
+	Bowlers.Add(BowlingScoreComponent, BowlerId);
+
+	BowlingScoreComponent->OnScoreChanged.AddUniqueDynamic(this, &UBowlingLeaderboard::ScoreChanged);
+	BowlingScoreComponent->OnGameOver.AddUniqueDynamic(this, &UBowlingLeaderboard::GameOver);
+	BowlingScoreComponent->OnReset.AddUniqueDynamic(this, &UBowlingLeaderboard::GameReset);
+
+	UpdateCurrentGame(BowlingScoreComponent);
+}
+
+void UBowlingLeaderboard::RemoveBowler(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	int32 BowlerId;
+	if (not Bowlers.RemoveAndCopyValue(BowlingScoreComponent, BowlerId)) { return; }
+
+	Standings.Remove(BowlerId);
+
+	if (IsValid(BowlingScoreComponent))
+	{
+		BowlingScoreComponent->OnScoreChanged.RemoveDynamic(this, &UBowlingLeaderboard::ScoreChanged);
+		BowlingScoreComponent->OnGameOver.RemoveDynamic(this, &UBowlingLeaderboard::GameOver);
+		BowlingScoreComponent->OnReset.RemoveDynamic(this, &UBowlingLeaderboard::GameReset);
+	}
+}
+
+int32 UBowlingLeaderboard::GetRank(int32 BowlerId) const
+{
+	return Standings.GetRank(BowlerId);
+}
+
+TArray<FBowlingLeaderboardEntry> UBowlingLeaderboard::GetRange(int32 FirstRank, int32 Count) const
+{
+	TArray<FBowlingLeaderboardEntry> Entries;
+	Standings.GetRange(FirstRank, Count, Entries);
+	return Entries;
+}
+
+TArray<FBowlingLeaderboardEntry> UBowlingLeaderboard::GetTop(int32 K) const
+{
+	return GetRange(1, K);
+}
+
+void UBowlingLeaderboard::ScoreChanged(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame)
+{
+	UpdateCurrentGame(BowlingScoreComponent);
+}
+
+void UBowlingLeaderboard::GameOver(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	const auto* BowlerId = Bowlers.Find(BowlingScoreComponent);
+	if (not ensure(BowlerId)) { return; }
+
+	// Roll the finished game into the series
+	FBowlingLeaderboardEntry Entry;
+	if (const auto* Existing = Standings.Find(*BowlerId))
+	{
+		Entry = *Existing;
+	}
+	Entry.BowlerId = *BowlerId;
+	Entry.SeriesTotal += BowlingScoreComponent->GetScore(BowlingScoreComponent->GetNumFrames());
+	Entry.CurrentScore = 0;
+	Entry.MaxPossibleScore = 0;
+	Standings.Update(Entry);
+}
+
+void UBowlingLeaderboard::GameReset(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	UpdateCurrentGame(BowlingScoreComponent);
+}
+
+void UBowlingLeaderboard::UpdateCurrentGame(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	const auto* BowlerId = Bowlers.Find(BowlingScoreComponent);
+	if (not ensure(BowlerId)) { return; }
+
+	// Finished games have already been counted in the series
+	if (BowlingScoreComponent->IsGameOver()) { return; }
+
+	FBowlingLeaderboardEntry Entry;
+	if (const auto* Existing = Standings.Find(*BowlerId))
+	{
+		Entry = *Existing;
+	}
+	Entry.BowlerId = *BowlerId;
+	Entry.CurrentScore = BowlingScoreComponent->GetScore(BowlingScoreComponent->GetNumFrames());
+	Entry.MaxPossibleScore = BowlingScoreComponent->GetMaxPossibleScore();
+	Standings.Update(Entry);
+}
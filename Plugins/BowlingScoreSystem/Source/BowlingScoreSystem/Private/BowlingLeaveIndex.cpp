@@ -0,0 +1,249 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingLeaveIndex.h"
+
+#include "BowlingFrameScore.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+FBowlingLeaveSet FBowlingLeaveSet::Only(uint16 Leave)
+{
+	FBowlingLeaveSet Set;
+	if (Leave < NumLeaves) { Set.Add(Leave); }
+	return Set;
+}
+
+FBowlingLeaveSet FBowlingLeaveSet::Containing(uint16 Pins)
+{
+	FBowlingLeaveSet Set;
+	for (auto Word = 0; Word < NumWords; Word++)
+	{
+		uint64 Bits = 0;
+		for (auto Bit = 0; Bit < 64; Bit++)
+		{
+			const auto Leave = Word * 64 + Bit;
+			Bits |= static_cast<uint64>((Leave & Pins) == Pins) << Bit;
+		}
+		Set.Words[Word] = Bits;
+	}
+	return Set;
+}
+
+const FBowlingLeaveSet& FBowlingLeaveSet::Splits()
+{
+	static const auto SplitSet = []
+	{
+		FBowlingLeaveSet Set;
+		for (auto Leave = 0; Leave < NumLeaves; Leave++)
+		{
+			if (IsSplit(static_cast<uint16>(Leave))) { Set.Add(static_cast<uint16>(Leave)); }
+		}
+		return Set;
+	}();
+	return SplitSet;
+}
+
+bool FBowlingLeaveSet::IsSplit(uint16 Leave)
+{
+	if (Leave >= NumLeaves or (Leave & 1) != 0 or FMath::CountBits(Leave) < 2) { return false; }
+
+	// Spread out from the lowest pin through its neighbours, it's a split if some pins can't be reached
+	auto Reached = static_cast<uint16>(Leave & (~Leave + 1));
+	for (;;)
+	{
+		auto Next = Reached;
+		for (auto Pin = 0; Pin < 10; Pin++)
+		{
+			if (Reached & (1 << Pin)) { Next |= static_cast<uint16>(FBowlingFrameScore::AdjacentPins[Pin] & Leave); }
+		}
+		if (Next == Reached) { break; }
+		Reached = Next;
+	}
+	return Reached != Leave;
+}
+
+int32 FBowlingLeaveSet::Num() const
+{
+	auto Count = 0;
+	for (const auto Word : Words)
+	{
+		Count += static_cast<int32>(FMath::CountBits(Word));
+	}
+	return Count;
+}
+
+FBowlingLeaveSet FBowlingLeaveSet::operator&(const FBowlingLeaveSet& Other) const
+{
+	FBowlingLeaveSet Set;
+	for (auto Word = 0; Word < NumWords; Word++)
+	{
+		Set.Words[Word] = Words[Word] & Other.Words[Word];
+	}
+	return Set;
+}
+
+FBowlingLeaveSet FBowlingLeaveSet::operator|(const FBowlingLeaveSet& Other) const
+{
+	FBowlingLeaveSet Set;
+	for (auto Word = 0; Word < NumWords; Word++)
+	{
+		Set.Words[Word] = Words[Word] | Other.Words[Word];
+	}
+	return Set;
+}
+
+FBowlingLeaveIndex::FBowlingLeaveIndex()
+{
+	Empty();
+}
+
+void FBowlingLeaveIndex::Record(int32 BowlerId, FName League, uint16 Leave, bool bConverted)
+{
+	if (not ensure(Leave > 0 and Leave < FBowlingLeaveSet::NumLeaves)) { return; }
+
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	const auto Conversion = bConverted ? 1u : 0u;
+	for (auto* ColumnsIdx : {&BowlerColumns.FindOrAdd(BowlerId, INDEX_NONE), &LeagueColumns.FindOrAdd(League, INDEX_NONE)})
+	{
+		auto& Counts = FindOrAddColumns(*ColumnsIdx);
+		Counts.Attempts[Leave]++;
+		Counts.Conversions[Leave] += Conversion;
+	}
+	Columns[0].Attempts[Leave]++;
+	Columns[0].Conversions[Leave] += Conversion;
+}
+
+FBowlingLeaveStats FBowlingLeaveIndex::GetBowlerStats(int32 BowlerId, const FBowlingLeaveSet& Leaves) const
+{
+	const auto* ColumnsIdx = BowlerColumns.Find(BowlerId);
+	return ColumnsIdx ? Sum(Columns[*ColumnsIdx], Leaves) : FBowlingLeaveStats();
+}
+
+FBowlingLeaveStats FBowlingLeaveIndex::GetLeagueStats(FName League, const FBowlingLeaveSet& Leaves) const
+{
+	const auto* ColumnsIdx = LeagueColumns.Find(League);
+	return ColumnsIdx ? Sum(Columns[*ColumnsIdx], Leaves) : FBowlingLeaveStats();
+}
+
+FBowlingLeaveStats FBowlingLeaveIndex::GetTotalStats(const FBowlingLeaveSet& Leaves) const
+{
+	return Sum(Columns[0], Leaves);
+}
+
+FBowlingLeaveSet FBowlingLeaveIndex::GetBowlerLeaves(int32 BowlerId) const
+{
+	const auto* ColumnsIdx = BowlerColumns.Find(BowlerId);
+	return ColumnsIdx ? GetLeaves(Columns[*ColumnsIdx]) : FBowlingLeaveSet();
+}
+
+FBowlingLeaveSet FBowlingLeaveIndex::GetLeagueLeaves(FName League) const
+{
+	const auto* ColumnsIdx = LeagueColumns.Find(League);
+	return ColumnsIdx ? GetLeaves(Columns[*ColumnsIdx]) : FBowlingLeaveSet();
+}
+
+void FBowlingLeaveIndex::Empty()
+{
+	Columns.Reset();
+	Columns.AddDefaulted();
+	BowlerColumns.Reset();
+	LeagueColumns.Reset();
+}
+
+FBowlingLeaveStats FBowlingLeaveIndex::Sum(const FColumns& Counts, const FBowlingLeaveSet& Leaves)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingLeaveIndex::Sum);
+
+	uint64 Attempts = 0;
+	uint64 Conversions = 0;
+	for (auto Leave = 0; Leave < FBowlingLeaveSet::NumLeaves; Leave++)
+	{
+		// All ones for leaves in the set and zero for the rest
+		const auto InSet = 0u - static_cast<uint32>((Leaves.Words[Leave / 64] >> (Leave % 64)) & 1);
+		Attempts += Counts.Attempts[Leave] & InSet;
+		Conversions += Counts.Conversions[Leave] & InSet;
+	}
+
+	FBowlingLeaveStats Stats;
+	Stats.Attempts = static_cast<int32>(FMath::Min<uint64>(Attempts, MAX_int32));
+	Stats.Conversions = static_cast<int32>(FMath::Min<uint64>(Conversions, MAX_int32));
+	return Stats;
+}
+
+FBowlingLeaveSet FBowlingLeaveIndex::GetLeaves(const FColumns& Counts)
+{
+	FBowlingLeaveSet Set;
+	for (auto Word = 0; Word < FBowlingLeaveSet::NumWords; Word++)
+	{
+		uint64 Bits = 0;
+		for (auto Bit = 0; Bit < 64; Bit++)
+		{
+			Bits |= static_cast<uint64>(Counts.Attempts[Word * 64 + Bit] > 0) << Bit;
+		}
+		Set.Words[Word] = Bits;
+	}
+	return Set;
+}
+
+FBowlingLeaveIndex::FColumns& FBowlingLeaveIndex::FindOrAddColumns(int32& ColumnsIdx)
+{
+	if (ColumnsIdx == INDEX_NONE)
+	{
+		ColumnsIdx = Columns.AddDefaulted();
+	}
+	return Columns[ColumnsIdx];
+}
+
+void UBowlingLeaveIndex::AddBowler(UBowlingScoreComponent* BowlingScoreComponent, int32 BowlerId, FName League)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+
+	RemoveBowler(BowlingScoreComponent);
+	Bowlers.Add(BowlingScoreComponent, BowlerId);
+	BowlerLeagues.Add(BowlerId, League);
+
+	BowlingScoreComponent->OnShotRecorded.AddUObject(this, &UBowlingLeaveIndex::ShotRecorded);
+}
+
+void UBowlingLeaveIndex::RemoveBowler(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	int32 BowlerId;
+	if (not Bowlers.RemoveAndCopyValue(BowlingScoreComponent, BowlerId)) { return; }
+
+	if (IsValid(BowlingScoreComponent))
+	{
+		BowlingScoreComponent->OnShotRecorded.RemoveAll(this);
+	}
+}
+
+FBowlingLeaveStats UBowlingLeaveIndex::GetLeaveStats(int32 BowlerId, int32 Leave) const
+{
+	if (Leave <= 0 or Leave >= FBowlingLeaveSet::NumLeaves) { return FBowlingLeaveStats(); }
+	return Index.GetBowlerStats(BowlerId, FBowlingLeaveSet::Only(static_cast<uint16>(Leave)));
+}
+
+FBowlingLeaveStats UBowlingLeaveIndex::GetSplitStats(int32 BowlerId) const
+{
+	return Index.GetBowlerStats(BowlerId, FBowlingLeaveSet::Splits());
+}
+
+void UBowlingLeaveIndex::ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score)
+{
+	const auto* BowlerId = Bowlers.Find(BowlingScoreComponent);
+	if (not BowlerId) { return; }
+
+	// Only the second ball at a rack is bowled at a leave
+	const auto& RuleSet = BowlingScoreComponent->GetRuleSet();
+	const auto& FrameScore = BowlingScoreComponent->GetFrameScores()[Frame - 1];
+	if (RuleSet.GetRack(FrameScore, Shot - 1).Ball != 1) { return; }
+
+	// Nothing to count when the first ball's pins aren't known
+	const auto Leave = RuleSet.GetStandingMask(FrameScore, Shot - 1);
+	if (Leave == 0) { return; }
+
+	Index.Record(*BowlerId, BowlerLeagues.FindRef(*BowlerId), Leave, Score == static_cast<int32>(FMath::CountBits(Leave)));
+}
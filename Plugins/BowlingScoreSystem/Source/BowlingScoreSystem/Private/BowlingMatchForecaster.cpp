@@ -0,0 +1,289 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingMatchForecaster.h"
+
+#include "Async/Async.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Tasks/Task.h"
+
+FBowlingGameSnapshot FBowlingGameSnapshot::Capture(const UBowlingScoreComponent& BowlingScoreComponent)
+{
+	FBowlingGameSnapshot Snapshot;
+	Snapshot.Frames = BowlingScoreComponent.GetFrameScores();
+	Snapshot.RuleSet = &BowlingScoreComponent.GetRuleSet();
+	if (BowlingScoreComponent.IsGameOver())
+	{
+		Snapshot.FrameIdx = Snapshot.RuleSet->NumFrames;
+		Snapshot.ShotIdx = 0;
+	}
+	else
+	{
+		Snapshot.FrameIdx = BowlingScoreComponent.GetCurrentFrameNum() - 1;
+		Snapshot.ShotIdx = BowlingScoreComponent.GetCurrentShotNum() - 1;
+	}
+	return Snapshot;
+}
+
+/*
+ * One forecast of a match, simulated a chunk at a time. Only one chunk of a run is ever in flight, so the run itself
+ * needs no locking.
+ */
+struct FBowlingForecastRun
+{
+	int32 MatchId = 0;
+	uint32 Generation = 0;
+	TSharedPtr<FBowlingForecastControl, ESPMode::ThreadSafe> Control;
+	TWeakObjectPtr<UBowlingMatchForecaster> Forecaster;
+
+	TArray<FBowlingGameSnapshot> Games;
+	int32 NumSimulations = 0;
+	int32 SimulationsPerChunk = 0;
+	float PinFallChance = 0.f;
+	FRandomStream RandomStream;
+
+	FBowlingForecast Forecast;
+
+	bool IsCancelled() const { return Control->Generation.load(std::memory_order_relaxed) != Generation; }
+
+	static void Launch(const TSharedRef<FBowlingForecastRun, ESPMode::ThreadSafe>& Run)
+	{
+		// Going to the back of the queue after every chunk is what keeps matches sharing the pool fairly
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [Run] { RunChunk(Run); }, LowLevelTasks::ETaskPriority::BackgroundNormal);
+	}
+
+	static void RunChunk(const TSharedRef<FBowlingForecastRun, ESPMode::ThreadSafe>& Run)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingForecastRun::RunChunk);
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+
+		if (Run->IsCancelled()) { return; }
+
+		const auto NumGames = FMath::Min(Run->SimulationsPerChunk, Run->NumSimulations - Run->Forecast.NumSimulations);
+		UBowlingMatchForecaster::Simulate(Run->Games, NumGames, Run->PinFallChance, Run->RandomStream, Run->Forecast);
+
+		// A shot may have come in while simulating, the game thread checks again in case one comes in after this
+		if (Run->IsCancelled()) { return; }
+
+		AsyncTask(ENamedThreads::GameThread,
+		          [Forecaster = Run->Forecaster, MatchId = Run->MatchId, Generation = Run->Generation,
+			          Forecast = Run->Forecast]
+		          {
+			          if (auto* This = Forecaster.Get())
+			          {
+				          This->ForecastUpdated(MatchId, Generation, Forecast);
+			          }
+		          });
+
+		if (Run->Forecast.NumSimulations < Run->NumSimulations)
+		{
+			Launch(Run);
+		}
+	}
+};
+
+int32 UBowlingMatchForecaster::AddMatch(const TArray<UBowlingScoreComponent*>& Bowlers)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	const auto MatchId = NextMatchId++;
+	auto& Match = Matches.Add(MatchId);
+	Match.Control = MakeShared<FBowlingForecastControl, ESPMode::ThreadSafe>();
+
+	for (auto* BowlingScoreComponent : Bowlers)
+	{
+		if (not ensure(IsValid(BowlingScoreComponent))) { continue; }
+
+		// Bowlers in more than one match are only listened to once
+		if (not BowlerMatches.Contains(BowlingScoreComponent))
+		{
+			BowlingScoreComponent->OnShotRecorded.AddUObject(this, &UBowlingMatchForecaster::ShotRecorded);
+			BowlingScoreComponent->OnReset.AddUniqueDynamic(this, &UBowlingMatchForecaster::GameReset);
+		}
+		Match.Bowlers.Add(BowlingScoreComponent);
+		BowlerMatches.Add(BowlingScoreComponent, MatchId);
+	}
+
+	Restart(MatchId);
+	return MatchId;
+}
+
+void UBowlingMatchForecaster::RemoveMatch(int32 MatchId)
+{
+	FBowlingForecastMatch Match;
+	if (not Matches.RemoveAndCopyValue(MatchId, Match)) { return; }
+
+	// Stop the simulations in flight
+	Match.Control->Generation++;
+
+	for (auto&& BowlingScoreComponent : Match.Bowlers)
+	{
+		BowlerMatches.RemoveSingle(BowlingScoreComponent.Get(), MatchId);
+
+		// Keep listening while the bowler is still in another match
+		if (IsValid(BowlingScoreComponent) and not BowlerMatches.Contains(BowlingScoreComponent.Get()))
+		{
+			BowlingScoreComponent->OnShotRecorded.RemoveAll(this);
+			BowlingScoreComponent->OnReset.RemoveDynamic(this, &UBowlingMatchForecaster::GameReset);
+		}
+	}
+}
+
+void UBowlingMatchForecaster::Restart(int32 MatchId)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	auto* Match = Matches.Find(MatchId);
+	if (not Match) { return; }
+
+	// Moving the generation on cancels whatever is still running for the old scores
+	const auto Generation = ++Match->Control->Generation;
+
+	auto Run = MakeShared<FBowlingForecastRun, ESPMode::ThreadSafe>();
+	Run->MatchId = MatchId;
+	Run->Generation = Generation;
+	Run->Control = Match->Control;
+	Run->Forecaster = this;
+	Run->NumSimulations = FMath::Max(1, NumSimulations);
+	Run->SimulationsPerChunk = FMath::Max(1, SimulationsPerChunk);
+	Run->PinFallChance = PinFallChance;
+	Run->RandomStream.Initialize(HashCombineFast(GetTypeHash(MatchId), GetTypeHash(Generation)));
+	Run->Games.Reserve(Match->Bowlers.Num());
+	for (auto&& BowlingScoreComponent : Match->Bowlers)
+	{
+		if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+		Run->Games.Add(FBowlingGameSnapshot::Capture(*BowlingScoreComponent));
+	}
+
+	Match->Forecast = FBowlingForecast();
+	FBowlingForecastRun::Launch(Run);
+}
+
+bool UBowlingMatchForecaster::GetForecast(int32 MatchId, FBowlingForecast& OutForecast) const
+{
+	const auto* Match = Matches.Find(MatchId);
+	if (not Match) { return false; }
+
+	OutForecast = Match->Forecast;
+	return true;
+}
+
+void UBowlingMatchForecaster::Simulate(TConstArrayView<FBowlingGameSnapshot> Games, int32 NumGames,
+                                       float PinFallChance, FRandomStream& RandomStream, FBowlingForecast& Forecast)
+{
+	const auto NumBowlers = Games.Num();
+	if (NumBowlers == 0 or NumGames <= 0) { return; }
+
+	TArray<double, TInlineAllocator<8>> Wins;
+	TArray<double, TInlineAllocator<8>> ScoreSums;
+	TArray<int32, TInlineAllocator<8>> Scores;
+	Wins.SetNumZeroed(NumBowlers);
+	ScoreSums.SetNumZeroed(NumBowlers);
+	Scores.SetNumZeroed(NumBowlers);
+	TArray<FBowlingFrameScore> Frames;
+
+	for (auto Game = 0; Game < NumGames; Game++)
+	{
+		auto BestScore = -1;
+		auto NumBest = 0;
+		for (auto BowlerIdx = 0; BowlerIdx < NumBowlers; BowlerIdx++)
+		{
+			const auto& Snapshot = Games[BowlerIdx];
+			const auto& RuleSet = *Snapshot.RuleSet;
+			Frames = Snapshot.Frames;
+
+			// Play out the rest of the game, each standing pin falling independently
+			auto FrameIdx = Snapshot.FrameIdx;
+			auto ShotIdx = Snapshot.ShotIdx;
+			while (FrameIdx >= 0 and FrameIdx < RuleSet.NumFrames)
+			{
+				auto& Frame = Frames[FrameIdx];
+				const auto Standing = RuleSet.GetRack(Frame, ShotIdx).Standing;
+				auto Pinfall = 0;
+				for (auto Pin = 0; Pin < Standing; Pin++)
+				{
+					Pinfall += RandomStream.GetFraction() < PinFallChance ? 1 : 0;
+				}
+				Frame.Shots[ShotIdx] = Pinfall;
+				RuleSet.Advance(Frames, FrameIdx, ShotIdx);
+			}
+
+			const auto Score = RuleSet.GetScore(Frames, RuleSet.NumFrames - 1);
+			Scores[BowlerIdx] = Score;
+			ScoreSums[BowlerIdx] += Score;
+			if (Score > BestScore)
+			{
+				BestScore = Score;
+				NumBest = 1;
+			}
+			else if (Score == BestScore)
+			{
+				NumBest++;
+			}
+		}
+
+		for (auto BowlerIdx = 0; BowlerIdx < NumBowlers; BowlerIdx++)
+		{
+			if (Scores[BowlerIdx] == BestScore)
+			{
+				Wins[BowlerIdx] += 1.0 / NumBest;
+			}
+		}
+	}
+
+	// Fold this batch into the running averages
+	const double PreviousGames = Forecast.NumSimulations;
+	const double TotalGames = PreviousGames + NumGames;
+	Forecast.WinProbabilities.SetNumZeroed(NumBowlers);
+	Forecast.ExpectedScores.SetNumZeroed(NumBowlers);
+	for (auto BowlerIdx = 0; BowlerIdx < NumBowlers; BowlerIdx++)
+	{
+		Forecast.WinProbabilities[BowlerIdx] = static_cast<float>(
+			(Forecast.WinProbabilities[BowlerIdx] * PreviousGames + Wins[BowlerIdx]) / TotalGames);
+		Forecast.ExpectedScores[BowlerIdx] = static_cast<float>(
+			(Forecast.ExpectedScores[BowlerIdx] * PreviousGames + ScoreSums[BowlerIdx]) / TotalGames);
+	}
+	Forecast.NumSimulations += NumGames;
+}
+
+void UBowlingMatchForecaster::BeginDestroy()
+{
+	// Anything still running finishes its chunk and stops
+	for (auto&& [MatchId, Match] : Matches)
+	{
+		Match.Control->Generation++;
+	}
+
+	Super::BeginDestroy();
+}
+
+void UBowlingMatchForecaster::ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot,
+                                           int32 Score)
+{
+	RestartMatchesFor(BowlingScoreComponent);
+}
+
+void UBowlingMatchForecaster::GameReset(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	RestartMatchesFor(BowlingScoreComponent);
+}
+
+void UBowlingMatchForecaster::RestartMatchesFor(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	TArray<int32, TInlineAllocator<4>> MatchIds;
+	BowlerMatches.MultiFind(BowlingScoreComponent, MatchIds);
+	for (auto MatchId : MatchIds)
+	{
+		Restart(MatchId);
+	}
+}
+
+void UBowlingMatchForecaster::ForecastUpdated(int32 MatchId, uint32 Generation, const FBowlingForecast& Forecast)
+{
+	auto* Match = Matches.Find(MatchId);
+	if (not Match or Match->Control->Generation.load() != Generation) { return; }
+
+	Match->Forecast = Forecast;
+	OnForecastUpdated.Broadcast(MatchId, Forecast);
+}
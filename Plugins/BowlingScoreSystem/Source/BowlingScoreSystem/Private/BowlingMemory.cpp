@@ -0,0 +1,40 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingMemory.h"
+
+#include "BowlingScoreComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+LLM_DEFINE_TAG(Bowling);
+LLM_DEFINE_TAG(Bowling_Games, NAME_None, TEXT("Bowling"));
+LLM_DEFINE_TAG(Bowling_Widgets, NAME_None, TEXT("Bowling"));
+LLM_DEFINE_TAG(Bowling_Caches, NAME_None, TEXT("Bowling"));
+
+FOnBowlingMemoryReport FBowlingMemory::OnReport;
+
+namespace
+{
+	void ReportMemory(FOutputDevice& Ar)
+	{
+		SIZE_T GameBytes = 0;
+		auto NumGames = 0;
+		for (TObjectIterator<UBowlingScoreComponent> It(RF_ClassDefaultObject | RF_ArchetypeObject); It; ++It)
+		{
+			const auto Bytes = It->GetClass()->GetStructureSize() + It->GetAllocatedSize();
+			Ar.Logf(TEXT("Game %s: %llu bytes"), *It->GetReadableName(), static_cast<uint64>(Bytes));
+			GameBytes += Bytes;
+			NumGames++;
+		}
+
+		Ar.Logf(TEXT("%d games, %llu bytes (%llu per game)"), NumGames, static_cast<uint64>(GameBytes),
+		        static_cast<uint64>(NumGames > 0 ? GameBytes / NumGames : 0));
+		FBowlingMemory::OnReport.Broadcast(Ar);
+		Ar.Logf(TEXT("Run with -llm and use stat LLMFULL for everything allocated under the Bowling tags"));
+	}
+
+	FAutoConsoleCommandWithOutputDevice MemoryCommand(
+		TEXT("Bowling.Memory"),
+		TEXT("Print the bytes used by every bowling game and scorecard"),
+		FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&ReportMemory));
+}
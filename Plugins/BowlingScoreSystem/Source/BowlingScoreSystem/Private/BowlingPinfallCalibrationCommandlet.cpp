@@ -0,0 +1,115 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingPinfallCalibrationCommandlet.h"
+
+#include "BowlingFrameScore.h"
+#include "BowlingPinfallModel.h"
+#include "BowlingScoreSystem.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+UBowlingPinfallCalibrationCommandlet::UBowlingPinfallCalibrationCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = false;
+}
+
+int32 UBowlingPinfallCalibrationCommandlet::Main(const FString& Params)
+{
+	FString ShotsPath;
+	FString OutputPath;
+	if (not FParse::Value(*Params, TEXT("Shots="), ShotsPath) or not FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		UE_LOG(LogBowling, Error, TEXT("Missing -Shots=<Path> to fit to or -Output=<Path> for the weights"));
+		return 1;
+	}
+
+	auto Iterations = 500;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	auto LearningRate = 0.5f;
+	FParse::Value(*Params, TEXT("LearningRate="), LearningRate);
+	auto Seed = 1;
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	FBowlingPinfallModel Model;
+	FString WeightsPath;
+	if (FParse::Value(*Params, TEXT("Weights="), WeightsPath))
+	{
+		FString Weights;
+		if (not FFileHelper::LoadFileToString(Weights, *WeightsPath) or not Model.LoadFromString(Weights))
+		{
+			UE_LOG(LogBowling, Error, TEXT("Could not load weights from %s"), *WeightsPath);
+			return 1;
+		}
+	}
+
+	TArray<FString> Lines;
+	if (not FFileHelper::LoadFileToStringArray(Lines, *ShotsPath))
+	{
+		UE_LOG(LogBowling, Error, TEXT("Could not open shots %s"), *ShotsPath);
+		return 1;
+	}
+
+	TArray<FBowlingRecordedShot> Shots;
+	Shots.Reserve(Lines.Num());
+	for (const auto& Line : Lines)
+	{
+		FBowlingRecordedShot Shot;
+		if (ParseShot(Line, Shot)) { Shots.Add(Shot); }
+	}
+	if (Shots.IsEmpty())
+	{
+		UE_LOG(LogBowling, Error, TEXT("No shots in %s"), *ShotsPath);
+		return 1;
+	}
+
+	const auto StartTime = FPlatformTime::Seconds();
+	const auto InitialLoss = Model.GetLogLoss(Shots);
+	const auto FittedLoss = Model.Fit(Shots, Iterations, LearningRate);
+	UE_LOG(LogBowling, Display, TEXT("Fitted %d shots in %.2fs, log loss per pin %.4f down from %.4f"), Shots.Num(),
+	       FPlatformTime::Seconds() - StartTime, FittedLoss, InitialLoss);
+
+	// Replay every recorded first ball through the fitted model, the strike rates should come out close
+	FRandomStream Random(Seed);
+	auto NumFirstBalls = 0;
+	auto NumStrikes = 0;
+	auto NumSimulatedStrikes = 0;
+	for (const auto& Shot : Shots)
+	{
+		if (Shot.Standing != FBowlingFrameScore::FullPinMask) { continue; }
+		NumFirstBalls++;
+		NumStrikes += Shot.PinsDown == Shot.Standing ? 1 : 0;
+		NumSimulatedStrikes += Model.Simulate(Shot.Delivery, Shot.Standing, Random) == Shot.Standing ? 1 : 0;
+	}
+	if (NumFirstBalls > 0)
+	{
+		UE_LOG(LogBowling, Display, TEXT("Strike rate %.1f%% recorded, %.1f%% simulated over %d full racks"),
+		       100.0f * NumStrikes / NumFirstBalls, 100.0f * NumSimulatedStrikes / NumFirstBalls, NumFirstBalls);
+	}
+
+	if (not FFileHelper::SaveStringToFile(Model.SaveToString(), *OutputPath))
+	{
+		UE_LOG(LogBowling, Error, TEXT("Could not write weights to %s"), *OutputPath);
+		return 1;
+	}
+	return 0;
+}
+
+bool UBowlingPinfallCalibrationCommandlet::ParseShot(const FString& Line, FBowlingRecordedShot& OutShot)
+{
+	TArray<FString> Values;
+	Line.ParseIntoArray(Values, TEXT(","));
+	if (Values.Num() != 7 or not Values[0].TrimStart().IsNumeric()) { return false; }
+
+	OutShot.Delivery.Speed = FCString::Atof(*Values[0]);
+	OutShot.Delivery.EntryAngle = FCString::Atof(*Values[1]);
+	OutShot.Delivery.Board = FCString::Atof(*Values[2]);
+	OutShot.Delivery.RevRate = FCString::Atof(*Values[3]);
+	OutShot.Delivery.bLeftHanded = Values[4].TrimStartAndEnd().Equals(TEXT("L"), ESearchCase::IgnoreCase);
+	OutShot.Standing = static_cast<uint16>(FCString::Atoi(*Values[5]) & FBowlingFrameScore::FullPinMask);
+	OutShot.PinsDown = static_cast<uint16>(FCString::Atoi(*Values[6]) & OutShot.Standing);
+	return OutShot.Standing != 0;
+}
@@ -0,0 +1,303 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingPinfallModel.h"
+
+#include "BowlingFrameScore.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreSystem.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+	// Lane geometry in inches
+	constexpr auto BoardWidth = 1.0641f;
+	constexpr auto RowSpacing = 10.392f;
+
+	// A ball touches a pin when their middles are closer than a ball's and a pin's radius together
+	constexpr auto ContactBoards = (4.25f + 2.39f) / BoardWidth;
+
+	// The ideal pocket line for a right-handed bowler
+	constexpr auto PocketBoard = 17.5f;
+	constexpr auto PocketAngle = 6.0f;
+
+	// Row and board of each pin's middle, for a right-handed bowler counting boards from the right gutter
+	constexpr int32 PinRows[FBowlingPinfallModel::NumPins] = {0, 1, 1, 2, 2, 2, 3, 3, 3, 3};
+	constexpr float PinBoards[FBowlingPinfallModel::NumPins] = {
+		20.0f, 25.64f, 14.36f, 31.28f, 20.0f, 8.72f, 36.92f, 25.64f, 14.36f, 3.08f
+	};
+
+	// The same pin seen from the other side of the lane
+	constexpr int32 MirrorPins[FBowlingPinfallModel::NumPins] = {0, 2, 1, 5, 4, 3, 9, 8, 7, 6};
+
+	// Pins can only knock each other over one row further back at a time
+	constexpr auto MaxPasses = 4;
+
+	float Logistic(float Logit)
+	{
+		return 1.0f / (1.0f + FMath::Exp(-Logit));
+	}
+}
+
+FBowlingPinfallModel::FBowlingPinfallModel()
+{
+	for (auto& PinWeights : Weights)
+	{
+		PinWeights[Bias] = -4.0f;
+		PinWeights[Contact] = 7.0f;
+		PinWeights[Pocket] = 2.0f;
+		PinWeights[Speed] = 0.0f;
+		PinWeights[Revs] = 0.5f;
+		PinWeights[Neighbours] = 5.0f;
+	}
+}
+
+uint16 FBowlingPinfallModel::Simulate(const FBowlingDelivery& Delivery, uint16 Standing, FRandomStream& Random) const
+{
+	const auto RightStanding = Delivery.bLeftHanded ? Mirror(Standing) : Standing;
+
+	float Features[NumPins][NumFeatures];
+	GetDeliveryFeatures(Delivery, Features);
+
+	// Everything but the neighbours only has to be weighed once
+	float Logits[NumPins];
+	for (auto Pin = 0; Pin < NumPins; Pin++)
+	{
+		Logits[Pin] = 0.0f;
+		for (auto Feature = 0; Feature < Neighbours; Feature++)
+		{
+			Logits[Pin] += Weights[Pin][Feature] * Features[Pin][Feature];
+		}
+	}
+
+	// The ball knocks over what it hits first, then pins left standing get another chance each time more of their
+	// neighbours fall. Only the extra chance the new neighbours give is rolled for, so a pin's chance of falling over
+	// the whole shot is the same as its probability with the neighbours it finally has.
+	float Chances[NumPins] = {};
+	uint16 PinsDown = 0;
+	for (auto Pass = 0; Pass < MaxPasses; Pass++)
+	{
+		auto NextPinsDown = PinsDown;
+		for (auto Pin = 0; Pin < NumPins; Pin++)
+		{
+			if ((RightStanding & ~PinsDown & (1 << Pin)) == 0) { continue; }
+
+			const auto Chance = Logistic(Logits[Pin] + Weights[Pin][Neighbours] * GetNeighbours(Pin, PinsDown));
+			if (Chance <= Chances[Pin]) { continue; }
+
+			const auto ExtraChance = (Chance - Chances[Pin]) / (1.0f - Chances[Pin]);
+			Chances[Pin] = Chance;
+			if (Random.GetFraction() < ExtraChance) { NextPinsDown |= static_cast<uint16>(1 << Pin); }
+		}
+
+		if (NextPinsDown == PinsDown) { break; }
+		PinsDown = NextPinsDown;
+	}
+
+	return Delivery.bLeftHanded ? Mirror(PinsDown) : PinsDown;
+}
+
+bool FBowlingPinfallModel::Bowl(UBowlingScoreComponent& BowlingScoreComponent, const FBowlingDelivery& Delivery,
+                                FRandomStream& Random) const
+{
+	const auto Standing = BowlingScoreComponent.GetPinsStandingMask();
+	if (Standing == 0) { return false; }
+
+	return BowlingScoreComponent.SetPinMask(Simulate(Delivery, static_cast<uint16>(Standing), Random));
+}
+
+float FBowlingPinfallModel::GetFallProbability(const FBowlingDelivery& Delivery, int32 Pin, uint16 PinsDown) const
+{
+	if (Pin < 0 or Pin >= NumPins) { return 0.0f; }
+
+	if (Delivery.bLeftHanded)
+	{
+		Pin = MirrorPins[Pin];
+		PinsDown = Mirror(PinsDown);
+	}
+
+	float Features[NumPins][NumFeatures];
+	GetDeliveryFeatures(Delivery, Features);
+	Features[Pin][Neighbours] = GetNeighbours(Pin, PinsDown);
+
+	auto Logit = 0.0f;
+	for (auto Feature = 0; Feature < NumFeatures; Feature++)
+	{
+		Logit += Weights[Pin][Feature] * Features[Pin][Feature];
+	}
+	return Logistic(Logit);
+}
+
+double FBowlingPinfallModel::Fit(TConstArrayView<FBowlingRecordedShot> Shots, int32 Iterations, float LearningRate)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingPinfallModel::Fit);
+
+	// Weights are kept small so pins that always or never fall in the recording don't run off to infinity
+	constexpr auto Regularization = 0.001;
+
+	// Every standing pin in every shot is one example for that pin's weights, with the neighbours it ended up with
+	struct FExample
+	{
+		float Features[NumFeatures];
+		bool bFell;
+	};
+	TArray<FExample> Examples[NumPins];
+	for (const auto& Shot : Shots)
+	{
+		const auto Standing = Shot.Delivery.bLeftHanded ? Mirror(Shot.Standing) : Shot.Standing;
+		const auto ShotPinsDown = Shot.Delivery.bLeftHanded ? Mirror(Shot.PinsDown) : Shot.PinsDown;
+		const auto PinsDown = static_cast<uint16>(ShotPinsDown & Standing);
+
+		float Features[NumPins][NumFeatures];
+		GetDeliveryFeatures(Shot.Delivery, Features);
+		for (auto Pin = 0; Pin < NumPins; Pin++)
+		{
+			if ((Standing & (1 << Pin)) == 0) { continue; }
+
+			auto& Example = Examples[Pin].AddDefaulted_GetRef();
+			FMemory::Memcpy(Example.Features, Features[Pin], sizeof(Example.Features));
+			Example.Features[Neighbours] = GetNeighbours(Pin, PinsDown);
+			Example.bFell = (PinsDown & (1 << Pin)) != 0;
+		}
+	}
+
+	// Plain gradient descent on each pin's log loss, the features are all around the same scale
+	for (auto Pin = 0; Pin < NumPins; Pin++)
+	{
+		const auto& PinExamples = Examples[Pin];
+		if (PinExamples.IsEmpty()) { continue; }
+
+		for (auto Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			double Gradient[NumFeatures] = {};
+			for (const auto& Example : PinExamples)
+			{
+				auto Logit = 0.0f;
+				for (auto Feature = 0; Feature < NumFeatures; Feature++)
+				{
+					Logit += Weights[Pin][Feature] * Example.Features[Feature];
+				}
+				const auto Error = Logistic(Logit) - (Example.bFell ? 1.0f : 0.0f);
+				for (auto Feature = 0; Feature < NumFeatures; Feature++)
+				{
+					Gradient[Feature] += Error * Example.Features[Feature];
+				}
+			}
+
+			for (auto Feature = 0; Feature < NumFeatures; Feature++)
+			{
+				auto Step = Gradient[Feature] / PinExamples.Num();
+				if (Feature != Bias) { Step += Regularization * Weights[Pin][Feature]; }
+				Weights[Pin][Feature] -= static_cast<float>(LearningRate * Step);
+			}
+		}
+	}
+
+	return GetLogLoss(Shots);
+}
+
+double FBowlingPinfallModel::GetLogLoss(TConstArrayView<FBowlingRecordedShot> Shots) const
+{
+	auto Loss = 0.0;
+	auto NumExamples = 0;
+	for (const auto& Shot : Shots)
+	{
+		for (auto Pin = 0; Pin < NumPins; Pin++)
+		{
+			if ((Shot.Standing & (1 << Pin)) == 0) { continue; }
+
+			const auto PinsDown = static_cast<uint16>(Shot.PinsDown & Shot.Standing);
+			const auto Chance = FMath::Clamp(GetFallProbability(Shot.Delivery, Pin, PinsDown), 1e-6f, 1.0f - 1e-6f);
+			Loss -= FMath::Loge((PinsDown & (1 << Pin)) != 0 ? Chance : 1.0f - Chance);
+			NumExamples++;
+		}
+	}
+	return NumExamples > 0 ? Loss / NumExamples : 0.0;
+}
+
+FString FBowlingPinfallModel::SaveToString() const
+{
+	FString Text = TEXT("# Pin Bias Contact Pocket Speed Revs Neighbours\n");
+	for (auto Pin = 0; Pin < NumPins; Pin++)
+	{
+		Text += FString::Printf(TEXT("%d"), Pin + 1);
+		for (const auto Weight : Weights[Pin])
+		{
+			Text += FString::Printf(TEXT(" %.6f"), Weight);
+		}
+		Text += TEXT("\n");
+	}
+	return Text;
+}
+
+bool FBowlingPinfallModel::LoadFromString(const FString& Text)
+{
+	TArray<FString> Lines;
+	Text.ParseIntoArrayLines(Lines);
+
+	// Only replace the weights once every pin has been read
+	float NewWeights[NumPins][NumFeatures];
+	auto PinsRead = 0;
+	for (const auto& Line : Lines)
+	{
+		if (Line.IsEmpty() or Line.StartsWith(TEXT("#"))) { continue; }
+
+		TArray<FString> Values;
+		Line.ParseIntoArrayWS(Values);
+		const auto Pin = Values.IsEmpty() ? 0 : FCString::Atoi(*Values[0]);
+		if (Values.Num() != NumFeatures + 1 or Pin < 1 or Pin > NumPins)
+		{
+			UE_LOG(LogBowling, Warning, TEXT("Bad pinfall model weights: %s"), *Line);
+			return false;
+		}
+
+		for (auto Feature = 0; Feature < NumFeatures; Feature++)
+		{
+			NewWeights[Pin - 1][Feature] = FCString::Atof(*Values[Feature + 1]);
+		}
+		PinsRead |= 1 << (Pin - 1);
+	}
+
+	if (PinsRead != (1 << NumPins) - 1)
+	{
+		UE_LOG(LogBowling, Warning, TEXT("Pinfall model weights are missing pins"));
+		return false;
+	}
+
+	FMemory::Memcpy(Weights, NewWeights, sizeof(Weights));
+	return true;
+}
+
+void FBowlingPinfallModel::GetDeliveryFeatures(const FBowlingDelivery& Delivery, float OutFeatures[NumPins][NumFeatures])
+{
+	// Boards the ball drifts across per row as it carries on at its entry angle
+	const auto Drift = FMath::Tan(FMath::DegreesToRadians(Delivery.EntryAngle)) * RowSpacing / BoardWidth;
+	const auto PocketHit = FMath::Exp(-FMath::Square((Delivery.Board - PocketBoard) / 2.5f))
+		* FMath::Exp(-FMath::Square((Delivery.EntryAngle - PocketAngle) / 2.0f));
+
+	for (auto Pin = 0; Pin < NumPins; Pin++)
+	{
+		const auto BallBoard = Delivery.Board + Drift * PinRows[Pin];
+		OutFeatures[Pin][Bias] = 1.0f;
+		OutFeatures[Pin][Contact] = FMath::Exp(-FMath::Square((BallBoard - PinBoards[Pin]) / ContactBoards));
+		OutFeatures[Pin][Pocket] = PocketHit;
+		OutFeatures[Pin][Speed] = (Delivery.Speed - 17.0f) / 3.0f;
+		OutFeatures[Pin][Revs] = (Delivery.RevRate - 300.0f) / 150.0f;
+		OutFeatures[Pin][Neighbours] = 0.0f;
+	}
+}
+
+float FBowlingPinfallModel::GetNeighbours(int32 Pin, uint16 PinsDown)
+{
+	const auto Adjacent = FBowlingFrameScore::AdjacentPins[Pin];
+	return static_cast<float>(FMath::CountBits(Adjacent & PinsDown)) / FMath::CountBits(Adjacent);
+}
+
+uint16 FBowlingPinfallModel::Mirror(uint16 Pins)
+{
+	uint16 Mirrored = 0;
+	for (auto Pin = 0; Pin < NumPins; Pin++)
+	{
+		if (Pins & (1 << Pin)) { Mirrored |= static_cast<uint16>(1 << MirrorPins[Pin]); }
+	}
+	return Mirrored;
+}
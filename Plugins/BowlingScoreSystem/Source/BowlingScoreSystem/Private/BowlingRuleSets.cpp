@@ -0,0 +1,37 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingRuleSets.h"
+
+namespace
+{
+	template <typename TRules>
+	const FBowlingRuleSet& GetSharedRuleSet()
+	{
+		static constexpr auto RuleSet = FBowlingRuleSet::Make<TRules>();
+		return RuleSet;
+	}
+}
+
+template <>
+const FBowlingRuleSet& FBowlingRuleSet::Get<FTenPinRules>()
+{
+	return GetSharedRuleSet<FTenPinRules>();
+}
+
+template <>
+const FBowlingRuleSet& FBowlingRuleSet::Get<FNinePinRules>()
+{
+	return GetSharedRuleSet<FNinePinRules>();
+}
+
+template <>
+const FBowlingRuleSet& FBowlingRuleSet::Get<FFivePinRules>()
+{
+	return GetSharedRuleSet<FFivePinRules>();
+}
+
+template <>
+const FBowlingRuleSet& FBowlingRuleSet::Get<FCandlepinRules>()
+{
+	return GetSharedRuleSet<FCandlepinRules>();
+}
@@ -1,44 +1,88 @@
 ﻿// Partly Atomic LLC 2025
 #include "BowlingScoreComponent.h"
 
-FBowlingFrameScore::FBowlingFrameScore()
-{
-	Shots.SetNum(3);
-}
+#include "BowlingLatencyTracker.h"
+#include "BowlingMemory.h"
+#include "BowlingScoringWorker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
-FBowlingFrameScore::FBowlingFrameScore(int32 Shot1, int32 Shot2) : FBowlingFrameScore()
+namespace
 {
-	Shots = {Shot1, Shot2};
-}
-
-FBowlingFrameScore::FBowlingFrameScore(int32 Shot1, int32 Shot2, int32 Shot3) : FBowlingFrameScore()
-{
-	Shots = {Shot1, Shot2, Shot3};
+	// Game thread only, like the components themselves
+	uint64 GLatestStateVersion = 0;
 }
 
 UBowlingScoreComponent::UBowlingScoreComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
-	Reset();
+
+	// Start on Frame 1 Shot 1 without a full Reset, nothing can be listening yet
+	CurrentFrameIndex = 0;
+	CurrentShotIndex = 0;
+	RuleSet = &FBowlingRuleSet::Get<FTenPinRules>();
+	InitializeFrames();
 }
 
 void UBowlingScoreComponent::Reset()
 {
+	if (ScoringWorker)
+	{
+		ScoringWorker->PushReset(ScoringLaneId);
+		return;
+	}
+
+	ResetGame();
+}
+
+void UBowlingScoreComponent::ResetGame()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreComponent::ResetGame);
+	LLM_SCOPE_BYTAG(Bowling_Games);
+
 	// Reset shot and frame
 	CurrentFrameIndex = 0;
 	CurrentShotIndex = 0;
 
+	// Nothing is waiting to show up any more
+	ShotArrivalCycles = 0;
+
 	// Reset frames
-	FrameScores.Reset(10);
-	FrameScores.SetNum(10);
-	for (auto FrameIdx = 0; FrameIdx < 10; FrameIdx++)
-	{
-		FrameScores[FrameIdx].Shots.SetNum(FrameIdx == 9 ? 3 : 2);
-	}
+	InitializeFrames();
 
 	// Broadcast reset and advance to first shot
 	OnReset.Broadcast(this);
 	OnGameAdvanced.Broadcast(this, GetCurrentFrameNum(), GetCurrentShotNum());
+	OnGameStateChanged.Broadcast(this);
+}
+
+void UBowlingScoreComponent::SetScoringWorker(UBowlingScoringWorker* InScoringWorker, int32 InLaneId)
+{
+	if (ScoringWorker)
+	{
+		ScoringWorker->OnLaneUpdated.RemoveDynamic(this, &UBowlingScoreComponent::ScoringLaneUpdated);
+	}
+
+	ScoringWorker = InScoringWorker;
+	ScoringLaneId = InLaneId;
+	ScoringLaneVersion = 0;
+	if (not ScoringWorker) { return; }
+
+	ScoringWorker->OnLaneUpdated.AddUniqueDynamic(this, &UBowlingScoreComponent::ScoringLaneUpdated);
+
+	// The worker's game is the one that counts, a worker that isn't running yet starts it over
+	if (const auto* Published = ScoringWorker->GetSnapshot(ScoringLaneId))
+	{
+		ScoringLaneUpdated(ScoringLaneId, *Published);
+	}
+	else
+	{
+		ResetGame();
+	}
+}
+
+const FBowlingScoreSnapshot* UBowlingScoreComponent::GetPublishedSnapshot() const
+{
+	return ScoringWorker ? ScoringWorker->GetSnapshot(ScoringLaneId) : nullptr;
 }
 
 int32 UBowlingScoreComponent::GetCurrentFrameNum() const
@@ -53,16 +97,77 @@ int32 UBowlingScoreComponent::GetCurrentShotNum() const
 	return CurrentShotIndex + 1;
 }
 
+int32 UBowlingScoreComponent::GetNumFrames() const
+{
+	return RuleSet->NumFrames;
+}
+
+int32 UBowlingScoreComponent::GetNumPins() const
+{
+	return RuleSet->NumPins;
+}
+
+int32 UBowlingScoreComponent::GetNumShots(int32 Frame) const
+{
+	if (not FrameScores.IsValidIndex(Frame - 1)) { return 0; }
+	return RuleSet->GetNumShots(Frame - 1);
+}
+
+int32 UBowlingScoreComponent::GetPinsStanding() const
+{
+	if (IsGameOver()) { return 0; }
+	return RuleSet->GetRack(FrameScores[CurrentFrameIndex], CurrentShotIndex).Standing;
+}
+
+int32 UBowlingScoreComponent::GetRackBallNum() const
+{
+	if (IsGameOver()) { return -1; }
+	return RuleSet->GetRack(FrameScores[CurrentFrameIndex], CurrentShotIndex).Ball + 1;
+}
+
 int32 UBowlingScoreComponent::GetScore(int32 Frame) const
 {
-	auto Score = 0;
+	return RuleSet->GetScore(FrameScores, Frame - 1);
+}
 
-	for (auto CurrentFrame = 1; CurrentFrame <= Frame; CurrentFrame++)
-	{
-		Score += GetFrameScore(CurrentFrame);
-	}
+int32 UBowlingScoreComponent::GetScoreAt(int32 ShotIndex, int32 Frame) const
+{
+	if (ShotIndex < 0 or ShotIndex > GetNumShotsRecorded() or Frame < 1) { return 0; }
+
+	const auto NumFrames = RuleSet->NumFrames;
+	return ScoreHistory[ShotIndex * NumFrames + FMath::Min(Frame, NumFrames) - 1];
+}
+
+bool UBowlingScoreComponent::GetCursorAt(int32 ShotIndex, int32& OutFrame, int32& OutShot) const
+{
+	if (not CursorHistory.IsValidIndex(ShotIndex)) { return false; }
+
+	const auto [FrameIdx, ShotIdx] = CursorHistory[ShotIndex];
+	const auto bGameOver = FrameIdx >= RuleSet->NumFrames;
+	OutFrame = bGameOver ? -1 : FrameIdx + 1;
+	OutShot = bGameOver ? -1 : ShotIdx + 1;
+	return true;
+}
 
-	return Score;
+int32 UBowlingScoreComponent::GetNumShotsRecorded() const
+{
+	return CursorHistory.Num() - 1;
+}
+
+uint64 UBowlingScoreComponent::GetFrameVersion(int32 Frame) const
+{
+	if (not FrameVersions.IsValidIndex(Frame - 1)) { return 0; }
+	return FrameVersions[Frame - 1];
+}
+
+uint64 UBowlingScoreComponent::GetLatestStateVersion()
+{
+	return GLatestStateVersion;
+}
+
+uint64 UBowlingScoreComponent::AdvanceStateVersion()
+{
+	return ++GLatestStateVersion;
 }
 
 int32 UBowlingScoreComponent::GetShotScore(int32 Frame, int32 Shot) const
@@ -79,100 +184,68 @@ int32 UBowlingScoreComponent::GetShotScore(int32 Frame, int32 Shot) const
 
 int32 UBowlingScoreComponent::GetFrameScore(int32 Frame) const
 {
-	auto FrameIdx = Frame - 1;
-	auto& CurrentFrame = FrameScores[FrameIdx];
-	auto Score = 0;
-	for (auto&& ShotScore : CurrentFrame.Shots)
-	{
-		Score += ShotScore;
-	}
-
-	// For once Frame 10 makes things easier
-	if (Frame == 10)
-	{
-		return Score;
-	}
-	
-	auto ShotsToSum = 0;
-	if (IsStrike(Frame, 1))
-	{
-		// Add the score of the next two shots for a strike
-		ShotsToSum = 2;
-	}
-	else if (IsSpare(Frame, 2))
-	{
-		// Add the score of the next one shot for a spare
-		ShotsToSum = 1;
-	}
+	return RuleSet->GetFrameScore(FrameScores, Frame - 1);
+}
 
-	// Sum up extra scores as necessary
-	if (ShotsToSum > 0)
-	{
-		TPair<int32, int32> NextShotPair = GetNextScoredShot(Frame, 2);
-		for (auto i = 0; i < ShotsToSum; i++)
-		{
-			auto& NextFrame = NextShotPair.Get<0>();
-			auto& NextShot = NextShotPair.Get<1>();
-			Score += GetShotScore(NextFrame, NextShot);
-			NextShotPair = GetNextScoredShot(NextFrame, NextShot);
-		}
-	}
+int32 UBowlingScoreComponent::GetMaxPossibleScore() const
+{
+	return RuleSet->GetMaxPossibleScore(FrameScores, CurrentFrameIndex, CurrentShotIndex);
+}
 
-	return Score;
+void UBowlingScoreComponent::GetSnapshot(FBowlingScoreSnapshot& OutSnapshot) const
+{
+	OutSnapshot = GetCachedSnapshot();
 }
 
-bool UBowlingScoreComponent::IsValidShotScore(int32 Score, int32 Frame, int32 Shot) const
+const FBowlingScoreSnapshot& UBowlingScoreComponent::GetCachedSnapshot() const
 {
-	auto FrameIdx = Frame - 1;
-	auto ShotIdx = Shot - 1;
-	
-	// Number of pins must be between 0 and 10
-	if (Score < 0 or Score > 10)
-	{
-		return false;
-	}
+	if (Snapshot.StateVersion == static_cast<int64>(StateVersion)) { return Snapshot; }
 
-	if (not FrameScores.IsValidIndex(FrameIdx)) { return false; }
-	auto& CurrentFrame = FrameScores[FrameIdx];
-	if (not CurrentFrame.Shots.IsValidIndex(ShotIdx)) { return false; }
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreComponent::GetCachedSnapshot);
+	LLM_SCOPE_BYTAG(Bowling_Games);
 
-	if (Frame <= 9)
-	{
-		// Frames 1-9 only have two shots
-		if (Shot < 1 or Shot > 2) { return false; }
+	const auto NumFrames = RuleSet->NumFrames;
+	const auto NumShotsRecorded = GetNumShotsRecorded();
 
-		// Don't allow shot values that would conflict with existing shots in the frame
-		if (Shot == 2 and (Score + CurrentFrame.Shots[0] > 10 or CurrentFrame.Shots[0] == 10)) { return false; }
-	}
-	else if (Frame == 10)
+	// Cumulative scores are already worked out in the history
+	const auto* Scores = &ScoreHistory[NumShotsRecorded * NumFrames];
+
+	Snapshot.Frames.SetNum(NumFrames);
+	for (auto FrameIdx = 0; FrameIdx < NumFrames; FrameIdx++)
 	{
-		// Possible frame 10 states:
-		// XXX, XXN, XNN, XN/
-		// N/X, N/N
-		// NN
-		
-		// Frame 10 only has max three shots
-		if (Shot < 1 or Shot > 3) { return false; }
-
-		// If Shot 1 was not a strike, then Shot 2 can only be up to a spare
-		if (Shot == 2 and CurrentFrame.Shots[0] != 10 and (Score + CurrentFrame.Shots[0] > 10)) { return false; }
-
-		// Thought: This might be covered by the previous rule..
-		// Ten pins on shot 2 means Shot 1 must be a strike or 0
-		// if (Shot == 2 and Score == 10 and not (CurrentFrame.Shots[0] == 10 or CurrentFrame.Shots[0] == 0)) { return false; }
-
-		// Three shots are only allowed if the first shot of Frame 10 was a strike or the second shot was a spare
-		if (Shot == 3 and not(CurrentFrame.Shots[0] == 10 or CurrentFrame.Shots[0] + CurrentFrame.Shots[1] == 10))
-		{
-			return false;
-		}
+		auto& Frame = Snapshot.Frames[FrameIdx];
+		const auto& Shots = FrameScores[FrameIdx].Shots;
+		Frame.Shots.Reset();
+		Frame.Shots.Append(Shots);
+		Frame.Marks.Init(EBowlingShotMark::None, Shots.Num());
+		Frame.NumShotsThrown = 0;
+		Frame.Score = Scores[FrameIdx];
+		Frame.FrameScore = Frame.Score - (FrameIdx > 0 ? Scores[FrameIdx - 1] : 0);
+	}
 
-		// If Shot 1 was a strike and Shot 2 wasn't (so the pins weren't reset for Shot 3), then Shot 3 can only be up to a spare
-		if (Shot == 3 and CurrentFrame.Shots[0] == 10
-			and CurrentFrame.Shots[1] != 10 and (Score + CurrentFrame.Shots[1]> 10)) { return false; }
+	// Shots are thrown in order, so the cursor of every recorded shot says which ones have been
+	for (auto ShotIndex = 0; ShotIndex < NumShotsRecorded; ShotIndex++)
+	{
+		const auto [FrameIdx, ShotIdx] = CursorHistory[ShotIndex];
+		auto& Frame = Snapshot.Frames[FrameIdx];
+		Frame.NumShotsThrown++;
+		Frame.Marks[ShotIdx] = RuleSet->IsStrike(FrameScores, FrameIdx, ShotIdx)
+			? EBowlingShotMark::Strike
+			: RuleSet->IsSpare(FrameScores, FrameIdx, ShotIdx) ? EBowlingShotMark::Spare : EBowlingShotMark::Open;
 	}
 
-	return true;
+	Snapshot.bGameOver = IsGameOver();
+	Snapshot.CurrentFrame = GetCurrentFrameNum();
+	Snapshot.CurrentShot = GetCurrentShotNum();
+	Snapshot.Score = Scores[NumFrames - 1];
+	Snapshot.MaxPossibleScore = GetMaxPossibleScore();
+	Snapshot.StateVersion = static_cast<int64>(StateVersion);
+	return Snapshot;
+}
+
+bool UBowlingScoreComponent::IsValidShotScore(int32 Score, int32 Frame, int32 Shot) const
+{
+	return RuleSet->IsValidShotScore(FrameScores, Score, Frame - 1, Shot - 1);
 }
 
 bool UBowlingScoreComponent::IsValidShotScore(int32 Score) const
@@ -185,8 +258,35 @@ bool UBowlingScoreComponent::SetScore(int32 Score)
 	return SetScore(Score, GetCurrentFrameNum(), GetCurrentShotNum());
 }
 
-bool UBowlingScoreComponent::SetScore(int32 Score, int32 Frame, int32 Shot)
+bool UBowlingScoreComponent::IsValidPinMask(int32 PinMask) const
+{
+	if (IsGameOver() or PinMask < 0 or PinMask > FBowlingFrameScore::FullPinMask) { return false; }
+	return RuleSet->IsValidPinMask(FrameScores, static_cast<uint16>(PinMask), CurrentFrameIndex, CurrentShotIndex);
+}
+
+bool UBowlingScoreComponent::SetPinMask(int32 PinMask)
 {
+	if (not IsValidPinMask(PinMask)) { return false; }
+	return SetScore(static_cast<int32>(FMath::CountBits(PinMask)), GetCurrentFrameNum(), GetCurrentShotNum(), static_cast<uint16>(PinMask));
+}
+
+int32 UBowlingScoreComponent::GetPinMask(int32 Frame, int32 Shot) const
+{
+	if (not FrameScores.IsValidIndex(Frame - 1) or not FrameScores[Frame - 1].Shots.IsValidIndex(Shot - 1)) { return 0; }
+	return FrameScores[Frame - 1].GetPinMask(Shot - 1);
+}
+
+int32 UBowlingScoreComponent::GetPinsStandingMask() const
+{
+	if (IsGameOver()) { return 0; }
+	return RuleSet->GetStandingMask(FrameScores[CurrentFrameIndex], CurrentShotIndex);
+}
+
+bool UBowlingScoreComponent::SetScore(int32 Score, int32 Frame, int32 Shot, uint16 PinMask)
+{
+	const auto ArrivalCycles = FPlatformTime::Cycles64();
+	LLM_SCOPE_BYTAG(Bowling_Games);
+
 	auto FrameIdx = Frame - 1;
 	auto ShotIdx = Shot - 1;
 
@@ -203,165 +303,234 @@ bool UBowlingScoreComponent::SetScore(int32 Score, int32 Frame, int32 Shot)
 		return false;
 	}
 
+	// Checked against the game as last published so a bad entry is turned away at once, the worker checks it again.
+	// It only takes pinfall, so the pins aren't kept.
+	if (ScoringWorker)
+	{
+		if (not ScoringWorker->PushShot(ScoringLaneId, Score)) { return false; }
+		ShotArrivalCycles = ArrivalCycles;
+		return true;
+	}
+
 	// Record the score
 	FrameScores[FrameIdx].Shots[ShotIdx] = Score;
-
-	auto IsGameOver = false;
+	FrameScores[FrameIdx].SetPinMask(ShotIdx, PinMask);
+	ShotArrivalCycles = ArrivalCycles;
 
 	// Advance shot and frame as necessary
-	if (Frame < 10)
+	RuleSet->Advance(FrameScores, CurrentFrameIndex, CurrentShotIndex);
+
+	RecordHistory();
+	UpdateVersions(FrameIdx);
+	BroadcastShot(Frame, Shot, Score);
+	return true;
+}
+
+void UBowlingScoreComponent::BroadcastShot(int32 Frame, int32 Shot, int32 Score)
+{
+	auto& LatencyTracker = FBowlingLatencyTracker::Get();
+	LatencyTracker.Record(*this, EBowlingLatencyStage::Recorded);
+
+	OnShotRecorded.Broadcast(this, Frame, Shot, Score);
+	OnScoreChanged.Broadcast(this, Frame);
+
+	if (IsGameOver())
 	{
-		if (Shot == 1)
+		OnGameOver.Broadcast(this);
+	}
+	else
+	{
+		OnGameAdvanced.Broadcast(this, GetCurrentFrameNum(), GetCurrentShotNum());
+	}
+	OnGameStateChanged.Broadcast(this);
+
+	LatencyTracker.Record(*this, EBowlingLatencyStage::Broadcast);
+}
+
+void UBowlingScoreComponent::ScoringLaneUpdated(int32 LaneId, const FBowlingScoreSnapshot& Published)
+{
+	if (LaneId != ScoringLaneId) { return; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreComponent::ScoringLaneUpdated);
+	LLM_SCOPE_BYTAG(Bowling_Games);
+
+	// Frame and shot indices of every shot thrown after the ones recorded here, in the order they were thrown
+	TArray<TPair<int32, int32>, TInlineAllocator<24>> NewShots;
+	const auto GatherNewShots = [this, &Published, &NewShots]
+	{
+		NewShots.Reset();
+		for (auto FrameIdx = CurrentFrameIndex; FrameIdx < Published.Frames.Num(); FrameIdx++)
 		{
-			if (Score == 10)
-			{
-				// A strike will advance frame
-				CurrentShotIndex = ShotIdx;
-				CurrentFrameIndex = FrameIdx + 1;
-			}
-			else
+			const auto FirstShotIdx = FrameIdx == CurrentFrameIndex ? CurrentShotIndex : 0;
+			for (auto ShotIdx = FirstShotIdx; ShotIdx < Published.Frames[FrameIdx].NumShotsThrown; ShotIdx++)
 			{
-				// Everything else will advance to the next shot
-				CurrentShotIndex = ShotIdx + 1;
-				CurrentFrameIndex = FrameIdx;
+				NewShots.Emplace(FrameIdx, ShotIdx);
 			}
 		}
-		else if (Shot == 2)
-		{
-			// Shot 2 on frames other than 10 advances to the next frame
-			CurrentShotIndex = 0;
-			CurrentFrameIndex = FrameIdx + 1;
-		}
+	};
+	GatherNewShots();
+
+	// Any more changes than new shots means the game was reset in between, so every shot since is new
+	if (Published.StateVersion - ScoringLaneVersion != NewShots.Num())
+	{
+		ResetGame();
+		GatherNewShots();
 	}
-	else if (Frame == 10)
+	ScoringLaneVersion = Published.StateVersion;
+
+	for (auto Idx = 0; Idx < NewShots.Num(); Idx++)
 	{
-		if (Shot == 1)
+		const auto [FrameIdx, ShotIdx] = NewShots[Idx];
+		const auto Score = Published.Frames[FrameIdx].Shots[ShotIdx];
+		FrameScores[FrameIdx].Shots[ShotIdx] = Score;
+		FrameScores[FrameIdx].SetPinMask(ShotIdx, 0);
+
+		if (Idx + 1 < NewShots.Num())
 		{
-			// Shot 1 always advances to the next shot
-			CurrentShotIndex = ShotIdx + 1;
-			CurrentFrameIndex = FrameIdx;
+			// Shots published together only have the last one's scoresheet, the ones before it are worked out here
+			CurrentFrameIndex = NewShots[Idx + 1].Key;
+			CurrentShotIndex = NewShots[Idx + 1].Value;
+			RecordHistory();
 		}
-		if (Shot == 2)
+		else
 		{
-			if (IsStrike(10, 1) or IsSpare(10, 2))
-			{
-				// Third shot is only allowed if there's a Strike on Shot 1 or Spare on Shot 2
-				CurrentShotIndex = ShotIdx + 1;
-				CurrentFrameIndex = FrameIdx;
-			}
-			else
+			CurrentFrameIndex = Published.bGameOver ? RuleSet->NumFrames : Published.CurrentFrame - 1;
+			CurrentShotIndex = Published.bGameOver ? 0 : Published.CurrentShot - 1;
+			for (const auto& Frame : Published.Frames)
 			{
-				// Otherwise it's game over
-				CurrentFrameIndex = FrameIdx + 1;
-				CurrentShotIndex = 0;
-				IsGameOver = true;
+				ScoreHistory.Add(static_cast<uint16>(Frame.Score));
 			}
+			CursorHistory.Emplace(static_cast<uint8>(CurrentFrameIndex), static_cast<uint8>(CurrentShotIndex));
 		}
-		else if (Shot == 3)
-		{
-			// Third shot is always a game over
-			CurrentFrameIndex = FrameIdx + 1;
-			CurrentShotIndex = 0;
-			IsGameOver = true;
-		}
-	}
 
-	if (IsGameOver)
-	{
-		OnGameOver.Broadcast(this);
-	}
-	else
-	{
-		OnGameAdvanced.Broadcast(this, GetCurrentFrameNum(), GetCurrentShotNum());
+		UpdateVersions(FrameIdx);
+		BroadcastShot(FrameIdx + 1, ShotIdx + 1, Score);
 	}
-	return true;
 }
 
 bool UBowlingScoreComponent::IsSpare(int32 Frame, int32 Shot) const
 {
-	auto FrameIdx = Frame - 1;
-	auto ShotIdx = Shot - 1;
+	return RuleSet->IsSpare(FrameScores, Frame - 1, Shot - 1);
+}
 
-	if (not FrameScores.IsValidIndex(FrameIdx)) { return false; }
-	auto& CurrentFrame = FrameScores[FrameIdx];
-	if (not CurrentFrame.Shots.IsValidIndex(ShotIdx)) { return false; }
+bool UBowlingScoreComponent::IsStrike(int32 Frame, int32 Shot) const
+{
+	return RuleSet->IsStrike(FrameScores, Frame - 1, Shot - 1);
+}
 
-	// First shot can't be a spare
-	if (Shot == 1) { return false; }
+bool UBowlingScoreComponent::IsGameOver() const
+{
+	return CurrentFrameIndex < 0 or CurrentFrameIndex >= RuleSet->NumFrames;
+}
 
-	// Frame 10 must have a first strike for shot 3 to be a spare (XN/)
-	if (Frame == 10 and Shot == 3 and CurrentFrame.Shots[0] != 10) { return false; }
+bool UBowlingScoreComponent::HasStarted() const
+{
+	return CurrentFrameIndex != 0 or CurrentShotIndex != 0;
+}
 
-	// Previous shot must not have been a strike and all pins must have been knocked down over the two shots (so X0 isn't detected as X/)
-	if (CurrentFrame.Shots[ShotIdx - 1] < 10 and (CurrentFrame.Shots[ShotIdx - 1] + CurrentFrame.Shots[ShotIdx]) == 10)
+void UBowlingScoreComponent::InitializeFrames()
+{
+	LLM_SCOPE_BYTAG(Bowling_Games);
+
+	if (FrameScores.Num() != RuleSet->NumFrames)
 	{
-		return true;
+		FrameScores.SetNum(RuleSet->NumFrames);
+	}
+
+	for (auto FrameIdx = 0; FrameIdx < FrameScores.Num(); FrameIdx++)
+	{
+		// Shots live in the frame's inline storage, so resizing never allocates
+		auto& Shots = FrameScores[FrameIdx].Shots;
+		Shots.SetNum(RuleSet->GetNumShots(FrameIdx), EAllowShrinking::No);
+		FMemory::Memzero(Shots.GetData(), Shots.Num() * Shots.GetTypeSize());
+		FrameScores[FrameIdx].PinMasks = 0;
 	}
 
-	return false;
+	// Room for the longest possible game, so recording shots never allocates
+	auto MaxShots = 1;
+	for (auto FrameIdx = 0; FrameIdx < RuleSet->NumFrames; FrameIdx++)
+	{
+		MaxShots += RuleSet->GetNumShots(FrameIdx);
+	}
+	ScoreHistory.Reset(MaxShots * RuleSet->NumFrames);
+	CursorHistory.Reset(MaxShots);
+	RecordHistory();
+
+	// Every frame starts over
+	StateVersion = AdvanceStateVersion();
+	FrameVersions.SetNum(RuleSet->NumFrames, EAllowShrinking::No);
+	for (auto& FrameVersion : FrameVersions)
+	{
+		FrameVersion = StateVersion;
+	}
 }
 
-bool UBowlingScoreComponent::IsStrike(int32 Frame, int32 Shot) const
+void UBowlingScoreComponent::RecordHistory()
 {
-	auto FrameIdx = Frame - 1;
-	auto ShotIdx = Shot - 1;
-
-	if (not FrameScores.IsValidIndex(FrameIdx)) { return false; }
-	auto& CurrentFrame = FrameScores[FrameIdx];
-	if (not CurrentFrame.Shots.IsValidIndex(ShotIdx)) { return false; }
-
-	// If it's not all pins it can't be a strike
-	if (CurrentFrame.Shots[ShotIdx] != 10) { return false; }
+	auto Score = 0;
+	for (auto FrameIdx = 0; FrameIdx < RuleSet->NumFrames; FrameIdx++)
+	{
+		Score += RuleSet->GetFrameScore(FrameScores, FrameIdx);
+		ScoreHistory.Add(static_cast<uint16>(Score));
+	}
+	CursorHistory.Emplace(static_cast<uint8>(CurrentFrameIndex), static_cast<uint8>(CurrentShotIndex));
+}
 
-	// Strike is always possible on the first shot of any frame
-	if (Shot == 1) { return true; }
+void UBowlingScoreComponent::UpdateVersions(int32 ShotFrameIdx)
+{
+	StateVersion = AdvanceStateVersion();
 
-	if (Frame == 10)
+	// Frame scores before and after the shot, from the last two scoresheets in the history
+	const auto NumFrames = RuleSet->NumFrames;
+	const auto* Before = &ScoreHistory[ScoreHistory.Num() - 2 * NumFrames];
+	const auto* After = Before + NumFrames;
+	for (auto FrameIdx = 0; FrameIdx < NumFrames; FrameIdx++)
 	{
-		// First shot must be a strike for the second shot to be a strike instead of a spare
-		if (Shot == 2 and CurrentFrame.Shots[0] == 10) { return true; }
-
-		// XXX and N/X are the two possibilities for a shot 3 strike on frame 10
-		// XXX case
-		if (Shot == 3 and CurrentFrame.Shots[0] == 10 and CurrentFrame.Shots[1] == 10) { return true; }
-		// N/X case, also make sure this isn't X0/
-		if (Shot == 3 and CurrentFrame.Shots[0] < 10 and CurrentFrame.Shots[0] + CurrentFrame.Shots[1] == 10)
+		const auto FrameBefore = Before[FrameIdx] - (FrameIdx > 0 ? Before[FrameIdx - 1] : 0);
+		const auto FrameAfter = After[FrameIdx] - (FrameIdx > 0 ? After[FrameIdx - 1] : 0);
+		if (FrameIdx == ShotFrameIdx or FrameBefore != FrameAfter)
 		{
-			return true;
+			FrameVersions[FrameIdx] = StateVersion;
 		}
 	}
-
-	return false;
 }
 
-bool UBowlingScoreComponent::IsGameOver() const
+SIZE_T UBowlingScoreComponent::GetAllocatedSize() const
 {
-	return CurrentFrameIndex < 0 or CurrentFrameIndex > 9;
+	auto Bytes = FrameScores.GetAllocatedSize() + Snapshot.Frames.GetAllocatedSize();
+	for (auto&& Frame : FrameScores)
+	{
+		Bytes += Frame.Shots.GetAllocatedSize();
+	}
+	for (auto&& Frame : Snapshot.Frames)
+	{
+		Bytes += Frame.Shots.GetAllocatedSize() + Frame.Marks.GetAllocatedSize();
+	}
+	return Bytes + ScoreHistory.GetAllocatedSize() + CursorHistory.GetAllocatedSize() + FrameVersions.GetAllocatedSize();
 }
 
-TPair<int32, int32> UBowlingScoreComponent::GetNextScoredShot(int32 Frame, int32 Shot) const
+void UBowlingScoreComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
 {
-	// Thankfully this will never touch frame 10 shot 3
-	auto FrameIdx = Frame - 1;
-	auto ShotIdx = Shot - 1;
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(GetAllocatedSize());
+}
 
-	auto NextShot = (ShotIdx + 1) % 2 + 1;
-	auto NextFrame = FrameIdx + (ShotIdx + 1) / 2 + 1;
+void UBowlingScoreComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+	Super::OnComponentDestroyed(bDestroyingHierarchy);
 
-	TPair<int32, int32> PotentialNext = {NextFrame, NextShot};
+	SetScoringWorker(nullptr, 0);
 
-	// Unless it's frame 10, skip the shot after a strike...
-	if (NextFrame != 10 and NextShot == 2 and IsStrike(NextFrame, 1))
-	{
-		PotentialNext = GetNextScoredShot(NextFrame, NextShot);
-	}
+	// Anything waiting on the game stops waiting
+	bDestroyed = true;
+	OnGameStateChanged.Broadcast(this);
+	OnGameStateChanged.Clear();
 
-	return PotentialNext;
+	FBowlingLatencyTracker::Get().Remove(*this);
 }
 
-void UBowlingScoreComponent::InitializeComponent()
+void UBowlingScoreComponent::SetRuleSet(const FBowlingRuleSet& InRuleSet)
 {
-	Super::InitializeComponent();
-	
-	Reset();
+	RuleSet = &InRuleSet;
+	InitializeFrames();
 }
@@ -0,0 +1,329 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingScoreExporter.h"
+
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+	// Writes JSON text directly, nothing is built up before it's written
+	struct FBowlingJsonWriter
+	{
+		TArray<uint8>& Out;
+		bool bFirstItem = true;
+
+		void Raw(const ANSICHAR* Text)
+		{
+			Out.Append(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+		}
+
+		void Int(int64 Value)
+		{
+			if (Value < 0)
+			{
+				Out.Add('-');
+				Value = -Value;
+			}
+
+			uint8 Digits[20];
+			auto NumDigits = 0;
+			do
+			{
+				Digits[NumDigits++] = static_cast<uint8>('0' + Value % 10);
+				Value /= 10;
+			}
+			while (Value > 0);
+
+			while (NumDigits > 0)
+			{
+				Out.Add(Digits[--NumDigits]);
+			}
+		}
+
+		void Bool(bool bValue) { Raw(bValue ? "true" : "false"); }
+
+		// Separate items in a list
+		void Item()
+		{
+			if (not bFirstItem) { Out.Add(','); }
+			bFirstItem = false;
+		}
+
+		void Begin(uint64 Version)
+		{
+			Raw("{\"version\":");
+			Int(static_cast<int64>(Version));
+			Raw(",\"games\":[");
+		}
+
+		void BeginGame(int32 GameId, bool bFull, int32 Frame, int32 Shot, bool bOver, int32 Score)
+		{
+			Item();
+			Raw("{\"id\":");
+			Int(GameId);
+			Raw(",\"full\":");
+			Bool(bFull);
+			Raw(",\"frame\":");
+			Int(Frame);
+			Raw(",\"shot\":");
+			Int(Shot);
+			Raw(",\"over\":");
+			Bool(bOver);
+			Raw(",\"score\":");
+			Int(Score);
+			Raw(",\"frames\":[");
+			bFirstItem = true;
+		}
+
+		void Frame(int32 Frame, TConstArrayView<int32> Shots, int32 Score)
+		{
+			Item();
+			Raw("{\"frame\":");
+			Int(Frame);
+			Raw(",\"shots\":[");
+			for (auto ShotIdx = 0; ShotIdx < Shots.Num(); ShotIdx++)
+			{
+				if (ShotIdx > 0) { Out.Add(','); }
+				Int(Shots[ShotIdx]);
+			}
+			Raw("],\"score\":");
+			Int(Score);
+			Out.Add('}');
+		}
+
+		void EndGame()
+		{
+			Raw("]}");
+			bFirstItem = false;
+		}
+
+		void BeginRemoved()
+		{
+			Raw("],\"removed\":[");
+			bFirstItem = true;
+		}
+
+		void Removed(int32 GameId)
+		{
+			Item();
+			Int(GameId);
+		}
+
+		void End() { Raw("]}"); }
+	};
+
+	// Writes the binary form, going back to fill in counts once they're known
+	struct FBowlingBinaryWriter
+	{
+		TArray<uint8>& Out;
+		int32 NumGamesOffset = 0;
+		int32 NumFramesOffset = 0;
+		int32 NumRemovedOffset = 0;
+		int32 NumGames = 0;
+		int32 NumFrames = 0;
+		int32 NumRemoved = 0;
+
+		void Uint(uint64 Value, int32 Size)
+		{
+			for (auto Byte = 0; Byte < Size; Byte++)
+			{
+				Out.Add(static_cast<uint8>(Value >> (Byte * 8)));
+			}
+		}
+
+		void Patch(int32 Offset, uint64 Value, int32 Size)
+		{
+			for (auto Byte = 0; Byte < Size; Byte++)
+			{
+				Out[Offset + Byte] = static_cast<uint8>(Value >> (Byte * 8));
+			}
+		}
+
+		void Begin(uint64 Version)
+		{
+			Uint(Version, 8);
+			NumGamesOffset = Out.Num();
+			Uint(0, 2);
+		}
+
+		void BeginGame(int32 GameId, bool bFull, int32 Frame, int32 Shot, bool bOver, int32 Score)
+		{
+			NumGames++;
+			Uint(static_cast<uint32>(GameId), 4);
+			Uint((bFull ? 1 : 0) | (bOver ? 2 : 0), 1);
+			Uint(FMath::Max(Frame, 0), 1);
+			Uint(FMath::Max(Shot, 0), 1);
+			Uint(Score, 2);
+			NumFramesOffset = Out.Num();
+			NumFrames = 0;
+			Uint(0, 1);
+		}
+
+		void Frame(int32 Frame, TConstArrayView<int32> Shots, int32 Score)
+		{
+			NumFrames++;
+			Uint(Frame, 1);
+			Uint(Shots.Num(), 1);
+			for (auto ShotScore : Shots)
+			{
+				Uint(ShotScore, 1);
+			}
+			Uint(Score, 2);
+		}
+
+		void EndGame() { Patch(NumFramesOffset, NumFrames, 1); }
+
+		void BeginRemoved()
+		{
+			Patch(NumGamesOffset, NumGames, 2);
+			NumRemovedOffset = Out.Num();
+			Uint(0, 2);
+		}
+
+		void Removed(int32 GameId)
+		{
+			NumRemoved++;
+			Uint(static_cast<uint32>(GameId), 4);
+		}
+
+		void End() { Patch(NumRemovedOffset, NumRemoved, 2); }
+	};
+}
+
+void UBowlingScoreExporter::AddGame(int32 GameId, UBowlingScoreComponent* BowlingScoreComponent)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+
+	Games.Add(GameId, {BowlingScoreComponent, UBowlingScoreComponent::AdvanceStateVersion()});
+	RemovedGames.Remove(GameId);
+}
+
+void UBowlingScoreExporter::RemoveGame(int32 GameId)
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	// Nobody is left to tell once there are no consumers
+	if (Games.Remove(GameId) > 0 and Consumers.Num() > 0)
+	{
+		RemovedGames.Add(GameId, UBowlingScoreComponent::AdvanceStateVersion());
+	}
+}
+
+int32 UBowlingScoreExporter::AddConsumer()
+{
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+
+	const auto ConsumerId = NextConsumerId++;
+	Consumers.Add(ConsumerId, 0);
+	return ConsumerId;
+}
+
+void UBowlingScoreExporter::RemoveConsumer(int32 ConsumerId)
+{
+	if (Consumers.Remove(ConsumerId) > 0)
+	{
+		TrimRemovedGames();
+	}
+}
+
+uint64 UBowlingScoreExporter::ExportJson(int32 ConsumerId, TArray<uint8>& OutJson)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreExporter::ExportJson);
+
+	OutJson.Reset();
+	auto* Cursor = Consumers.Find(ConsumerId);
+	if (not ensureMsgf(Cursor, TEXT("Unknown export consumer %d"), ConsumerId)) { return 0; }
+
+	FBowlingJsonWriter Writer{OutJson};
+	const auto Version = Export(*Cursor, Writer);
+	AdvanceConsumer(*Cursor, Version);
+	return Version;
+}
+
+uint64 UBowlingScoreExporter::ExportBinary(int32 ConsumerId, TArray<uint8>& OutData)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreExporter::ExportBinary);
+
+	OutData.Reset();
+	auto* Cursor = Consumers.Find(ConsumerId);
+	if (not ensureMsgf(Cursor, TEXT("Unknown export consumer %d"), ConsumerId)) { return 0; }
+
+	FBowlingBinaryWriter Writer{OutData};
+	const auto Version = Export(*Cursor, Writer);
+	AdvanceConsumer(*Cursor, Version);
+	return Version;
+}
+
+void UBowlingScoreExporter::AdvanceConsumer(uint64& Cursor, uint64 Version)
+{
+	Cursor = Version;
+	if (RemovedGames.Num() > 0)
+	{
+		TrimRemovedGames();
+	}
+}
+
+void UBowlingScoreExporter::TrimRemovedGames()
+{
+	auto OldestCursor = MAX_uint64;
+	for (auto&& [ConsumerId, Cursor] : Consumers)
+	{
+		OldestCursor = FMath::Min(OldestCursor, Cursor);
+	}
+
+	for (auto It = RemovedGames.CreateIterator(); It; ++It)
+	{
+		if (It.Value() <= OldestCursor)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+template <typename TWriter>
+uint64 UBowlingScoreExporter::Export(uint64 SinceVersion, TWriter& Writer) const
+{
+	const auto Version = UBowlingScoreComponent::GetLatestStateVersion();
+	Writer.Begin(Version);
+
+	for (auto&& [GameId, Game] : Games)
+	{
+		const auto* BowlingScoreComponent = Game.BowlingScoreComponent.Get();
+		if (not BowlingScoreComponent) { continue; }
+
+		// Games new to the caller are sent whole, the rest only if something changed
+		const auto bFull = Game.AddedVersion > SinceVersion;
+		if (not bFull and BowlingScoreComponent->GetStateVersion() <= SinceVersion) { continue; }
+
+		const auto NumFrames = BowlingScoreComponent->GetNumFrames();
+		Writer.BeginGame(GameId, bFull, BowlingScoreComponent->GetCurrentFrameNum(),
+		                 BowlingScoreComponent->GetCurrentShotNum(), BowlingScoreComponent->IsGameOver(),
+		                 BowlingScoreComponent->GetScore(NumFrames));
+
+		const auto& Frames = BowlingScoreComponent->GetFrameScores();
+		for (auto Frame = 1; Frame <= NumFrames; Frame++)
+		{
+			if (bFull or BowlingScoreComponent->GetFrameVersion(Frame) > SinceVersion)
+			{
+				Writer.Frame(Frame, Frames[Frame - 1].Shots, BowlingScoreComponent->GetFrameScore(Frame));
+			}
+		}
+		Writer.EndGame();
+	}
+
+	Writer.BeginRemoved();
+	for (auto&& [GameId, RemovedVersion] : RemovedGames)
+	{
+		if (RemovedVersion > SinceVersion)
+		{
+			Writer.Removed(GameId);
+		}
+	}
+	Writer.End();
+
+	return Version;
+}
@@ -2,6 +2,8 @@
 
 #include "BowlingScoreSystem.h"
 
+DEFINE_LOG_CATEGORY(LogBowling);
+
 #define LOCTEXT_NAMESPACE "FBowlingScoreSystemModule"
 
 void FBowlingScoreSystemModule::StartupModule()
@@ -0,0 +1,192 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingScoreboardPublisher.h"
+
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreSystem.h"
+#include "BowlingSharedScoreboard.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+bool UBowlingScoreboardPublisher::Open(const FString& InName, int32 InNumSlots)
+{
+	Close();
+	if (not ensure(InNumSlots > 0)) { return false; }
+
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+	const auto Size = FBowlingSharedScoreboardHeader::GetRegionSize(InNumSlots);
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(InName, true,
+		FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write, Size);
+	if (not Region)
+	{
+		UE_LOG(LogBowling, Error, TEXT("Could not create scoreboard shared memory %s"), *InName);
+		return false;
+	}
+
+	// Readers that open it before it's ready see no magic and wait
+	auto* Header = GetHeader();
+	Header->Magic = 0;
+	std::atomic_thread_fence(std::memory_order_release);
+
+	FMemory::Memzero(Header->GetSlots(), Size - sizeof(FBowlingSharedScoreboardHeader));
+	Header->LayoutVersion = FBowlingSharedScoreboardHeader::ExpectedLayoutVersion;
+	Header->NumSlots = InNumSlots;
+	Header->SlotSize = sizeof(FBowlingSharedLaneSlot);
+	Header->PublishCount.store(0, std::memory_order_relaxed);
+
+	std::atomic_thread_fence(std::memory_order_release);
+	Header->Magic = FBowlingSharedScoreboardHeader::ExpectedMagic;
+
+	UsedSlots.Init(false, InNumSlots);
+
+	// Lanes added before opening take the first slots
+	for (auto& [LaneId, Lane] : Lanes)
+	{
+		Lane.Slot = UsedSlots.FindAndSetFirstZeroBit();
+		if (Lane.Slot != INDEX_NONE)
+		{
+			Publish(Lane.Slot, LaneId, Lane.BowlingScoreComponent.Get());
+		}
+	}
+	return true;
+}
+
+void UBowlingScoreboardPublisher::Close()
+{
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+	}
+
+	UsedSlots.Empty();
+	for (auto& [LaneId, Lane] : Lanes)
+	{
+		Lane.Slot = INDEX_NONE;
+	}
+}
+
+int32 UBowlingScoreboardPublisher::AddLane(int32 LaneId, UBowlingScoreComponent* BowlingScoreComponent)
+{
+	if (not ensure(IsValid(BowlingScoreComponent))) { return INDEX_NONE; }
+	if (not ensureMsgf(LaneId > 0, TEXT("Lane %d can't be published, slots use 0 for no lane"), LaneId))
+	{
+		return INDEX_NONE;
+	}
+
+	RemoveLane(LaneId);
+
+	auto& Lane = Lanes.Add(LaneId);
+	Lane.BowlingScoreComponent = BowlingScoreComponent;
+	LaneIds.Add(BowlingScoreComponent, LaneId);
+
+	BowlingScoreComponent->OnShotRecorded.AddUObject(this, &UBowlingScoreboardPublisher::ShotRecorded);
+	BowlingScoreComponent->OnReset.AddUniqueDynamic(this, &UBowlingScoreboardPublisher::GameReset);
+
+	if (IsOpen())
+	{
+		Lane.Slot = UsedSlots.FindAndSetFirstZeroBit();
+		if (Lane.Slot == INDEX_NONE)
+		{
+			UE_LOG(LogBowling, Warning, TEXT("No scoreboard slot left for lane %d"), LaneId);
+			return INDEX_NONE;
+		}
+		Publish(Lane.Slot, LaneId, BowlingScoreComponent);
+	}
+	return Lane.Slot;
+}
+
+void UBowlingScoreboardPublisher::RemoveLane(int32 LaneId)
+{
+	FPublishedLane Lane;
+	if (not Lanes.RemoveAndCopyValue(LaneId, Lane)) { return; }
+
+	auto* BowlingScoreComponent = Lane.BowlingScoreComponent.Get();
+	LaneIds.Remove(Lane.BowlingScoreComponent.GetEvenIfUnreachable());
+	if (IsValid(BowlingScoreComponent))
+	{
+		BowlingScoreComponent->OnShotRecorded.RemoveAll(this);
+		BowlingScoreComponent->OnReset.RemoveDynamic(this, &UBowlingScoreboardPublisher::GameReset);
+	}
+
+	if (IsOpen() and Lane.Slot != INDEX_NONE)
+	{
+		Publish(Lane.Slot, 0, nullptr);
+		UsedSlots[Lane.Slot] = false;
+	}
+}
+
+int32 UBowlingScoreboardPublisher::GetLaneSlot(int32 LaneId) const
+{
+	const auto* Lane = Lanes.Find(LaneId);
+	return Lane ? Lane->Slot : INDEX_NONE;
+}
+
+void UBowlingScoreboardPublisher::BeginDestroy()
+{
+	Close();
+
+	Super::BeginDestroy();
+}
+
+FBowlingSharedScoreboardHeader* UBowlingScoreboardPublisher::GetHeader() const
+{
+	return Region ? static_cast<FBowlingSharedScoreboardHeader*>(Region->GetAddress()) : nullptr;
+}
+
+void UBowlingScoreboardPublisher::Publish(int32 Slot, int32 LaneId, const UBowlingScoreComponent* BowlingScoreComponent)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreboardPublisher::Publish);
+
+	FBowlingSharedLaneState State = {};
+	if (BowlingScoreComponent)
+	{
+		State.Version = BowlingScoreComponent->GetStateVersion();
+		State.LaneId = static_cast<uint32>(LaneId);
+		State.CurrentFrame = static_cast<int8>(BowlingScoreComponent->GetCurrentFrameNum());
+		State.CurrentShot = static_cast<int8>(BowlingScoreComponent->GetCurrentShotNum());
+		State.NumPins = static_cast<uint8>(BowlingScoreComponent->GetNumPins());
+		State.MaxPossibleScore = static_cast<uint16>(BowlingScoreComponent->GetMaxPossibleScore());
+
+		// Variants with more frames or shots than the layout holds only show what fits
+		const auto& FrameScores = BowlingScoreComponent->GetFrameScores();
+		const auto NumFrames = FMath::Min(FrameScores.Num(), FBowlingSharedLaneState::MaxFrames);
+		const auto NumShotsRecorded = BowlingScoreComponent->GetNumShotsRecorded();
+		State.NumFrames = static_cast<uint8>(NumFrames);
+		for (auto FrameIdx = 0; FrameIdx < NumFrames; FrameIdx++)
+		{
+			const auto& Shots = FrameScores[FrameIdx].Shots;
+			for (auto ShotIdx = 0; ShotIdx < FMath::Min(Shots.Num(), FBowlingSharedLaneState::MaxShots); ShotIdx++)
+			{
+				State.Shots[FrameIdx * FBowlingSharedLaneState::MaxShots + ShotIdx] = static_cast<uint8>(Shots[ShotIdx]);
+			}
+			State.FrameTotals[FrameIdx] = static_cast<uint16>(BowlingScoreComponent->GetScoreAt(NumShotsRecorded, FrameIdx + 1));
+		}
+	}
+
+	auto* Header = GetHeader();
+	Header->GetSlots()[Slot].Write(State);
+	Header->PublishCount.fetch_add(1, std::memory_order_release);
+}
+
+void UBowlingScoreboardPublisher::Publish(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	if (not IsOpen()) { return; }
+
+	const auto* LaneId = LaneIds.Find(BowlingScoreComponent);
+	const auto* Lane = LaneId ? Lanes.Find(*LaneId) : nullptr;
+	if (Lane and Lane->Slot != INDEX_NONE)
+	{
+		Publish(Lane->Slot, *LaneId, BowlingScoreComponent);
+	}
+}
+
+void UBowlingScoreboardPublisher::ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score)
+{
+	Publish(BowlingScoreComponent);
+}
+
+void UBowlingScoreboardPublisher::GameReset(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	Publish(BowlingScoreComponent);
+}
@@ -0,0 +1,375 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingScoringWorker.h"
+
+#include <atomic>
+
+#include "BowlingMemory.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/*
+ * Applies every lane's queued shots and fills in snapshots for the game thread.
+ *
+ * Snapshots are double buffered with a handshake instead of a lock: the scoring thread fills the buffer the game thread
+ * isn't reading and raises bPublished, and only writes again once the game thread has swapped buffers and lowered it.
+ * Shots keep being applied in the meantime, they're just published together next time.
+ *
+ * With nothing to do the thread sleeps on WakeEvent, which producers trigger after every push and the game thread
+ * triggers after taking a buffer, so an idle center has no wakeups at all.
+ */
+class FBowlingScoringThread : public FRunnable
+{
+public:
+	struct FLane
+	{
+		FLane(int32 InLaneId, const FBowlingRuleSet& InRuleSet)
+			: LaneId(InLaneId), RuleSet(&InRuleSet), Commands(UBowlingScoringWorker::QueueCapacity + 1)
+		{
+			Reset();
+		}
+
+		void Reset()
+		{
+			Frames.SetNum(RuleSet->NumFrames);
+			NumShotsThrown.Init(0, RuleSet->NumFrames);
+			for (auto Idx = 0; Idx < Frames.Num(); Idx++)
+			{
+				auto& Shots = Frames[Idx].Shots;
+				Shots.SetNum(RuleSet->GetNumShots(Idx), EAllowShrinking::No);
+				FMemory::Memzero(Shots.GetData(), Shots.Num() * Shots.GetTypeSize());
+				Frames[Idx].PinMasks = 0;
+			}
+			FrameIdx = 0;
+			ShotIdx = 0;
+			Version++;
+		}
+
+		bool Apply(int32 Pins)
+		{
+			if (FrameIdx >= RuleSet->NumFrames or not RuleSet->IsValidShotScore(Frames, Pins, FrameIdx, ShotIdx))
+			{
+				return false;
+			}
+
+			Frames[FrameIdx].Shots[ShotIdx] = Pins;
+			NumShotsThrown[FrameIdx]++;
+			RuleSet->Advance(Frames, FrameIdx, ShotIdx);
+			Version++;
+			return true;
+		}
+
+		void Write(FBowlingScoreSnapshot& Snapshot) const
+		{
+			Snapshot.Frames.SetNum(Frames.Num());
+			auto Score = 0;
+			for (auto Idx = 0; Idx < Frames.Num(); Idx++)
+			{
+				auto& Frame = Snapshot.Frames[Idx];
+				const auto& Shots = Frames[Idx].Shots;
+				Frame.Shots.Reset();
+				Frame.Shots.Append(Shots);
+				Frame.Marks.Init(EBowlingShotMark::None, Shots.Num());
+				Frame.NumShotsThrown = NumShotsThrown[Idx];
+				for (auto Shot = 0; Shot < Frame.NumShotsThrown; Shot++)
+				{
+					Frame.Marks[Shot] = RuleSet->IsStrike(Frames, Idx, Shot)
+						? EBowlingShotMark::Strike
+						: RuleSet->IsSpare(Frames, Idx, Shot) ? EBowlingShotMark::Spare : EBowlingShotMark::Open;
+				}
+				Frame.FrameScore = RuleSet->GetFrameScore(Frames, Idx);
+				Score += Frame.FrameScore;
+				Frame.Score = Score;
+			}
+
+			Snapshot.bGameOver = FrameIdx >= Frames.Num();
+			Snapshot.CurrentFrame = Snapshot.bGameOver ? -1 : FrameIdx + 1;
+			Snapshot.CurrentShot = Snapshot.bGameOver ? -1 : ShotIdx + 1;
+			Snapshot.Score = Score;
+			Snapshot.MaxPossibleScore = RuleSet->GetMaxPossibleScore(Frames, FrameIdx, ShotIdx);
+			Snapshot.StateVersion = Version;
+		}
+
+		int32 LaneId;
+		const FBowlingRuleSet* RuleSet;
+
+		// Pinfall of a shot, or -1 to reset the game. Pushed by the lane's producer, popped by the scoring thread.
+		TCircularQueue<int8> Commands;
+
+		// Everything below is only touched by the scoring thread
+		TArray<FBowlingFrameScore> Frames;
+		TArray<int32, TInlineAllocator<10>> NumShotsThrown;
+		int32 FrameIdx = 0;
+		int32 ShotIdx = 0;
+		int64 Version = 0;
+	};
+
+	explicit FBowlingScoringThread(TConstArrayView<TPair<int32, const FBowlingRuleSet*>> InLanes)
+	{
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+
+		for (auto Idx = 0; Idx < InLanes.Num(); Idx++)
+		{
+			Lanes.Add(MakeUnique<FLane>(InLanes[Idx].Key, *InLanes[Idx].Value));
+			LaneIndices.Add(InLanes[Idx].Key, Idx);
+		}
+
+		// Both buffers start out with every game reset
+		for (auto& Buffer : Buffers)
+		{
+			Buffer.SetNum(Lanes.Num());
+			for (auto Idx = 0; Idx < Lanes.Num(); Idx++)
+			{
+				Lanes[Idx]->Write(Buffer[Idx]);
+			}
+		}
+
+		Thread.Reset(FRunnableThread::Create(this, TEXT("BowlingScoring"), 0, TPri_AboveNormal));
+	}
+
+	virtual ~FBowlingScoringThread() override
+	{
+		Thread->Kill(true);
+	}
+
+	virtual uint32 Run() override
+	{
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+
+		while (not bStopping)
+		{
+			const auto bApplied = ApplyCommands();
+			const auto bPublishedNow = Publish();
+
+			// A trigger that came in since the last pass is kept by the event, so nothing is slept through
+			if (not bApplied and not bPublishedNow)
+			{
+				WakeEvent->Wait();
+			}
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+		WakeEvent->Trigger();
+	}
+
+	bool Push(int32 LaneId, int8 Command)
+	{
+		const auto* Idx = LaneIndices.Find(LaneId);
+		if (not Idx or not Lanes[*Idx]->Commands.Enqueue(Command)) { return false; }
+
+		WakeEvent->Trigger();
+		return true;
+	}
+
+	// Swap in the latest snapshots if there are any, calling back with every lane that changed
+	template <typename TCallback>
+	int32 Consume(TCallback&& Changed)
+	{
+		if (not bPublished.load(std::memory_order_acquire)) { return 0; }
+
+		const auto& Previous = Buffers[ReadIdx];
+		ReadIdx ^= 1;
+		const auto& Latest = Buffers[ReadIdx];
+
+		auto NumChanged = 0;
+		for (auto Idx = 0; Idx < Lanes.Num(); Idx++)
+		{
+			if (Latest[Idx].StateVersion != Previous[Idx].StateVersion)
+			{
+				Changed(Lanes[Idx]->LaneId, Latest[Idx]);
+				NumChanged++;
+			}
+		}
+
+		// The old buffer is the scoring thread's to fill again, with anything it's applied while waiting for it
+		bPublished.store(false, std::memory_order_release);
+		WakeEvent->Trigger();
+		return NumChanged;
+	}
+
+	const FBowlingScoreSnapshot* GetSnapshot(int32 LaneId) const
+	{
+		const auto* Idx = LaneIndices.Find(LaneId);
+		return Idx ? &Buffers[ReadIdx][*Idx] : nullptr;
+	}
+
+	std::atomic<int64> NumApplied = 0;
+	std::atomic<int64> NumRejected = 0;
+
+private:
+	bool ApplyCommands()
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingScoringThread::ApplyCommands);
+
+		auto bApplied = false;
+		for (auto& Lane : Lanes)
+		{
+			int8 Command;
+			while (Lane->Commands.Dequeue(Command))
+			{
+				if (Command < 0)
+				{
+					Lane->Reset();
+					NumApplied++;
+				}
+				else if (Lane->Apply(Command))
+				{
+					NumApplied++;
+				}
+				else
+				{
+					NumRejected++;
+				}
+				bApplied = true;
+			}
+		}
+		return bApplied;
+	}
+
+	bool Publish()
+	{
+		// The game thread hasn't taken the last ones yet
+		if (bPublished.load(std::memory_order_acquire)) { return false; }
+
+		// It has, so it's reading what was written last and the other buffer is free
+		if (bWritten)
+		{
+			WriteIdx ^= 1;
+			bWritten = false;
+		}
+
+		TRACE_CPUPROFILER_EVENT_SCOPE(FBowlingScoringThread::Publish);
+
+		// The buffer was last written two publishes ago, bring every lane that's changed since then up to date
+		auto& Buffer = Buffers[WriteIdx];
+		auto bChanged = false;
+		for (auto Idx = 0; Idx < Lanes.Num(); Idx++)
+		{
+			if (Buffer[Idx].StateVersion != Lanes[Idx]->Version)
+			{
+				Lanes[Idx]->Write(Buffer[Idx]);
+				bChanged = true;
+			}
+		}
+		if (not bChanged) { return false; }
+
+		bWritten = true;
+		bPublished.store(true, std::memory_order_release);
+		return true;
+	}
+
+	TArray<TUniquePtr<FLane>> Lanes;
+	TMap<int32, int32> LaneIndices;
+
+	TArray<FBowlingScoreSnapshot> Buffers[2];
+
+	// Buffer the game thread reads, only touched by the game thread
+	int32 ReadIdx = 0;
+
+	// Buffer the scoring thread fills, starting with the one the game thread isn't reading
+	int32 WriteIdx = 1;
+	bool bWritten = false;
+
+	// Raised by the scoring thread when Buffers[WriteIdx] is ready, lowered by the game thread once it's swapped
+	std::atomic<bool> bPublished = false;
+
+	FEventRef WakeEvent;
+	TUniquePtr<FRunnableThread> Thread;
+	std::atomic<bool> bStopping = false;
+};
+
+UBowlingScoringWorker::UBowlingScoringWorker() = default;
+
+UBowlingScoringWorker::~UBowlingScoringWorker() = default;
+
+void UBowlingScoringWorker::AddLane(int32 LaneId, const FBowlingRuleSet& RuleSet)
+{
+	if (not ensureMsgf(not IsRunning(), TEXT("Lanes can't be added while scoring is running"))) { return; }
+
+	RemoveLane(LaneId);
+	Lanes.Emplace(LaneId, &RuleSet);
+}
+
+void UBowlingScoringWorker::RemoveLane(int32 LaneId)
+{
+	if (not ensureMsgf(not IsRunning(), TEXT("Lanes can't be removed while scoring is running"))) { return; }
+
+	Lanes.RemoveAll([LaneId](const TPair<int32, const FBowlingRuleSet*>& Lane) { return Lane.Key == LaneId; });
+}
+
+void UBowlingScoringWorker::Start()
+{
+	Stop();
+
+	Thread = MakeUnique<FBowlingScoringThread>(Lanes);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UBowlingScoringWorker::Tick));
+}
+
+void UBowlingScoringWorker::Stop()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+
+	Thread.Reset();
+}
+
+bool UBowlingScoringWorker::PushShot(int32 LaneId, int32 Pins)
+{
+	if (Pins < 0 or Pins > MAX_int8) { return false; }
+	return Thread and Thread->Push(LaneId, static_cast<int8>(Pins));
+}
+
+bool UBowlingScoringWorker::PushReset(int32 LaneId)
+{
+	return Thread and Thread->Push(LaneId, -1);
+}
+
+int32 UBowlingScoringWorker::UpdateSnapshots()
+{
+	if (not Thread) { return 0; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoringWorker::UpdateSnapshots);
+
+	return Thread->Consume([this](int32 LaneId, const FBowlingScoreSnapshot& Snapshot)
+	{
+		OnLaneUpdated.Broadcast(LaneId, Snapshot);
+	});
+}
+
+const FBowlingScoreSnapshot* UBowlingScoringWorker::GetSnapshot(int32 LaneId) const
+{
+	return Thread ? Thread->GetSnapshot(LaneId) : nullptr;
+}
+
+int64 UBowlingScoringWorker::GetNumApplied() const
+{
+	return Thread ? Thread->NumApplied.load() : 0;
+}
+
+int64 UBowlingScoringWorker::GetNumRejected() const
+{
+	return Thread ? Thread->NumRejected.load() : 0;
+}
+
+void UBowlingScoringWorker::BeginDestroy()
+{
+	Stop();
+
+	Super::BeginDestroy();
+}
+
+bool UBowlingScoringWorker::Tick(float DeltaTime)
+{
+	UpdateSnapshots();
+	return true;
+}
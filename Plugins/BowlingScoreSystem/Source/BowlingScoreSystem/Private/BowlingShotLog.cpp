@@ -0,0 +1,362 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingShotLog.h"
+
+#include <atomic>
+
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreSystem.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+uint16 FBowlingShotLogRecord::CalculateChecksum() const
+{
+	// Everything but the checksum itself
+	return static_cast<uint16>(FCrc::MemCrc32(this, offsetof(FBowlingShotLogRecord, Checksum)));
+}
+
+/*
+ * Group commit writer. Appends are collected under a lock, and the writer thread swaps them out, writes them and
+ * syncs the file once per batch.
+ */
+class FBowlingShotLogWriter : public FRunnable
+{
+public:
+	FBowlingShotLogWriter(IFileHandle* InHandle, double InGroupCommitWindowSeconds) :
+		Handle(InHandle), GroupCommitWindowSeconds(InGroupCommitWindowSeconds), DurableOffset(InHandle->Tell())
+	{
+		Thread.Reset(FRunnableThread::Create(this, TEXT("BowlingShotLogWriter"), 0, TPri_AboveNormal));
+	}
+
+	virtual ~FBowlingShotLogWriter() override
+	{
+		// Kill waits for Run to write out anything still pending
+		Thread->Kill(true);
+	}
+
+	void Append(const FBowlingShotLogRecord& Record)
+	{
+		{
+			FScopeLock Lock(&PendingLock);
+			Pending.Add(Record);
+			AppendedCount++;
+		}
+		WakeEvent->Trigger();
+	}
+
+	bool Flush()
+	{
+		const auto Target = AppendedCount.load();
+		WakeEvent->Trigger();
+		while (DurableCount.load() < Target)
+		{
+			if (bWriteFailed) { return false; }
+			DurableEvent->Wait(1);
+		}
+		return true;
+	}
+
+	uint64 GetAppendedCount() const { return AppendedCount.load(); }
+	uint64 GetDurableCount() const { return DurableCount.load(); }
+	bool HasWriteFailed() const { return bWriteFailed; }
+
+	virtual uint32 Run() override
+	{
+		while (not bStopping)
+		{
+			// A batch that couldn't be written is retried until it can be, or the log is closed
+			WakeEvent->Wait(bWriteFailed ? RetryIntervalMs : MAX_uint32);
+
+			// Give shots from other lanes a moment to join the batch, this is what keeps syncs to one per batch
+			if (GroupCommitWindowSeconds > 0 and not bStopping)
+			{
+				FPlatformProcess::Sleep(GroupCommitWindowSeconds);
+			}
+
+			WriteBatch();
+		}
+
+		WriteBatch();
+		if (not Writing.IsEmpty())
+		{
+			UE_LOG(LogBowling, Error, TEXT("Shot log closed with %d events that could not be written"), Writing.Num());
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopping = true;
+		WakeEvent->Trigger();
+	}
+
+private:
+	void WriteBatch()
+	{
+		uint64 BatchCount;
+		{
+			FScopeLock Lock(&PendingLock);
+			// A batch that failed is still waiting to be written, anything new goes after it
+			if (Writing.IsEmpty())
+			{
+				Swap(Pending, Writing);
+			}
+			else
+			{
+				Writing.Append(Pending);
+				Pending.Reset();
+			}
+			BatchCount = AppendedCount;
+		}
+		if (Writing.IsEmpty()) { return; }
+
+		// Write over whatever part of a failed batch made it to the file rather than after it
+		if (bWriteFailed) { Handle->Seek(DurableOffset); }
+
+		const auto* Data = reinterpret_cast<const uint8*>(Writing.GetData());
+		if (not Handle->Write(Data, Writing.Num() * sizeof(FBowlingShotLogRecord)) or not Handle->Flush(true))
+		{
+			// Only the first failure is logged, retries keep failing the same way until the disk comes back
+			if (not bWriteFailed)
+			{
+				UE_LOG(LogBowling, Error, TEXT("Failed to write %d events to the shot log, retrying"), Writing.Num());
+			}
+			bWriteFailed = true;
+			DurableEvent->Trigger();
+			return;
+		}
+
+		if (bWriteFailed)
+		{
+			UE_LOG(LogBowling, Display, TEXT("Shot log writes recovered with %d events"), Writing.Num());
+			bWriteFailed = false;
+		}
+
+		Writing.Reset();
+		DurableOffset = Handle->Tell();
+		DurableCount = BatchCount;
+		DurableEvent->Trigger();
+	}
+
+	static constexpr uint32 RetryIntervalMs = 100;
+
+	TUniquePtr<IFileHandle> Handle;
+	double GroupCommitWindowSeconds;
+
+	FCriticalSection PendingLock;
+	TArray<FBowlingShotLogRecord> Pending;
+
+	// Only touched by the writer thread. Writing keeps a batch that failed until it's written.
+	TArray<FBowlingShotLogRecord> Writing;
+	int64 DurableOffset;
+
+	std::atomic<uint64> AppendedCount = 0;
+	std::atomic<uint64> DurableCount = 0;
+	std::atomic<bool> bStopping = false;
+	std::atomic<bool> bWriteFailed = false;
+
+	FEventRef WakeEvent;
+	FEventRef DurableEvent;
+	TUniquePtr<FRunnableThread> Thread;
+};
+
+UBowlingShotLog::UBowlingShotLog() = default;
+
+UBowlingShotLog::~UBowlingShotLog() = default;
+
+bool UBowlingShotLog::Open(const FString& InPath, double InGroupCommitWindowSeconds)
+{
+	Close();
+
+	Path = InPath;
+	GroupCommitWindowSeconds = InGroupCommitWindowSeconds;
+
+	// Load whatever survived the last run
+	RecoveredRecords.Reset();
+	RecoveredInputOffset = 0;
+	TArray<uint8> Data;
+	if (FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent))
+	{
+		const auto NumRecords = Data.Num() / static_cast<int32>(sizeof(FBowlingShotLogRecord));
+		RecoveredRecords.SetNumUninitialized(NumRecords);
+		FMemory::Memcpy(RecoveredRecords.GetData(), Data.GetData(), NumRecords * sizeof(FBowlingShotLogRecord));
+
+		// Anything after a damaged record was never synced, so it can't have been relied on
+		const auto ValidRecords = RecoveredRecords.IndexOfByPredicate([](const FBowlingShotLogRecord& Record)
+		{
+			return Record.Checksum != Record.CalculateChecksum();
+		});
+		const auto bDamaged = ValidRecords != INDEX_NONE
+			or Data.Num() != NumRecords * static_cast<int32>(sizeof(FBowlingShotLogRecord));
+		if (bDamaged)
+		{
+			if (ValidRecords != INDEX_NONE)
+			{
+				RecoveredRecords.SetNum(ValidRecords);
+			}
+			UE_LOG(LogBowling, Warning, TEXT("Shot log %s was damaged, keeping the first %d events"), *Path,
+			       RecoveredRecords.Num());
+
+			// Rewrite the log so new events aren't appended after the damage
+			const auto ValidBytes = TArrayView<const uint8>(reinterpret_cast<const uint8*>(RecoveredRecords.GetData()),
+			                                                RecoveredRecords.Num() * sizeof(FBowlingShotLogRecord));
+			if (not FFileHelper::SaveArrayToFile(ValidBytes, *Path))
+			{
+				UE_LOG(LogBowling, Error, TEXT("Could not repair shot log %s"), *Path);
+				return false;
+			}
+		}
+	}
+
+	// Events go on from where the recovered ones left off
+	if (not RecoveredRecords.IsEmpty())
+	{
+		RecoveredInputOffset = RecoveredRecords.Last().InputOffset;
+		InputOffset = RecoveredInputOffset;
+	}
+
+	auto* Handle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path, true, true);
+	if (not Handle)
+	{
+		UE_LOG(LogBowling, Error, TEXT("Could not open shot log %s"), *Path);
+		return false;
+	}
+
+	Writer = MakeUnique<FBowlingShotLogWriter>(Handle, GroupCommitWindowSeconds);
+	return true;
+}
+
+void UBowlingShotLog::Close()
+{
+	Writer.Reset();
+}
+
+void UBowlingShotLog::AddLane(int32 LaneId, UBowlingScoreComponent* BowlingScoreComponent)
+{
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+	if (not ensureMsgf(LaneId >= 0 and LaneId <= MAX_uint16, TEXT("Lane %d can't be logged"), LaneId)) { return; }
+
+	RemoveLane(LaneId);
+	Lanes.Add(LaneId, BowlingScoreComponent);
+	LaneIds.Add(BowlingScoreComponent, LaneId);
+
+	BowlingScoreComponent->OnShotRecorded.AddUObject(this, &UBowlingShotLog::ShotRecorded);
+	BowlingScoreComponent->OnReset.AddUniqueDynamic(this, &UBowlingShotLog::GameReset);
+}
+
+void UBowlingShotLog::RemoveLane(int32 LaneId)
+{
+	TObjectPtr<UBowlingScoreComponent> BowlingScoreComponent;
+	if (not Lanes.RemoveAndCopyValue(LaneId, BowlingScoreComponent)) { return; }
+
+	LaneIds.Remove(BowlingScoreComponent.Get());
+	if (IsValid(BowlingScoreComponent))
+	{
+		BowlingScoreComponent->OnShotRecorded.RemoveAll(this);
+		BowlingScoreComponent->OnReset.RemoveDynamic(this, &UBowlingShotLog::GameReset);
+	}
+}
+
+int32 UBowlingShotLog::Recover()
+{
+	TGuardValue<bool> RecoveringGuard(bRecovering, true);
+
+	auto Replayed = 0;
+	for (auto&& Record : RecoveredRecords)
+	{
+		auto* BowlingScoreComponent = Lanes.FindRef(Record.LaneId).Get();
+		if (not BowlingScoreComponent) { continue; }
+
+		if (Record.Type == FBowlingShotLogRecord::EType::Reset)
+		{
+			BowlingScoreComponent->Reset();
+		}
+		else if (Record.Frame != BowlingScoreComponent->GetCurrentFrameNum()
+			or Record.Shot != BowlingScoreComponent->GetCurrentShotNum()
+			or not BowlingScoreComponent->SetScore(Record.Score))
+		{
+			UE_LOG(LogBowling, Warning, TEXT("Lane %d could not replay %d pins on Frame %d Shot %d"),
+			       Record.LaneId, Record.Score, Record.Frame, Record.Shot);
+			continue;
+		}
+
+		Replayed++;
+	}
+
+	RecoveredRecords.Empty();
+	return Replayed;
+}
+
+void UBowlingShotLog::Truncate()
+{
+	Close();
+	RecoveredRecords.Empty();
+	FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*Path);
+	Open(Path, GroupCommitWindowSeconds);
+}
+
+bool UBowlingShotLog::Flush()
+{
+	return Writer and Writer->Flush();
+}
+
+bool UBowlingShotLog::HasWriteFailed() const
+{
+	return Writer and Writer->HasWriteFailed();
+}
+
+uint64 UBowlingShotLog::GetAppendedCount() const
+{
+	return Writer ? Writer->GetAppendedCount() : 0;
+}
+
+uint64 UBowlingShotLog::GetDurableCount() const
+{
+	return Writer ? Writer->GetDurableCount() : 0;
+}
+
+void UBowlingShotLog::BeginDestroy()
+{
+	Close();
+
+	Super::BeginDestroy();
+}
+
+void UBowlingShotLog::Append(FBowlingShotLogRecord Record)
+{
+	if (bRecovering or not Writer) { return; }
+
+	LLM_SCOPE_BYTAG(Bowling_Caches);
+	Record.InputOffset = InputOffset;
+	Record.Checksum = Record.CalculateChecksum();
+	Writer->Append(Record);
+}
+
+void UBowlingShotLog::ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score)
+{
+	const auto* LaneId = LaneIds.Find(BowlingScoreComponent);
+	if (not ensure(LaneId)) { return; }
+
+	FBowlingShotLogRecord Record;
+	Record.LaneId = static_cast<uint16>(*LaneId);
+	Record.Type = FBowlingShotLogRecord::EType::Shot;
+	Record.Frame = static_cast<uint8>(Frame);
+	Record.Shot = static_cast<uint8>(Shot);
+	Record.Score = static_cast<uint8>(Score);
+	Append(Record);
+}
+
+void UBowlingShotLog::GameReset(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	const auto* LaneId = LaneIds.Find(BowlingScoreComponent);
+	if (not ensure(LaneId)) { return; }
+
+	FBowlingShotLogRecord Record;
+	Record.LaneId = static_cast<uint16>(*LaneId);
+	Record.Type = FBowlingShotLogRecord::EType::Reset;
+	Append(Record);
+}
@@ -0,0 +1,364 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingTeamMatch.h"
+
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+FBowlingGamePool& FBowlingGamePool::Get()
+{
+	static FBowlingGamePool Pool;
+	return Pool;
+}
+
+FBowlingGameRecord* FBowlingGamePool::Allocate()
+{
+	if (FreeGames.IsEmpty())
+	{
+		LLM_SCOPE_BYTAG(Bowling_Games);
+
+		// Hand games out from the start of a new slab first
+		auto& Slab = Slabs.Add_GetRef(MakeUnique<FSlab>());
+		FreeGames.Reserve(Slabs.Num() * GamesPerSlab);
+		for (auto Idx = GamesPerSlab - 1; Idx >= 0; Idx--)
+		{
+			FreeGames.Add(&Slab->Games[Idx]);
+		}
+	}
+
+	auto* Game = FreeGames.Pop(EAllowShrinking::No);
+	FMemory::Memzero(*Game);
+	return Game;
+}
+
+void FBowlingGamePool::Free(FBowlingGameRecord* Game)
+{
+	if (Game) { FreeGames.Add(Game); }
+}
+
+void FBowlingGamePool::Empty()
+{
+	ensureMsgf(GetNumAllocated() == 0, TEXT("Emptying the game pool with %d games still in use"), GetNumAllocated());
+	FreeGames.Empty();
+	Slabs.Empty();
+}
+
+FBowlingTeamMatch::FBowlingTeamMatch(int32 InNumGames, FBowlingGamePool& InPool)
+	: NumGames(FMath::Max(InNumGames, 1))
+	, Pool(InPool)
+{
+}
+
+FBowlingTeamMatch::~FBowlingTeamMatch()
+{
+	ResetGames();
+}
+
+void FBowlingTeamMatch::SetNumGames(int32 InNumGames)
+{
+	if (not ensureMsgf(SeriesList.IsEmpty(), TEXT("Games per series can't change once series have been added"))) { return; }
+	NumGames = FMath::Max(InNumGames, 1);
+}
+
+int32 FBowlingTeamMatch::AddTeam()
+{
+	return Teams.AddDefaulted();
+}
+
+int32 FBowlingTeamMatch::AddSeries(int32 Team, int32 Handicap)
+{
+	if (not ensure(Teams.IsValidIndex(Team))) { return INDEX_NONE; }
+
+	const auto Series = SeriesList.AddDefaulted();
+	SeriesList[Series].Team = Team;
+	SeriesList[Series].Handicap = Handicap;
+	Teams[Team].Series.Add(Series);
+	return Series;
+}
+
+bool FBowlingTeamMatch::UpdateGame(int32 Series, TConstArrayView<int32> FrameTotals)
+{
+	if (not ensure(SeriesList.IsValidIndex(Series))) { return false; }
+	auto& Entry = SeriesList[Series];
+	auto& Team = Teams[Entry.Team];
+
+	if (not Entry.IsGameInProgress())
+	{
+		if (Entry.Games.Num() >= NumGames) { return false; }
+		Entry.Games.Add(Pool.Allocate());
+		Team.HandicapTotal += Entry.Handicap;
+	}
+
+	auto& Game = *Entry.Games.Last();
+	Game.NumFrames = FMath::Min(FrameTotals.Num(), FBowlingGameRecord::MaxFrames);
+	FMemory::Memcpy(Game.FrameTotals, FrameTotals.GetData(), Game.NumFrames * sizeof(int32));
+
+	// Only the change in this game moves the series and team along
+	const auto Score = Game.NumFrames > 0 ? Game.FrameTotals[Game.NumFrames - 1] : 0;
+	const auto Change = Score - Game.Score;
+	Game.Score = Score;
+	Entry.Total += Change;
+	Team.Total += Change;
+	return true;
+}
+
+void FBowlingTeamMatch::FinishGame(int32 Series)
+{
+	if (not ensure(SeriesList.IsValidIndex(Series))) { return; }
+
+	auto& Entry = SeriesList[Series];
+	if (Entry.IsGameInProgress()) { Entry.Games.Last()->bFinished = true; }
+}
+
+void FBowlingTeamMatch::AbandonGame(int32 Series)
+{
+	if (not ensure(SeriesList.IsValidIndex(Series))) { return; }
+
+	auto& Entry = SeriesList[Series];
+	if (not Entry.IsGameInProgress()) { return; }
+
+	auto* Game = Entry.Games.Pop(EAllowShrinking::No);
+	auto& Team = Teams[Entry.Team];
+	Entry.Total -= Game->Score;
+	Team.Total -= Game->Score;
+	Team.HandicapTotal -= Entry.Handicap;
+	Pool.Free(Game);
+}
+
+int32 FBowlingTeamMatch::GetNumGamesStarted(int32 Series) const
+{
+	return SeriesList.IsValidIndex(Series) ? SeriesList[Series].Games.Num() : 0;
+}
+
+bool FBowlingTeamMatch::IsSeriesComplete(int32 Series) const
+{
+	if (not SeriesList.IsValidIndex(Series)) { return false; }
+
+	const auto& Entry = SeriesList[Series];
+	return Entry.Games.Num() == NumGames and not Entry.IsGameInProgress();
+}
+
+const FBowlingGameRecord* FBowlingTeamMatch::GetGame(int32 Series, int32 Game) const
+{
+	if (not SeriesList.IsValidIndex(Series) or not SeriesList[Series].Games.IsValidIndex(Game - 1)) { return nullptr; }
+	return SeriesList[Series].Games[Game - 1];
+}
+
+int32 FBowlingTeamMatch::GetSeriesTotal(int32 Series, bool bWithHandicap) const
+{
+	if (not SeriesList.IsValidIndex(Series)) { return 0; }
+
+	const auto& Entry = SeriesList[Series];
+	return Entry.Total + (bWithHandicap ? Entry.Handicap * Entry.Games.Num() : 0);
+}
+
+int32 FBowlingTeamMatch::GetTeamTotal(int32 Team, bool bWithHandicap) const
+{
+	if (not Teams.IsValidIndex(Team)) { return 0; }
+	return Teams[Team].Total + (bWithHandicap ? Teams[Team].HandicapTotal : 0);
+}
+
+int32 FBowlingTeamMatch::GetTeamGameTotal(int32 Team, int32 Game, bool bWithHandicap) const
+{
+	if (not Teams.IsValidIndex(Team)) { return 0; }
+
+	auto Total = 0;
+	for (const auto Series : Teams[Team].Series)
+	{
+		if (const auto* Record = GetGame(Series, Game))
+		{
+			Total += Record->Score + (bWithHandicap ? SeriesList[Series].Handicap : 0);
+		}
+	}
+	return Total;
+}
+
+void FBowlingTeamMatch::ResetGames()
+{
+	for (auto& Entry : SeriesList)
+	{
+		for (auto* Game : Entry.Games)
+		{
+			Pool.Free(Game);
+		}
+		Entry.Games.Reset();
+		Entry.Total = 0;
+	}
+
+	for (auto& Team : Teams)
+	{
+		Team.Total = 0;
+		Team.HandicapTotal = 0;
+	}
+}
+
+void UBowlingTeamMatch::SetNumGames(int32 InNumGames)
+{
+	Match.SetNumGames(InNumGames);
+}
+
+int32 UBowlingTeamMatch::AddTeam()
+{
+	return Match.AddTeam();
+}
+
+void UBowlingTeamMatch::AddBowler(int32 Team, UBowlingScoreComponent* BowlingScoreComponent, int32 BowlerId,
+                                  int32 Handicap)
+{
+	if (not IsValid(BowlingScoreComponent) or Components.Contains(BowlingScoreComponent)) { return; }
+	if (not ensureMsgf(not BowlerSeries.Contains(BowlerId), TEXT("Bowler %d is already in the match"), BowlerId)) { return; }
+
+	const auto Series = Match.AddSeries(Team, Handicap);
+	if (Series == INDEX_NONE) { return; }
+
+	BowlerSeries.Add(BowlerId, Series);
+	BindComponent(BowlingScoreComponent, Series);
+}
+
+void UBowlingTeamMatch::AddBakerGame(int32 Team, UBowlingScoreComponent* BowlingScoreComponent,
+                                     const TArray<int32>& BowlerIds, int32 Handicap)
+{
+	if (not IsValid(BowlingScoreComponent) or Components.Contains(BowlingScoreComponent) or BowlerIds.IsEmpty()) { return; }
+
+	const auto Series = Match.AddSeries(Team, Handicap);
+	if (Series == INDEX_NONE) { return; }
+
+	BakerBowlers.Add(Series, BowlerIds);
+	BindComponent(BowlingScoreComponent, Series);
+}
+
+void UBowlingTeamMatch::RemoveComponent(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	if (not Components.Remove(BowlingScoreComponent)) { return; }
+
+	if (IsValid(BowlingScoreComponent))
+	{
+		BowlingScoreComponent->OnScoreChanged.RemoveDynamic(this, &UBowlingTeamMatch::ScoreChanged);
+		BowlingScoreComponent->OnGameOver.RemoveDynamic(this, &UBowlingTeamMatch::GameOver);
+		BowlingScoreComponent->OnReset.RemoveDynamic(this, &UBowlingTeamMatch::GameReset);
+	}
+}
+
+int32 UBowlingTeamMatch::GetSeriesTotal(int32 BowlerId, bool bWithHandicap) const
+{
+	const auto* Series = BowlerSeries.Find(BowlerId);
+	return Series ? Match.GetSeriesTotal(*Series, bWithHandicap) : 0;
+}
+
+int32 UBowlingTeamMatch::GetGameScore(int32 BowlerId, int32 Game) const
+{
+	const auto* Series = BowlerSeries.Find(BowlerId);
+	const auto* Record = Series ? Match.GetGame(*Series, Game) : nullptr;
+	return Record ? Record->Score : 0;
+}
+
+int32 UBowlingTeamMatch::GetTeamTotal(int32 Team, bool bWithHandicap) const
+{
+	return Match.GetTeamTotal(Team, bWithHandicap);
+}
+
+int32 UBowlingTeamMatch::GetTeamGameTotal(int32 Team, int32 Game, bool bWithHandicap) const
+{
+	return Match.GetTeamGameTotal(Team, Game, bWithHandicap);
+}
+
+int32 UBowlingTeamMatch::GetBakerBowler(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame) const
+{
+	const auto* Series = Components.Find(BowlingScoreComponent);
+	const auto* Bowlers = Series ? BakerBowlers.Find(*Series) : nullptr;
+	if (not Bowlers or Frame < 1) { return INDEX_NONE; }
+	return (*Bowlers)[(Frame - 1) % Bowlers->Num()];
+}
+
+int32 UBowlingTeamMatch::GetBakerPinfall(int32 BowlerId) const
+{
+	auto Pinfall = 0;
+	for (const auto& [Series, Bowlers] : BakerBowlers)
+	{
+		for (auto Game = 1; Game <= Match.GetNumGamesStarted(Series); Game++)
+		{
+			const auto* Record = Match.GetGame(Series, Game);
+			for (auto Frame = 1; Frame <= Record->NumFrames; Frame++)
+			{
+				if (Bowlers[(Frame - 1) % Bowlers.Num()] == BowlerId) { Pinfall += Record->GetFrameScore(Frame); }
+			}
+		}
+	}
+	return Pinfall;
+}
+
+void UBowlingTeamMatch::ResetGames()
+{
+	Match.ResetGames();
+
+	// Games already under way count as the first of the new series
+	for (const auto& [BowlingScoreComponent, Series] : Components)
+	{
+		if (IsValid(BowlingScoreComponent) and BowlingScoreComponent->GetNumShotsRecorded() > 0
+			and not BowlingScoreComponent->IsGameOver())
+		{
+			UpdateGame(BowlingScoreComponent, Series);
+		}
+	}
+}
+
+int32 UBowlingTeamMatch::GetHandicap(int32 Average, int32 Basis, float Percentage)
+{
+	return FMath::Max(0, FMath::FloorToInt((Basis - Average) * Percentage));
+}
+
+void UBowlingTeamMatch::ScoreChanged(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame)
+{
+	const auto* Series = Components.Find(BowlingScoreComponent);
+	if (not ensure(Series)) { return; }
+
+	UpdateGame(BowlingScoreComponent, *Series);
+}
+
+void UBowlingTeamMatch::GameOver(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	const auto* Series = Components.Find(BowlingScoreComponent);
+	if (not ensure(Series)) { return; }
+
+	Match.FinishGame(*Series);
+}
+
+void UBowlingTeamMatch::GameReset(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	const auto* Series = Components.Find(BowlingScoreComponent);
+	if (not ensure(Series)) { return; }
+
+	// A finished game stays counted and the next shot starts a new one, anything else is bowled over
+	Match.AbandonGame(*Series);
+}
+
+void UBowlingTeamMatch::BindComponent(UBowlingScoreComponent* BowlingScoreComponent, int32 Series)
+{
+	Components.Add(BowlingScoreComponent, Series);
+	BowlingScoreComponent->OnScoreChanged.AddUniqueDynamic(this, &UBowlingTeamMatch::ScoreChanged);
+	BowlingScoreComponent->OnGameOver.AddUniqueDynamic(this, &UBowlingTeamMatch::GameOver);
+	BowlingScoreComponent->OnReset.AddUniqueDynamic(this, &UBowlingTeamMatch::GameReset);
+
+	// Count a game that's already under way
+	if (BowlingScoreComponent->GetNumShotsRecorded() > 0)
+	{
+		UpdateGame(BowlingScoreComponent, Series);
+		if (BowlingScoreComponent->IsGameOver()) { Match.FinishGame(Series); }
+	}
+}
+
+void UBowlingTeamMatch::UpdateGame(UBowlingScoreComponent* BowlingScoreComponent, int32 Series)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingTeamMatch::UpdateGame);
+
+	// Totals as of the last shot come straight out of the component's history
+	int32 FrameTotals[FBowlingGameRecord::MaxFrames];
+	const auto NumShots = BowlingScoreComponent->GetNumShotsRecorded();
+	const auto NumFrames = FMath::Min(BowlingScoreComponent->GetNumFrames(), FBowlingGameRecord::MaxFrames);
+	for (auto Frame = 1; Frame <= NumFrames; Frame++)
+	{
+		FrameTotals[Frame - 1] = BowlingScoreComponent->GetScoreAt(NumShots, Frame);
+	}
+	Match.UpdateGame(Series, MakeArrayView(FrameTotals, NumFrames));
+}
@@ -0,0 +1,17 @@
+﻿// Partly Atomic LLC 2025
+#include "BowlingVariantScoreComponents.h"
+
+UNinePinScoreComponent::UNinePinScoreComponent()
+{
+	SetRuleSet(FBowlingRuleSet::Get<FNinePinRules>());
+}
+
+UFivePinScoreComponent::UFivePinScoreComponent()
+{
+	SetRuleSet(FBowlingRuleSet::Get<FFivePinRules>());
+}
+
+UCandlepinScoreComponent::UCandlepinScoreComponent()
+{
+	SetRuleSet(FBowlingRuleSet::Get<FCandlepinRules>());
+}
@@ -0,0 +1,54 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingFrameScore.generated.h"
+
+USTRUCT()
+struct BOWLINGSCORESYSTEM_API FBowlingFrameScore
+{
+	GENERATED_BODY()
+
+	FBowlingFrameScore();
+
+	// Utility constructor primarily for testing
+	FBowlingFrameScore(int32 Shot1, int32 Shot2);
+
+	// Utility constructor primarily for testing
+	FBowlingFrameScore(int32 Shot1, int32 Shot2, int32 Shot3);
+
+	TArray<int32, TInlineAllocator<3>> Shots;
+
+	// Pins knocked down by each shot, PinMaskBits per shot with bit 0 for pin 1. Shots recorded as a count alone have
+	// no bits set, and scoring only ever looks at Shots.
+	uint32 PinMasks = 0;
+
+	static constexpr int32 PinMaskBits = 10;
+	static constexpr uint16 FullPinMask = (1 << PinMaskBits) - 1;
+
+	// Pins next to each pin on the deck, in the same bits as a pin mask
+	static constexpr uint16 AdjacentPins[PinMaskBits] = {
+		0b0000000110, // 1: 2, 3
+		0b0000011101, // 2: 1, 3, 4, 5
+		0b0000110011, // 3: 1, 2, 5, 6
+		0b0011010010, // 4: 2, 5, 7, 8
+		0b0110101110, // 5: 2, 3, 4, 6, 8, 9
+		0b1100010100, // 6: 3, 5, 9, 10
+		0b0010001000, // 7: 4, 8
+		0b0101011000, // 8: 4, 5, 7, 9
+		0b1010110000, // 9: 5, 6, 8, 10
+		0b0100100000, // 10: 6, 9
+	};
+
+	uint16 GetPinMask(int32 ShotIdx) const
+	{
+		return static_cast<uint16>(PinMasks >> (ShotIdx * PinMaskBits)) & FullPinMask;
+	}
+
+	void SetPinMask(int32 ShotIdx, uint16 PinMask)
+	{
+		const auto Shift = ShotIdx * PinMaskBits;
+		PinMasks = (PinMasks & ~(uint32{FullPinMask} << Shift)) | (static_cast<uint32>(PinMask & FullPinMask) << Shift);
+	}
+};
@@ -0,0 +1,359 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingMemory.h"
+#include "BowlingRuleSets.h"
+
+/*
+ * Compressed completed games, split into blocks of GamesPerBlock games that can each be decoded on their own.
+ */
+struct BOWLINGSCORESYSTEM_API FBowlingGameArchive
+{
+	TArray<uint8> Data;
+
+	// Where each block starts in Data
+	TArray<uint32> BlockOffsets;
+
+	int32 NumGames = 0;
+	int32 GamesPerBlock = 64;
+
+	int32 GetNumBlocks() const { return BlockOffsets.Num(); }
+
+	// Remove every game, keeping GamesPerBlock
+	void Empty();
+
+	friend BOWLINGSCORESYSTEM_API FArchive& operator<<(FArchive& Ar, FBowlingGameArchive& Archive);
+};
+
+/*
+ * rANS codec for completed games of a rule set.
+ *
+ * Games are a packed shot stream, the pinfall of every shot actually thrown, one byte each and back to back. The
+ * rules decide when each game ends, so no lengths are stored. Each shot is coded with a model of the pins standing
+ * and which ball at the rack it is (fresh rack, second ball...), and only pinfall that IsValidShotScore would accept
+ * gets any probability, so nothing is spent on impossible shots.
+ *
+ * The model is counted from sample games with Train and must be shared by both ends, see SerializeModel.
+ */
+template <typename TRules>
+class TBowlingGameCodec
+{
+public:
+	using FScorer = TBowlingScorer<TRules>;
+
+	static constexpr int32 NumSymbols = TRules::NumPins + 1;
+	static constexpr int32 NumContexts = TRules::FinalFrameShots * NumSymbols;
+
+	static constexpr uint32 ProbBits = 12;
+	static constexpr uint32 ProbScale = 1u << ProbBits;
+
+	TBowlingGameCodec()
+	{
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+		Counts.SetNumZeroed(NumContexts * NumSymbols);
+		BuildTables();
+	}
+
+	// Append the shots thrown in a game to a packed shot stream
+	static void AppendGame(TConstArrayView<FBowlingFrameScore> Frames, TArray<uint8>& OutShots)
+	{
+		auto FrameIdx = 0;
+		auto ShotIdx = 0;
+		while (not FScorer::IsGameOver(FrameIdx))
+		{
+			OutShots.Add(static_cast<uint8>(Frames[FrameIdx].Shots[ShotIdx]));
+			FScorer::Advance(Frames, FrameIdx, ShotIdx);
+		}
+	}
+
+	// Add the pinfall in a sample of games to the model. Returns false if Shots aren't all complete, legal games.
+	bool Train(TConstArrayView<uint8> Shots)
+	{
+		FCursor Cursor;
+		auto bValid = true;
+		for (auto Pins : Shots)
+		{
+			const auto Rack = Cursor.GetRack();
+			if (Pins > Rack.Standing)
+			{
+				bValid = false;
+				break;
+			}
+			Counts[GetContext(Rack) * NumSymbols + Pins]++;
+			Cursor.Next(Pins);
+		}
+
+		BuildTables();
+		return bValid and Cursor.IsNewGame();
+	}
+
+	// Compress a packed shot stream into Archive, replacing anything already in it.
+	// Returns false if Shots aren't all complete, legal games.
+	bool Encode(TConstArrayView<uint8> Shots, FBowlingGameArchive& Archive) const
+	{
+		Archive.Empty();
+		Archive.GamesPerBlock = FMath::Max(1, Archive.GamesPerBlock);
+
+		// rANS encodes backwards, so each block's shots are collected before it's written
+		TArray<uint16> BlockEntries;
+		TArray<uint8> Scratch;
+		auto BlockGames = 0;
+
+		FCursor Cursor;
+		for (auto Pins : Shots)
+		{
+			const auto Rack = Cursor.GetRack();
+			if (Pins > Rack.Standing)
+			{
+				Archive.Empty();
+				return false;
+			}
+			BlockEntries.Add(static_cast<uint16>(GetContext(Rack) * NumSymbols + Pins));
+
+			if (Cursor.Next(Pins))
+			{
+				Archive.NumGames++;
+				if (++BlockGames == Archive.GamesPerBlock)
+				{
+					EncodeBlock(BlockEntries, Scratch, Archive);
+					BlockEntries.Reset();
+					BlockGames = 0;
+				}
+			}
+		}
+
+		if (not Cursor.IsNewGame())
+		{
+			Archive.Empty();
+			return false;
+		}
+
+		if (BlockGames > 0)
+		{
+			EncodeBlock(BlockEntries, Scratch, Archive);
+		}
+		return true;
+	}
+
+	// Decompress every game in a block, appending their shots to OutShots
+	bool DecodeBlock(const FBowlingGameArchive& Archive, int32 Block, TArray<uint8>& OutShots) const
+	{
+		return DecodeGames(Archive, Block, 0, Archive.GamesPerBlock, OutShots);
+	}
+
+	// Decompress one game, only touching the block it's in
+	bool DecodeGame(const FBowlingGameArchive& Archive, int32 Game, TArray<uint8>& OutShots) const
+	{
+		if (Game < 0 or Game >= Archive.NumGames) { return false; }
+
+		const auto Block = Game / Archive.GamesPerBlock;
+		const auto GameInBlock = Game % Archive.GamesPerBlock;
+		return DecodeGames(Archive, Block, GameInBlock, GameInBlock + 1, OutShots);
+	}
+
+	// Decompress every game in the archive
+	bool Decode(const FBowlingGameArchive& Archive, TArray<uint8>& OutShots) const
+	{
+		for (auto Block = 0; Block < Archive.GetNumBlocks(); Block++)
+		{
+			if (not DecodeBlock(Archive, Block, OutShots)) { return false; }
+		}
+		return true;
+	}
+
+	// Save or load the model's counts
+	void SerializeModel(FArchive& Ar)
+	{
+		Ar << Counts;
+		if (Ar.IsLoading())
+		{
+			if (Counts.Num() != NumContexts * NumSymbols)
+			{
+				Ar.SetError();
+				Counts.Init(0, NumContexts * NumSymbols);
+			}
+			BuildTables();
+		}
+	}
+
+private:
+	static constexpr uint32 RansL = 1u << 23;
+
+	// Walks the rules of a game shot by shot, starting over once it's finished
+	struct FCursor
+	{
+		FBowlingFrameScore Frame{0, 0, 0};
+		int32 FrameIdx = 0;
+		int32 ShotIdx = 0;
+
+		FBowlingRack GetRack() const { return FScorer::GetRack(Frame, ShotIdx); }
+
+		bool IsNewGame() const { return FrameIdx == 0 and ShotIdx == 0; }
+
+		// Record a shot, returns true if it finished the game
+		bool Next(int32 Pins)
+		{
+			Frame.Shots[ShotIdx] = Pins;
+			if (FScorer::IsShotAllowed(Frame, FrameIdx, ShotIdx + 1))
+			{
+				ShotIdx++;
+				return false;
+			}
+
+			FMemory::Memzero(Frame.Shots.GetData(), Frame.Shots.Num() * Frame.Shots.GetTypeSize());
+			ShotIdx = 0;
+			if (++FrameIdx < TRules::NumFrames) { return false; }
+
+			FrameIdx = 0;
+			return true;
+		}
+	};
+
+	static int32 GetContext(const FBowlingRack& Rack)
+	{
+		return Rack.Ball * NumSymbols + Rack.Standing;
+	}
+
+	// Quantize the counts into frequencies, giving every legal pinfall at least some probability
+	void BuildTables()
+	{
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+		Freqs.SetNumUninitialized(NumContexts * NumSymbols);
+		CumFreqs.SetNumUninitialized(NumContexts * NumSymbols);
+		SlotSymbols.SetNumUninitialized(NumContexts * ProbScale);
+
+		for (auto Context = 0; Context < NumContexts; Context++)
+		{
+			const auto Standing = Context % NumSymbols;
+			const auto NumLegal = Standing + 1;
+			const auto* ContextCounts = &Counts[Context * NumSymbols];
+			auto* ContextFreqs = &Freqs[Context * NumSymbols];
+
+			uint64 Total = 0;
+			for (auto Pins = 0; Pins < NumLegal; Pins++)
+			{
+				Total += ContextCounts[Pins] + 1;
+			}
+
+			const uint64 Budget = ProbScale - NumLegal;
+			uint32 Sum = 0;
+			auto MostLikely = 0;
+			for (auto Pins = 0; Pins < NumSymbols; Pins++)
+			{
+				const auto Freq = Pins < NumLegal
+					? static_cast<uint32>(1 + (ContextCounts[Pins] + 1) * Budget / Total)
+					: 0u;
+				ContextFreqs[Pins] = static_cast<uint16>(Freq);
+				Sum += Freq;
+				if (Freq > ContextFreqs[MostLikely]) { MostLikely = Pins; }
+			}
+			ContextFreqs[MostLikely] += static_cast<uint16>(ProbScale - Sum);
+
+			auto Start = 0u;
+			for (auto Pins = 0; Pins < NumSymbols; Pins++)
+			{
+				CumFreqs[Context * NumSymbols + Pins] = static_cast<uint16>(Start);
+				for (auto Slot = Start; Slot < Start + ContextFreqs[Pins]; Slot++)
+				{
+					SlotSymbols[Context * ProbScale + Slot] = static_cast<uint8>(Pins);
+				}
+				Start += ContextFreqs[Pins];
+			}
+		}
+	}
+
+	void EncodeBlock(TConstArrayView<uint16> Entries, TArray<uint8>& Scratch, FBowlingGameArchive& Archive) const
+	{
+		// Each shot is at most two bytes at 12 bit probabilities, plus the final state
+		Scratch.SetNumUninitialized(Entries.Num() * 2 + 4, EAllowShrinking::No);
+		auto* End = Scratch.GetData() + Scratch.Num();
+		auto* Ptr = End;
+
+		uint32 State = RansL;
+		for (auto Idx = Entries.Num() - 1; Idx >= 0; Idx--)
+		{
+			const uint32 Freq = Freqs[Entries[Idx]];
+			const uint32 Start = CumFreqs[Entries[Idx]];
+
+			const auto StateMax = ((RansL >> ProbBits) << 8) * Freq;
+			while (State >= StateMax)
+			{
+				*--Ptr = static_cast<uint8>(State & 0xff);
+				State >>= 8;
+			}
+			State = ((State / Freq) << ProbBits) + (State % Freq) + Start;
+		}
+
+		Ptr -= 4;
+		for (auto Byte = 0; Byte < 4; Byte++)
+		{
+			Ptr[Byte] = static_cast<uint8>(State >> (Byte * 8));
+		}
+
+		Archive.BlockOffsets.Add(static_cast<uint32>(Archive.Data.Num()));
+		Archive.Data.Append(Ptr, static_cast<int32>(End - Ptr));
+	}
+
+	// Decode a block up to LastGame, keeping the shots from FirstGame on
+	bool DecodeGames(const FBowlingGameArchive& Archive, int32 Block, int32 FirstGame, int32 LastGame,
+	                 TArray<uint8>& OutShots) const
+	{
+		if (not Archive.BlockOffsets.IsValidIndex(Block)) { return false; }
+
+		const auto NumGames = FMath::Min(Archive.GamesPerBlock, Archive.NumGames - Block * Archive.GamesPerBlock);
+		LastGame = FMath::Min(LastGame, NumGames);
+
+		const auto* Ptr = Archive.Data.GetData() + Archive.BlockOffsets[Block];
+		const auto* End = Archive.BlockOffsets.IsValidIndex(Block + 1)
+			? Archive.Data.GetData() + Archive.BlockOffsets[Block + 1]
+			: Archive.Data.GetData() + Archive.Data.Num();
+		if (End - Ptr < 4) { return false; }
+
+		uint32 State = 0;
+		for (auto Byte = 0; Byte < 4; Byte++)
+		{
+			State |= static_cast<uint32>(*Ptr++) << (Byte * 8);
+		}
+
+		FCursor Cursor;
+		for (auto Game = 0; Game < LastGame;)
+		{
+			const auto Context = GetContext(Cursor.GetRack());
+			const auto Slot = State & (ProbScale - 1);
+			const auto Pins = SlotSymbols[Context * ProbScale + Slot];
+			const auto Entry = Context * NumSymbols + Pins;
+
+			State = Freqs[Entry] * (State >> ProbBits) + Slot - CumFreqs[Entry];
+			while (State < RansL)
+			{
+				if (Ptr == End) { return false; }
+				State = (State << 8) | *Ptr++;
+			}
+
+			if (Game >= FirstGame)
+			{
+				OutShots.Add(Pins);
+			}
+			if (Cursor.Next(Pins))
+			{
+				Game++;
+			}
+		}
+
+		return true;
+	}
+
+	// Shots seen in training for each context and pinfall
+	TArray<uint32> Counts;
+
+	// Quantized model, ProbScale in total for each context
+	TArray<uint16> Freqs;
+	TArray<uint16> CumFreqs;
+
+	// Pinfall for every slot of every context, for decoding in one lookup
+	TArray<uint8> SlotSymbols;
+};
+
+using FBowlingGameCodec = TBowlingGameCodec<FTenPinRules>;
@@ -0,0 +1,108 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include <coroutine>
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UBowlingScoreComponent;
+
+/*
+ * Coroutine support for writing scripted bowlers, tutorials and AI opponents as straight-line code instead of delegate
+ * handlers:
+ *
+ *   FBowlingGameFlow BowlGame(UBowlingScoreComponent* Bowling)
+ *   {
+ *       while (not Bowling->IsGameOver())
+ *       {
+ *           const auto Request = co_await Bowling->NextShotRequest();
+ *           if (Request.IsGameOver()) { break; }
+ *           Bowling->SetScore(PickPinfall(Request.PinsStanding));
+ *       }
+ *       const auto Score = co_await Bowling->GameOver();
+ *   }
+ *
+ * Coroutines run on the game thread. Every co_await suspends and is resumed by a game thread task, never from inside
+ * the component's own broadcasts, so a coroutine can bowl again as soon as it's resumed. Nothing ticks or polls while
+ * it waits.
+ */
+
+// Fire and forget coroutine, started as soon as it's called and freed when it finishes
+struct FBowlingGameFlow
+{
+	struct promise_type
+	{
+		FBowlingGameFlow get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { checkNoEntry(); }
+	};
+};
+
+// The shot a game is waiting for
+struct FBowlingShotRequest
+{
+	// Frame and shot starting from 1, -1 once the game is over
+	int32 Frame = -1;
+	int32 Shot = -1;
+
+	int32 PinsStanding = 0;
+
+	bool IsGameOver() const { return Frame < 0; }
+};
+
+// Waits on a game, see UBowlingScoreComponent::NextShotRequest and UBowlingScoreComponent::GameOver
+class BOWLINGSCORESYSTEM_API FBowlingGameAwaiter
+{
+public:
+	FBowlingGameAwaiter(const FBowlingGameAwaiter&) = delete;
+	FBowlingGameAwaiter& operator=(const FBowlingGameAwaiter&) = delete;
+	~FBowlingGameAwaiter();
+
+	bool await_ready() const { return false; }
+	void await_suspend(std::coroutine_handle<> InHandle);
+
+protected:
+	enum class EWaitFor : uint8
+	{
+		// A game in progress is always waiting for a shot, a finished one is once it's reset
+		ShotRequest,
+		GameOver,
+	};
+
+	FBowlingGameAwaiter(UBowlingScoreComponent& InBowlingScoreComponent, EWaitFor InWaitFor);
+
+	bool IsReady() const;
+	void GameStateChanged(UBowlingScoreComponent* InBowlingScoreComponent);
+
+	// Resume on the game thread in a task of its own
+	void Resume();
+
+	TWeakObjectPtr<UBowlingScoreComponent> BowlingScoreComponent;
+	EWaitFor WaitFor;
+	std::coroutine_handle<> Handle;
+	FDelegateHandle GameStateChangedHandle;
+};
+
+class BOWLINGSCORESYSTEM_API FBowlingShotRequestAwaiter : public FBowlingGameAwaiter
+{
+public:
+	explicit FBowlingShotRequestAwaiter(UBowlingScoreComponent& InBowlingScoreComponent)
+		: FBowlingGameAwaiter(InBowlingScoreComponent, EWaitFor::ShotRequest) {}
+
+	// The shot the game is waiting for when the coroutine resumes, or game over if it was destroyed
+	FBowlingShotRequest await_resume() const;
+};
+
+class BOWLINGSCORESYSTEM_API FBowlingGameOverAwaiter : public FBowlingGameAwaiter
+{
+public:
+	explicit FBowlingGameOverAwaiter(UBowlingScoreComponent& InBowlingScoreComponent)
+		: FBowlingGameAwaiter(InBowlingScoreComponent, EWaitFor::GameOver) {}
+
+	// Final score, 0 if the game was destroyed before it finished
+	int32 await_resume() const;
+};
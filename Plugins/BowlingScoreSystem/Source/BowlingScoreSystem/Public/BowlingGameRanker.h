@@ -0,0 +1,178 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingMemory.h"
+#include "BowlingRuleSets.h"
+
+/*
+ * Numbers every legal game of a rule set, giving each one a dense id in [0, GetNumGames()). Gutter games are 0 and
+ * perfect games are GetNumGames() - 1.
+ *
+ * Frames are scored independently, so a game's id is a mixed radix number with one digit per frame. Each frame's
+ * digit comes from a tree of every legal way to bowl the frame, built from the rule set's own validation, where each
+ * shot stores the number of frames ordered ahead of it. Ranking and unranking a game is one step per shot.
+ *
+ * Only rule sets whose games fit in 64 bits are supported (ten-pin and nine-pin, not the three ball games).
+ */
+template <typename TRules>
+class TBowlingGameRanker
+{
+public:
+	using FScorer = TBowlingScorer<TRules>;
+
+	TBowlingGameRanker()
+	{
+		LLM_SCOPE_BYTAG(Bowling_Caches);
+		FrameRoots[0] = BuildTree(0);
+		FrameRoots[1] = BuildTree(FScorer::FinalFrameIdx);
+
+		// Number of games that can follow each frame
+		uint64 Games = 1;
+		for (auto FrameIdx = FScorer::NumFrames - 1; FrameIdx >= 0; FrameIdx--)
+		{
+			SuffixGames[FrameIdx] = Games;
+			const auto FrameCount = Nodes[GetRoot(FrameIdx)].Count;
+			if (Games > MAX_uint64 / FrameCount)
+			{
+				bSupported = false;
+				return;
+			}
+			Games *= FrameCount;
+		}
+		NumGames = Games;
+		bSupported = true;
+	}
+
+	// Whether every game's id fits in 64 bits
+	bool IsSupported() const { return bSupported; }
+
+	// Number of legal games. Returns 0 if the rule set isn't supported.
+	uint64 GetNumGames() const { return bSupported ? NumGames : 0; }
+
+	// Get the id of one complete game as a packed shot stream (see TBowlingGameCodec).
+	// Returns false if the shots aren't exactly one complete, legal game.
+	bool Rank(TConstArrayView<uint8> Shots, uint64& OutId) const
+	{
+		if (not bSupported) { return false; }
+
+		uint64 Id = 0;
+		auto ShotIdx = 0;
+		for (auto FrameIdx = 0; FrameIdx < FScorer::NumFrames; FrameIdx++)
+		{
+			uint64 FrameRank = 0;
+			for (auto NodeIdx = GetRoot(FrameIdx); Nodes[NodeIdx].NumChildren > 0;)
+			{
+				if (not Shots.IsValidIndex(ShotIdx)) { return false; }
+
+				const auto Pins = Shots[ShotIdx++];
+				if (Pins >= Nodes[NodeIdx].NumChildren) { return false; }
+
+				NodeIdx = Nodes[NodeIdx].FirstChild + Pins;
+				FrameRank += Nodes[NodeIdx].Ahead;
+			}
+			Id += FrameRank * SuffixGames[FrameIdx];
+		}
+
+		OutId = Id;
+		return ShotIdx == Shots.Num();
+	}
+
+	// Get the game with an id, appending its shots to OutShots as a packed shot stream.
+	// Returns false if the id is out of range.
+	bool Unrank(uint64 Id, TArray<uint8>& OutShots) const
+	{
+		if (Id >= GetNumGames()) { return false; }
+
+		for (auto FrameIdx = 0; FrameIdx < FScorer::NumFrames; FrameIdx++)
+		{
+			auto FrameRank = Id / SuffixGames[FrameIdx];
+			Id %= SuffixGames[FrameIdx];
+
+			for (auto NodeIdx = GetRoot(FrameIdx); Nodes[NodeIdx].NumChildren > 0;)
+			{
+				// Pinfall of the last sibling with no more than the rank ahead of it
+				const auto FirstChild = Nodes[NodeIdx].FirstChild;
+				auto Pins = Nodes[NodeIdx].NumChildren - 1;
+				while (Nodes[FirstChild + Pins].Ahead > FrameRank)
+				{
+					Pins--;
+				}
+
+				NodeIdx = FirstChild + Pins;
+				FrameRank -= Nodes[NodeIdx].Ahead;
+				OutShots.Add(static_cast<uint8>(Pins));
+			}
+		}
+
+		return true;
+	}
+
+private:
+	// A shot in the tree of legal frames. Children are the next shot's pinfall, in order, one for each legal count.
+	struct FNode
+	{
+		// Ways to finish the frame from here
+		uint64 Count = 0;
+
+		// Ways to bowl the frame that come before this shot among its siblings
+		uint64 Ahead = 0;
+
+		int32 FirstChild = INDEX_NONE;
+		int32 NumChildren = 0;
+	};
+
+	int32 GetRoot(int32 FrameIdx) const
+	{
+		return FrameRoots[FrameIdx == FScorer::FinalFrameIdx ? 1 : 0];
+	}
+
+	int32 BuildTree(int32 FrameIdx)
+	{
+		const auto Root = Nodes.AddDefaulted();
+		FBowlingFrameScore Frame(0, 0, 0);
+		BuildNode(Root, Frame, FrameIdx, 0);
+		return Root;
+	}
+
+	void BuildNode(int32 NodeIdx, FBowlingFrameScore& Frame, int32 FrameIdx, int32 ShotIdx)
+	{
+		if (not FScorer::IsShotAllowed(Frame, FrameIdx, ShotIdx))
+		{
+			// Frame is finished
+			Nodes[NodeIdx].Count = 1;
+			return;
+		}
+
+		const auto NumChildren = FScorer::GetRack(Frame, ShotIdx).Standing + 1;
+		const auto FirstChild = Nodes.AddDefaulted(NumChildren);
+		Nodes[NodeIdx].FirstChild = FirstChild;
+		Nodes[NodeIdx].NumChildren = NumChildren;
+
+		uint64 Count = 0;
+		for (auto Pins = 0; Pins < NumChildren; Pins++)
+		{
+			Frame.Shots[ShotIdx] = Pins;
+			BuildNode(FirstChild + Pins, Frame, FrameIdx, ShotIdx + 1);
+			Nodes[FirstChild + Pins].Ahead = Count;
+			Count += Nodes[FirstChild + Pins].Count;
+		}
+		Frame.Shots[ShotIdx] = 0;
+
+		Nodes[NodeIdx].Count = Count;
+	}
+
+	TArray<FNode> Nodes;
+
+	// Trees for the regular frames and the final frame
+	int32 FrameRoots[2] = {};
+
+	// Games that can follow each frame, the place value of each frame's digit
+	uint64 SuffixGames[FScorer::NumFrames] = {};
+
+	uint64 NumGames = 0;
+	bool bSupported = false;
+};
+
+using FBowlingGameRanker = TBowlingGameRanker<FTenPinRules>;
@@ -0,0 +1,66 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BowlingLaneServerCommandlet.generated.h"
+
+class IFileHandle;
+class UBowlingScoreComponent;
+class UBowlingShotLog;
+
+/**
+ * Headless scoring backend for a whole center. Hosts one UBowlingScoreComponent per lane without a world,
+ * player or any UI, reads shots from an input file and publishes lane state as JSON lines. Nothing in this module
+ * depends on UMG or Slate, so running it doesn't load them (the scorecards are in BowlingScoreUI).
+ *
+ * Usage: -run=BowlingLaneServer -Input=<Path> [-Output=<Path>] [-Lanes=<Num>] [-Follow] [-PollInterval=<Seconds>]
+ *        [-ShotLog=<Path>] [-RuleSet=<TenPin|NinePin|FivePin|Candlepin|Duckpin>]
+ *
+ * With -ShotLog, every shot is written to a crash-safe log and games in progress are restored from it on startup.
+ * Reading the input then resumes just after the last line the log has a shot for, so restarting with the same input
+ * doesn't apply any of it twice.
+ *
+ * Duckpin lanes are scored by the candlepin rules, see FCandlepinRules.
+ *
+ * Input is one command per line:
+ *   <Lane> <Pins>   Record a shot for a lane (lanes are numbered from 1)
+ *   <Lane> reset    Start a new game on a lane
+ *   quit            Stop the server (only needed with -Follow)
+ */
+UCLASS()
+class BOWLINGSCORESYSTEM_API UBowlingLaneServerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingLaneServerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	// Read whatever has been appended to the input since the last call and apply complete lines.
+	// Returns false once a quit command has been read.
+	bool ReadInput(IFileHandle& InputHandle);
+
+	// Apply one line of input, returns false on a quit command
+	bool ApplyCommand(const FString& Line);
+
+	// Write the lane's current state to the output
+	void PublishLane(int32 LaneIdx);
+
+	UPROPERTY()
+	TArray<TObjectPtr<UBowlingScoreComponent>> Lanes;
+
+	UPROPERTY()
+	TObjectPtr<UBowlingShotLog> ShotLog;
+
+	// Partial line left over from the last read
+	TArray<ANSICHAR> PendingInput;
+
+	// Reused for every published line to avoid reallocating per shot
+	FString PublishBuffer;
+
+	TUniquePtr<IFileHandle> OutputHandle;
+};
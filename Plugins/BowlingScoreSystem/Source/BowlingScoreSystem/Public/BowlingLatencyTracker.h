@@ -0,0 +1,132 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UBowlingScoreComponent;
+
+// Points a shot passes on its way to the screen, each timed from the shot arriving in SetScore
+enum class EBowlingLatencyStage : uint8
+{
+	// Game state updated, nothing told yet
+	Recorded,
+	// UBowlingScoreWidget::GameAdvanced finished refreshing the scorecard
+	GameAdvanced,
+	// First UBowlingFrameWidget::UpdateScore for the shot finished
+	UpdateScore,
+	// Every listener has been told
+	Broadcast,
+	// The render thread reached the first frame drawn after the shot
+	Rendered,
+	Num
+};
+
+/*
+ * Log-linear histogram of latencies in microseconds, in the style of HdrHistogram: values are bucketed exactly below
+ * 32us, then every power of two is split into 32 buckets, so any value is reported within about 3%.
+ *
+ * Recording is a single relaxed atomic increment, so any thread can record while another reads.
+ */
+class BOWLINGSCORESYSTEM_API FBowlingLatencyHistogram
+{
+public:
+	static constexpr int32 SubBucketBits = 5;
+	static constexpr int32 SubBuckets = 1 << SubBucketBits;
+	static constexpr int32 NumBuckets = (32 - SubBucketBits + 1) * SubBuckets;
+
+	void Record(uint64 Micros);
+
+	uint64 GetCount() const;
+
+	// Get the latency that Percentile (0 to 1) of recordings were at or under, as the top of its bucket.
+	// Returns 0 if nothing has been recorded.
+	uint64 GetPercentile(double Percentile) const;
+
+	void Reset();
+
+	static int32 GetBucket(uint32 Micros);
+
+	// Smallest and largest latency in a bucket
+	static uint32 GetBucketMin(int32 Bucket);
+	static uint32 GetBucketMax(int32 Bucket);
+
+private:
+	std::atomic<uint32> Counts[NumBuckets] = {};
+};
+
+/*
+ * Shot-to-pixel latency of every lane, a histogram per stage.
+ *
+ * Off unless Bowling.Latency.Enabled is set. Stages are recorded once per shot, the first time each is reached.
+ * Percentiles are printed with the Bowling.Latency console command and written out as CSV with Bowling.Latency.Dump.
+ * A lane's recordings are thrown away with its component. Shots are only timed to the screen once something that draws
+ * frames has set a render fence, BowlingScoreUI does.
+ */
+class BOWLINGSCORESYSTEM_API FBowlingLatencyTracker
+{
+public:
+	static FBowlingLatencyTracker& Get();
+
+	// Record a stage for the lane's latest shot. Game thread only.
+	void Record(const UBowlingScoreComponent& BowlingScoreComponent, EBowlingLatencyStage Stage);
+
+	const FBowlingLatencyHistogram* Find(const UBowlingScoreComponent& BowlingScoreComponent,
+	                                     EBowlingLatencyStage Stage) const;
+
+	// Forget a lane whose component is going away
+	void Remove(const UBowlingScoreComponent& BowlingScoreComponent);
+
+	// Shots never timed to the screen because too many were waiting on one frame
+	uint64 GetNumUntimedRenders() const { return NumUntimedRenders; }
+
+	// Print p50/p99/p999 of every stage of every lane
+	void Report(FOutputDevice& Ar) const;
+
+	// Write every stage of every lane as CSV. Returns false if the file couldn't be written.
+	bool DumpCsv(const FString& Path) const;
+
+	// Throw away every recording
+	void Reset();
+
+	// Set how to run a function on the render thread once it has drawn the frame it was handed over in, or null when
+	// nothing draws frames any more
+	void SetRenderFence(TFunction<void(TFunction<void()>&& OnceDrawn)>&& InRenderFence);
+
+	static const TCHAR* GetStageName(EBowlingLatencyStage Stage);
+
+private:
+	FBowlingLatencyTracker();
+
+	struct FLane
+	{
+		FString Name;
+		FBowlingLatencyHistogram Histograms[static_cast<int32>(EBowlingLatencyStage::Num)];
+
+		// Arrival of the last shot each stage was recorded for, so later calls for the same shot are skipped
+		uint64 RecordedArrivals[static_cast<int32>(EBowlingLatencyStage::Num)] = {};
+	};
+
+	using FLaneRef = TSharedRef<FLane, ESPMode::ThreadSafe>;
+
+	FLaneRef FindOrAddLane(const UBowlingScoreComponent& BowlingScoreComponent);
+
+	// Hand the shots waiting to be drawn to the render fence, which times them once this frame is drawn
+	void EndFrame();
+
+	void ForEachLane(TFunctionRef<void(const FLane& Lane)> Visit) const;
+
+	TMap<TObjectKey<UBowlingScoreComponent>, FLaneRef> Lanes;
+
+	static constexpr int32 MaxPendingRender = 256;
+
+	// Shots recorded since the last frame, with when they arrived
+	TArray<TPair<FLaneRef, uint64>> PendingRender;
+
+	uint64 NumUntimedRenders = 0;
+
+	TFunction<void(TFunction<void()>&& OnceDrawn)> RenderFence;
+};
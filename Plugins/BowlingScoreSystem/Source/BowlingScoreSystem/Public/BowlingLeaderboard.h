@@ -0,0 +1,143 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BowlingLeaderboard.generated.h"
+
+class UBowlingScoreComponent;
+
+USTRUCT(BlueprintType)
+struct BOWLINGSCORESYSTEM_API FBowlingLeaderboardEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 BowlerId = INDEX_NONE;
+
+	// Score of the game in progress
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 CurrentScore = 0;
+
+	// Best final score the game in progress can still reach
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 MaxPossibleScore = 0;
+
+	// Total of all completed games
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 SeriesTotal = 0;
+
+	// Leaderboard position is decided by total pinfall so far
+	int32 GetTotal() const { return SeriesTotal + CurrentScore; }
+};
+
+/*
+ * Order statistic index of bowlers, implemented as an indexed skip list so standings never need to be re-sorted.
+ * Bowlers are ordered by total pinfall (highest first) with ties broken by bowler id.
+ * Updates and rank lookups are O(log n), range queries are O(log n + Count).
+ */
+class BOWLINGSCORESYSTEM_API FBowlingLeaderboard
+{
+public:
+	explicit FBowlingLeaderboard(int32 RandomSeed = 0);
+
+	// Add a bowler or update their existing entry
+	void Update(const FBowlingLeaderboardEntry& Entry);
+
+	// Returns whether the bowler was on the leaderboard
+	bool Remove(int32 BowlerId);
+
+	const FBowlingLeaderboardEntry* Find(int32 BowlerId) const;
+
+	// Get a bowler's position, starting from 1. Returns INDEX_NONE if the bowler isn't on the leaderboard.
+	int32 GetRank(int32 BowlerId) const;
+
+	// Get Count entries starting at position FirstRank (starting from 1), e.g. positions 50-60 or the top K
+	void GetRange(int32 FirstRank, int32 Count, TArray<FBowlingLeaderboardEntry>& OutEntries) const;
+
+	int32 Num() const { return BowlerNodes.Num(); }
+
+	void Empty();
+
+private:
+	static constexpr int32 MaxLevel = 16;
+
+	struct FNode
+	{
+		FBowlingLeaderboardEntry Entry;
+		int32 Level = 0;
+		// Next node on each level
+		int32 Next[MaxLevel];
+		// Number of positions skipped when following Next on each level
+		int32 Span[MaxLevel];
+	};
+
+	// Whether A is placed ahead of B
+	static bool IsAhead(const FBowlingLeaderboardEntry& A, const FBowlingLeaderboardEntry& B);
+
+	void Insert(const FBowlingLeaderboardEntry& Entry);
+	void Erase(const FBowlingLeaderboardEntry& Entry);
+	int32 AllocateNode(const FBowlingLeaderboardEntry& Entry, int32 Level);
+	int32 GetNodeAtRank(int32 Rank) const;
+	int32 RandomLevel();
+
+	// Node 0 is the head of the list and never holds an entry
+	static constexpr int32 HeadNode = 0;
+
+	TArray<FNode> Nodes;
+	TArray<int32> FreeNodes;
+	TMap<int32, int32> BowlerNodes;
+	int32 Level = 1;
+	FRandomStream RandomStream;
+};
+
+/*
+ * Live leaderboard for a tournament or center, fed by score changes from each bowler's UBowlingScoreComponent.
+ * Completed games are rolled into each bowler's series total.
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCORESYSTEM_API UBowlingLeaderboard : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Start tracking a bowler's games
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddBowler(UBowlingScoreComponent* BowlingScoreComponent, int32 BowlerId);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveBowler(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Get a bowler's position, starting from 1. Returns -1 if the bowler isn't on the leaderboard.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetRank(int32 BowlerId) const;
+
+	// Get Count entries starting at position FirstRank (starting from 1)
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	TArray<FBowlingLeaderboardEntry> GetRange(int32 FirstRank, int32 Count) const;
+
+	// Get the top K bowlers
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	TArray<FBowlingLeaderboardEntry> GetTop(int32 K) const;
+
+	const FBowlingLeaderboard& GetStandings() const { return Standings; }
+
+protected:
+	UFUNCTION()
+	void ScoreChanged(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame);
+
+	UFUNCTION()
+	void GameOver(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UFUNCTION()
+	void GameReset(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Copy the game in progress into the bowler's entry
+	void UpdateCurrentGame(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UBowlingScoreComponent>, int32> Bowlers;
+
+	FBowlingLeaderboard Standings;
+};
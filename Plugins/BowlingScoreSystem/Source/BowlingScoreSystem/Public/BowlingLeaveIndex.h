@@ -0,0 +1,151 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BowlingLeaveIndex.generated.h"
+
+class UBowlingScoreComponent;
+
+/*
+ * A set of leaves, the pins left standing after the first ball at a rack. Leaves are pin masks (see
+ * FBowlingFrameScore::PinMasks), so there are 1024 of them and a set is one bit for each.
+ */
+struct BOWLINGSCORESYSTEM_API FBowlingLeaveSet
+{
+	static constexpr int32 NumLeaves = 1024;
+	static constexpr int32 NumWords = NumLeaves / 64;
+
+	uint64 Words[NumWords] = {};
+
+	// Just the one leave
+	static FBowlingLeaveSet Only(uint16 Leave);
+
+	// Every leave with all of these pins standing, e.g. Containing(1 << 9) for leaves with the 10 pin
+	static FBowlingLeaveSet Containing(uint16 Pins);
+
+	// Every split: the head pin is down and the pins left aren't next to each other
+	static const FBowlingLeaveSet& Splits();
+
+	static bool IsSplit(uint16 Leave);
+
+	bool Contains(uint16 Leave) const { return Leave < NumLeaves and (Words[Leave / 64] >> (Leave % 64)) & 1; }
+
+	void Add(uint16 Leave) { Words[Leave / 64] |= uint64{1} << (Leave % 64); }
+
+	int32 Num() const;
+
+	FBowlingLeaveSet operator&(const FBowlingLeaveSet& Other) const;
+	FBowlingLeaveSet operator|(const FBowlingLeaveSet& Other) const;
+
+	// Call Visit with every leave in the set, lowest first
+	template <typename TVisitor>
+	void ForEach(TVisitor&& Visit) const
+	{
+		for (auto Word = 0; Word < NumWords; Word++)
+		{
+			for (auto Bits = Words[Word]; Bits != 0; Bits &= Bits - 1)
+			{
+				Visit(static_cast<uint16>(Word * 64 + FMath::CountTrailingZeros64(Bits)));
+			}
+		}
+	}
+};
+
+USTRUCT(BlueprintType)
+struct BOWLINGSCORESYSTEM_API FBowlingLeaveStats
+{
+	GENERATED_BODY()
+
+	// Times a leave was bowled at
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 Attempts = 0;
+
+	// Times it was picked up for a spare
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 Conversions = 0;
+
+	float GetConversionRate() const { return Attempts > 0 ? static_cast<float>(Conversions) / Attempts : 0.0f; }
+};
+
+/*
+ * Leave and spare conversion counts for every bowler and league, and for everyone together.
+ *
+ * Counts are stored by column, an attempts and a conversions count for each of the 1024 leaves, so a query over a set
+ * of leaves is one pass over two arrays with every leave not in the set masked out. There are no branches in that
+ * pass for the compiler to trip over when it vectorizes it.
+ */
+class BOWLINGSCORESYSTEM_API FBowlingLeaveIndex
+{
+public:
+	FBowlingLeaveIndex();
+
+	// Count a second ball at a leave, and whether it picked the leave up
+	void Record(int32 BowlerId, FName League, uint16 Leave, bool bConverted);
+
+	FBowlingLeaveStats GetBowlerStats(int32 BowlerId, const FBowlingLeaveSet& Leaves) const;
+	FBowlingLeaveStats GetLeagueStats(FName League, const FBowlingLeaveSet& Leaves) const;
+	FBowlingLeaveStats GetTotalStats(const FBowlingLeaveSet& Leaves) const;
+
+	// Leaves a bowler or league has bowled at, e.g. for a report of every split they've left
+	FBowlingLeaveSet GetBowlerLeaves(int32 BowlerId) const;
+	FBowlingLeaveSet GetLeagueLeaves(FName League) const;
+
+	void Empty();
+
+private:
+	struct FColumns
+	{
+		uint32 Attempts[FBowlingLeaveSet::NumLeaves] = {};
+		uint32 Conversions[FBowlingLeaveSet::NumLeaves] = {};
+	};
+
+	static FBowlingLeaveStats Sum(const FColumns& Columns, const FBowlingLeaveSet& Leaves);
+	static FBowlingLeaveSet GetLeaves(const FColumns& Columns);
+
+	FColumns& FindOrAddColumns(int32& ColumnsIdx);
+
+	// Everyone's counts come first
+	TArray<FColumns> Columns;
+	TMap<int32, int32> BowlerColumns;
+	TMap<FName, int32> LeagueColumns;
+};
+
+/*
+ * Leave index fed by each bowler's UBowlingScoreComponent. Second balls at a rack are counted as they're recorded,
+ * as long as the first ball was recorded with its pins (see UBowlingScoreComponent::SetPinMask).
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCORESYSTEM_API UBowlingLeaveIndex : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Start counting a bowler's leaves, under their league as well
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddBowler(UBowlingScoreComponent* BowlingScoreComponent, int32 BowlerId, FName League);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveBowler(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// A bowler's counts for one leave, as a pin mask
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	FBowlingLeaveStats GetLeaveStats(int32 BowlerId, int32 Leave) const;
+
+	// A bowler's counts for every split together
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	FBowlingLeaveStats GetSplitStats(int32 BowlerId) const;
+
+	const FBowlingLeaveIndex& GetIndex() const { return Index; }
+
+protected:
+	void ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UBowlingScoreComponent>, int32> Bowlers;
+
+	TMap<int32, FName> BowlerLeagues;
+
+	FBowlingLeaveIndex Index;
+};
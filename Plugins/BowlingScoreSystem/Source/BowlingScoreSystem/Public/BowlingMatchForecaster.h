@@ -0,0 +1,136 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "BowlingRuleSets.h"
+#include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
+#include "BowlingMatchForecaster.generated.h"
+
+class UBowlingScoreComponent;
+
+USTRUCT(BlueprintType)
+struct BOWLINGSCORESYSTEM_API FBowlingForecast
+{
+	GENERATED_BODY()
+
+	// Chance of each bowler in the match winning, ties are split between the tied bowlers
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	TArray<float> WinProbabilities;
+
+	// Average final score of each bowler in the match
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	TArray<float> ExpectedScores;
+
+	// Games simulated so far, the forecast is refined as more come in
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 NumSimulations = 0;
+};
+
+// A bowler's game copied off the game thread for simulation
+struct FBowlingGameSnapshot
+{
+	TArray<FBowlingFrameScore> Frames;
+	int32 FrameIdx = 0;
+	int32 ShotIdx = 0;
+	const FBowlingRuleSet* RuleSet = nullptr;
+
+	static FBowlingGameSnapshot Capture(const UBowlingScoreComponent& BowlingScoreComponent);
+};
+
+// Shared with a match's simulations in flight, which stop as soon as the generation moves on
+struct FBowlingForecastControl
+{
+	std::atomic<uint32> Generation = 0;
+};
+
+USTRUCT()
+struct FBowlingForecastMatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UBowlingScoreComponent>> Bowlers;
+
+	FBowlingForecast Forecast;
+
+	TSharedPtr<FBowlingForecastControl, ESPMode::ThreadSafe> Control;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBowlingForecastUpdatedSignature, int32, MatchId, const FBowlingForecast&, Forecast);
+
+/*
+ * Live win odds for matches, estimated by playing out the rest of each game many times on worker threads.
+ *
+ * Every shot in a match cancels its simulations in flight and starts over from the new scores. Each match runs
+ * one chunk of simulations at a time, queueing the next chunk behind everyone else's when it finishes, so hundreds
+ * of matches take turns on the task pool instead of the first ones starving the rest. Forecasts are refined after
+ * every chunk and handed back on the game thread.
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCORESYSTEM_API UBowlingMatchForecaster : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Start forecasting a match between bowlers. Returns the match id.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 AddMatch(const TArray<UBowlingScoreComponent*>& Bowlers);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveMatch(int32 MatchId);
+
+	// Throw away the match's forecast and simulate again from the current scores
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void Restart(int32 MatchId);
+
+	// Get the latest forecast for a match. Returns false if the match isn't being forecast.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	bool GetForecast(int32 MatchId, FBowlingForecast& OutForecast) const;
+
+	// Broadcast on the game thread whenever a match's forecast is refined
+	UPROPERTY(BlueprintAssignable)
+	FOnBowlingForecastUpdatedSignature OnForecastUpdated;
+
+	// Games simulated per forecast
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	int32 NumSimulations = 10000;
+
+	// Games simulated by one task before the match yields to the others
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	int32 SimulationsPerChunk = 500;
+
+	// Chance of each standing pin falling on a shot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling, meta=(ClampMin=0, ClampMax=1))
+	float PinFallChance = 0.85f;
+
+	// Play out the rest of the bowlers' games NumGames times, adding the results to Forecast
+	static void Simulate(TConstArrayView<FBowlingGameSnapshot> Games, int32 NumGames, float PinFallChance,
+	                     FRandomStream& RandomStream, FBowlingForecast& Forecast);
+
+	virtual void BeginDestroy() override;
+
+protected:
+	void ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score);
+
+	UFUNCTION()
+	void GameReset(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Restart every match the bowler is in
+	void RestartMatchesFor(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Called on the game thread with each refined forecast
+	void ForecastUpdated(int32 MatchId, uint32 Generation, const FBowlingForecast& Forecast);
+
+	UPROPERTY()
+	TMap<int32, FBowlingForecastMatch> Matches;
+
+	TMultiMap<TObjectKey<UBowlingScoreComponent>, int32> BowlerMatches;
+
+	int32 NextMatchId = 1;
+
+	friend struct FBowlingForecastRun;
+};
@@ -0,0 +1,28 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/*
+ * Low Level Memory Tracker tags for the bowling systems, shown under Bowling in stat LLMFULL and memreport.
+ * Bytes per game and per scorecard are printed with the Bowling.Memory console command.
+ */
+
+// Score components' frames, history and versions
+LLM_DECLARE_TAG_API(Bowling_Games, BOWLINGSCORESYSTEM_API);
+
+// Score and frame widgets, and the text they display
+LLM_DECLARE_TAG_API(Bowling_Widgets, BOWLINGSCORESYSTEM_API);
+
+// Anything built up from games: leaderboards, forecasts, latency histograms, codec and ranker tables, ingest queues
+LLM_DECLARE_TAG_API(Bowling_Caches, BOWLINGSCORESYSTEM_API);
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnBowlingMemoryReport, FOutputDevice& /*Ar*/);
+
+struct BOWLINGSCORESYSTEM_API FBowlingMemory
+{
+	// Bowling.Memory prints every game, then whatever other modules add here, like BowlingScoreUI's scorecards
+	static FOnBowlingMemoryReport OnReport;
+};
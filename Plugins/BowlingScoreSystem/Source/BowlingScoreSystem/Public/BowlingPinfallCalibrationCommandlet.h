@@ -0,0 +1,38 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BowlingPinfallCalibrationCommandlet.generated.h"
+
+struct FBowlingRecordedShot;
+
+/**
+ * Fits FBowlingPinfallModel weights to shots from real games, as exported from a lane tracking system alongside the
+ * pinsetter's pins, and writes them out for FBowlingPinfallModel::LoadFromString.
+ *
+ * Usage: -run=BowlingPinfallCalibration -Shots=<Path> -Output=<Path> [-Weights=<Path>] [-Iterations=<Num>]
+ *        [-LearningRate=<Rate>] [-Seed=<Seed>]
+ *
+ * Fitting starts from -Weights when given, otherwise from the model's defaults.
+ *
+ * Shots are one per line, comma separated:
+ *   <Speed>,<EntryAngle>,<Board>,<RevRate>,<R|L>,<Standing>,<PinsDown>
+ * where Standing and PinsDown are pin masks, bit 0 for pin 1. Lines that don't start with a number are skipped, so a
+ * header line is fine.
+ */
+UCLASS()
+class BOWLINGSCORESYSTEM_API UBowlingPinfallCalibrationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingPinfallCalibrationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	// Parse one line of shots, returns false if it isn't a shot
+	static bool ParseShot(const FString& Line, FBowlingRecordedShot& OutShot);
+};
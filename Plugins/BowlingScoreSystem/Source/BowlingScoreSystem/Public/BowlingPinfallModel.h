@@ -0,0 +1,114 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingPinfallModel.generated.h"
+
+class UBowlingScoreComponent;
+
+// A ball as it arrives at the pins, the way lane tracking systems report it
+USTRUCT(BlueprintType)
+struct BOWLINGSCORESYSTEM_API FBowlingDelivery
+{
+	GENERATED_BODY()
+
+	// Speed at the pins in miles per hour
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	float Speed = 17.0f;
+
+	// Angle into the pins in degrees, towards the bowler's off side
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	float EntryAngle = 6.0f;
+
+	// Board the middle of the ball is on as it reaches the head pin, counted from the gutter on the bowler's hand side.
+	// The pocket is 17.5 and the head pin is on 20.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	float Board = 17.5f;
+
+	// Revolutions per minute
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	float RevRate = 300.0f;
+
+	// Boards and angle are mirrored for a left-handed bowler
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Bowling)
+	bool bLeftHanded = false;
+};
+
+// A tracked delivery and what it did to the pins, to calibrate a model from
+struct FBowlingRecordedShot
+{
+	FBowlingDelivery Delivery;
+
+	// Pins standing before the shot and the pins it knocked down, see FBowlingFrameScore::PinMasks
+	uint16 Standing = 0;
+	uint16 PinsDown = 0;
+};
+
+/*
+ * Turns a delivery into the pins it knocks down without simulating any physics, for AI bowlers, practice lanes and
+ * season simulations that need thousands of believable shots a second.
+ *
+ * Each pin's chance of falling is a logistic function of a few features of the delivery: how squarely the ball's path
+ * crosses the pin, how close it is to a pocket hit, its speed and revs, and how many of the pins next to it have
+ * already fallen. A shot knocks over the pins the ball hits first, then gives every pin left standing another chance
+ * whenever more of its neighbours go down, until the deck settles. The weights can be fitted to tracked shots from
+ * real games with Fit, see UBowlingPinfallCalibrationCommandlet.
+ *
+ * Only ten pin positions are modelled. Variants racking fewer of them, like nine pin, work through the standing mask.
+ */
+class BOWLINGSCORESYSTEM_API FBowlingPinfallModel
+{
+public:
+	enum EFeature
+	{
+		Bias,
+		// How squarely the ball's path crosses the pin, 1 dead on and falling off to 0 past a ball and pin's width
+		Contact,
+		// How close the ball is to the ideal pocket line, 1 for a perfect hit
+		Pocket,
+		// Speed and revs compared to a typical delivery, in typical ranges
+		Speed,
+		Revs,
+		// Share of the pin's neighbours knocked down by this shot
+		Neighbours,
+		NumFeatures
+	};
+
+	static constexpr int32 NumPins = 10;
+
+	// Weights that give a typical league bowler's carry
+	FBowlingPinfallModel();
+
+	// Pins a delivery knocks down out of those standing
+	uint16 Simulate(const FBowlingDelivery& Delivery, uint16 Standing, FRandomStream& Random) const;
+
+	// Record the current shot on a component from a simulated delivery. Returns false if the pins standing aren't
+	// known, or the component didn't accept the shot.
+	bool Bowl(UBowlingScoreComponent& BowlingScoreComponent, const FBowlingDelivery& Delivery, FRandomStream& Random) const;
+
+	// Chance of a standing pin falling, pins are numbered from 0
+	float GetFallProbability(const FBowlingDelivery& Delivery, int32 Pin, uint16 PinsDown) const;
+
+	// Fit the weights to recorded shots by logistic regression, starting from the current ones. Returns the average
+	// log loss per standing pin afterwards.
+	double Fit(TConstArrayView<FBowlingRecordedShot> Shots, int32 Iterations = 500, float LearningRate = 0.5f);
+
+	// Average log loss per standing pin of the current weights on recorded shots, lower is better
+	double GetLogLoss(TConstArrayView<FBowlingRecordedShot> Shots) const;
+
+	// Weights as text, one line per pin, to save a calibration with
+	FString SaveToString() const;
+	bool LoadFromString(const FString& Text);
+
+	float Weights[NumPins][NumFeatures];
+
+private:
+	// Feature values of a delivery that don't depend on other pins, for a right-handed bowler
+	static void GetDeliveryFeatures(const FBowlingDelivery& Delivery, float OutFeatures[NumPins][NumFeatures]);
+
+	static float GetNeighbours(int32 Pin, uint16 PinsDown);
+
+	// Right and left-handed pins are mirror images
+	static uint16 Mirror(uint16 Pins);
+};
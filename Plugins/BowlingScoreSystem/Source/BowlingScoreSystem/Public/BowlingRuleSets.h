@@ -0,0 +1,465 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingFrameScore.h"
+
+/*
+ * Rule set policies for each variant of bowling. Every rule is a compile time constant, so TBowlingScorer<Rules>
+ * is specialized for its variant and never checks which rules it is playing by.
+ */
+struct FTenPinRules
+{
+	static constexpr const TCHAR* Name = TEXT("TenPin");
+
+	static constexpr int32 NumFrames = 10;
+
+	// Pinfall for knocking down a full rack
+	static constexpr int32 NumPins = 10;
+
+	// Pins in a full rack for pin masks (see FBowlingFrameScore::PinMasks), 0 when pins aren't worth one each
+	static constexpr uint16 RackMask = 0b1111111111;
+
+	static constexpr int32 ShotsPerFrame = 2;
+
+	// Shots in the final frame, including any bonus shots earned by a strike or spare
+	static constexpr int32 FinalFrameShots = 3;
+
+	// Number of following shots added to a strike or spare's frame
+	static constexpr int32 StrikeBonusShots = 2;
+	static constexpr int32 SpareBonusShots = 1;
+
+	// Pins in a rack when they aren't all worth one pinfall, see FFivePinRules::PinValues
+	static constexpr int32 NumValuedPins = 0;
+
+	// Pinfall with the first ball at a rack that counts as a strike, 0 when only the full rack does
+	static constexpr int32 NoTapPins = 0;
+};
+
+// Nine-pin no-tap: a full ten-pin rack, but knocking down nine with the first ball at a rack counts as a strike
+struct FNinePinRules : FTenPinRules
+{
+	static constexpr const TCHAR* Name = TEXT("NinePin");
+
+	static constexpr int32 NoTapPins = 9;
+};
+
+// Pins are worth 2-3-5-3-2, so a full rack is 15 pinfall. Three balls per frame.
+struct FFivePinRules : FTenPinRules
+{
+	static constexpr const TCHAR* Name = TEXT("FivePin");
+
+	static constexpr int32 NumPins = 15;
+	static constexpr int32 ShotsPerFrame = 3;
+	static constexpr uint16 RackMask = 0;
+
+	// Pinfall of each pin from left to right. Only some totals can be knocked down, e.g. never 1 or 14.
+	static constexpr int32 NumValuedPins = 5;
+	static constexpr int32 PinValues[NumValuedPins] = {2, 3, 5, 3, 2};
+};
+
+/*
+ * Three balls per frame. A strike or spare only counts with the first or second ball, clearing the pins with the third
+ * is a ten box worth ten with no bonus. The final frame always gets all three balls, pins are set again after a
+ * strike or spare.
+ *
+ * Duckpin is scored by the same rules, so a duckpin center plays this rule set rather than one that only differs by
+ * name. Fallen pins staying on the deck in candlepin doesn't change any score.
+ */
+struct FCandlepinRules : FTenPinRules
+{
+	static constexpr const TCHAR* Name = TEXT("Candlepin");
+
+	static constexpr int32 ShotsPerFrame = 3;
+};
+
+// The pins set up for a shot
+struct FBowlingRack
+{
+	int32 Standing = 0;
+
+	// Balls already thrown at this rack, 0 when the pins have just been set
+	int32 Ball = 0;
+};
+
+/*
+ * Scoring for a rule set over a game's frames. Frame and shot indices start from 0.
+ */
+template <typename TRules>
+struct TBowlingScorer
+{
+	using FRules = TRules;
+
+	static constexpr int32 NumFrames = TRules::NumFrames;
+	static constexpr int32 NumPins = TRules::NumPins;
+	static constexpr int32 FinalFrameIdx = NumFrames - 1;
+
+	static_assert(TRules::FinalFrameShots >= TRules::ShotsPerFrame, "Final frame can't have fewer shots than the others");
+	static_assert(TRules::FinalFrameShots <= 3, "FBowlingFrameScore holds at most three shots");
+	static_assert(TRules::RackMask == 0 or FMath::CountBits(TRules::RackMask) == TRules::NumPins,
+		"Every pin in a rack mask is worth one pinfall");
+	static_assert(TRules::NoTapPins < TRules::NumPins and (TRules::NoTapPins == 0 or TRules::NumValuedPins == 0),
+		"No-tap counts pins that are worth one pinfall each, short of the full rack");
+
+	static constexpr int32 GetNumShots(int32 FrameIdx)
+	{
+		return FrameIdx == FinalFrameIdx ? TRules::FinalFrameShots : TRules::ShotsPerFrame;
+	}
+
+	static bool IsGameOver(int32 FrameIdx)
+	{
+		return FrameIdx < 0 or FrameIdx >= NumFrames;
+	}
+
+	// Get the pins set up for a shot, assuming every earlier shot in the frame has been thrown
+	static FBowlingRack GetRack(const FBowlingFrameScore& Frame, int32 ShotIdx)
+	{
+		FBowlingRack Rack{NumPins, 0};
+		for (auto Idx = 0; Idx < ShotIdx; Idx++)
+		{
+			Rack.Standing -= GetCountedPinfall(Frame.Shots[Idx], Rack.Ball);
+			Rack.Ball++;
+
+			// Pins are set again once they're all down, which only leaves another shot in the final frame
+			if (Rack.Standing <= 0)
+			{
+				Rack = {NumPins, 0};
+			}
+		}
+		return Rack;
+	}
+
+	// Is the shot part of the frame, given the shots before it
+	static bool IsShotAllowed(const FBowlingFrameScore& Frame, int32 FrameIdx, int32 ShotIdx)
+	{
+		if (ShotIdx < 0 or ShotIdx >= GetNumShots(FrameIdx)) { return false; }
+
+		if (FrameIdx != FinalFrameIdx)
+		{
+			// The frame is over as soon as every pin is down
+			return GetPinfall(Frame, ShotIdx) < NumPins;
+		}
+
+		if constexpr (TRules::FinalFrameShots > TRules::ShotsPerFrame)
+		{
+			// Bonus shots are only earned by a strike or spare within the frame's regular shots
+			if (ShotIdx >= TRules::ShotsPerFrame)
+			{
+				return GetPinfall(Frame, TRules::ShotsPerFrame) >= NumPins;
+			}
+		}
+
+		return true;
+	}
+
+	// Note: This will assume later shots in the frame are zero, see UBowlingScoreComponent::IsValidShotScore
+	static bool IsValidShotScore(TConstArrayView<FBowlingFrameScore> Frames, int32 Score, int32 FrameIdx, int32 ShotIdx)
+	{
+		if (Score < 0 or Score > NumPins) { return false; }
+
+		if (not Frames.IsValidIndex(FrameIdx)) { return false; }
+		const auto& Frame = Frames[FrameIdx];
+		if (not Frame.Shots.IsValidIndex(ShotIdx)) { return false; }
+
+		if (not IsShotAllowed(Frame, FrameIdx, ShotIdx)) { return false; }
+
+		return Score <= GetRack(Frame, ShotIdx).Standing and IsReachablePinfall(Frame, ShotIdx, Score);
+	}
+
+	// Could some of the pins standing for a shot be worth Score, for rule sets whose pins aren't all worth one. Which
+	// pins are standing isn't recorded, so every set of pins the earlier shots at the rack could have left is tried.
+	static bool IsReachablePinfall(const FBowlingFrameScore& Frame, int32 ShotIdx, int32 Score)
+	{
+		if constexpr (TRules::NumValuedPins == 0)
+		{
+			return true;
+		}
+		else
+		{
+			constexpr auto NumSets = 1 << TRules::NumValuedPins;
+			static_assert(NumSets <= 32, "Sets of pins are tracked as bits of a uint32");
+
+			// Bit per set of standing pins that could be left, starting from the full rack
+			constexpr auto FullRack = static_cast<uint32>(1) << (NumSets - 1);
+			auto PossibleSets = FullRack;
+			auto Standing = NumPins;
+			for (auto Idx = 0; Idx <= ShotIdx; Idx++)
+			{
+				const auto Pinfall = Idx < ShotIdx ? Frame.Shots[Idx] : Score;
+
+				// Knock Pinfall worth of pins out of every set that might be standing
+				uint32 NextSets = 0;
+				for (auto Set = 0; Set < NumSets; Set++)
+				{
+					if ((PossibleSets & (1u << Set)) == 0) { continue; }
+
+					// Every subset of the standing pins, including none of them
+					for (auto Down = Set;; Down = (Down - 1) & Set)
+					{
+						if (GetPinsValue(Down) == Pinfall) { NextSets |= 1u << (Set & ~Down); }
+						if (Down == 0) { break; }
+					}
+				}
+				if (NextSets == 0) { return false; }
+				PossibleSets = NextSets;
+
+				// Pins are set again once they're all down, see GetRack
+				Standing -= Pinfall;
+				if (Standing <= 0)
+				{
+					PossibleSets = FullRack;
+					Standing = NumPins;
+				}
+			}
+			return true;
+		}
+	}
+
+	// Get the pins set up for a shot as a mask, assuming every earlier shot in the frame has been thrown. Returns 0
+	// when they aren't known, because the rule set has no masks or a ball at the rack was recorded without one.
+	static uint16 GetStandingMask(const FBowlingFrameScore& Frame, int32 ShotIdx)
+	{
+		uint16 Standing = TRules::RackMask;
+		auto Pinfall = 0;
+		for (auto Idx = 0; Idx < ShotIdx; Idx++)
+		{
+			const auto PinMask = Frame.GetPinMask(Idx);
+			Standing = PinMask == 0 and Frame.Shots[Idx] > 0 ? 0 : static_cast<uint16>(Standing & ~PinMask);
+			Pinfall += GetShotCount(Frame, Idx);
+
+			// Pins are set again once they're all down, see GetRack
+			if (Pinfall >= NumPins)
+			{
+				Standing = TRules::RackMask;
+				Pinfall = 0;
+			}
+		}
+		return Standing;
+	}
+
+	// Is a mask of pins knocked down a valid shot: its pinfall has to be, and every pin in it has to be standing
+	static bool IsValidPinMask(TConstArrayView<FBowlingFrameScore> Frames, uint16 PinMask, int32 FrameIdx, int32 ShotIdx)
+	{
+		if (TRules::RackMask == 0 or (PinMask & ~TRules::RackMask) != 0) { return false; }
+		if (not IsValidShotScore(Frames, static_cast<int32>(FMath::CountBits(PinMask)), FrameIdx, ShotIdx)) { return false; }
+
+		const auto Standing = GetStandingMask(Frames[FrameIdx], ShotIdx);
+		return Standing == 0 or (PinMask & ~Standing) == 0;
+	}
+
+	// Every pin knocked down by the first ball at a rack, or enough of them for no-tap
+	static bool IsStrike(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx, int32 ShotIdx)
+	{
+		if (not Frames.IsValidIndex(FrameIdx)) { return false; }
+		const auto& Frame = Frames[FrameIdx];
+		if (not Frame.Shots.IsValidIndex(ShotIdx)) { return false; }
+
+		return GetRack(Frame, ShotIdx).Ball == 0 and GetCountedPinfall(Frame.Shots[ShotIdx], 0) == NumPins;
+	}
+
+	// The rest of the pins knocked down by the second ball at a rack
+	static bool IsSpare(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx, int32 ShotIdx)
+	{
+		if (not Frames.IsValidIndex(FrameIdx)) { return false; }
+		const auto& Frame = Frames[FrameIdx];
+		if (not Frame.Shots.IsValidIndex(ShotIdx)) { return false; }
+
+		const auto Rack = GetRack(Frame, ShotIdx);
+		return Rack.Ball == 1 and Frame.Shots[ShotIdx] == Rack.Standing;
+	}
+
+	static int32 GetFrameScore(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx)
+	{
+		if (not Frames.IsValidIndex(FrameIdx)) { return 0; }
+		const auto& Frame = Frames[FrameIdx];
+
+		auto Score = 0;
+		for (auto ShotIdx = 0; ShotIdx < Frame.Shots.Num(); ShotIdx++)
+		{
+			Score += GetShotCount(Frame, ShotIdx);
+		}
+
+		// Bonus shots in the final frame are already part of the frame
+		if (FrameIdx == FinalFrameIdx) { return Score; }
+
+		auto BonusShots = IsStrike(Frames, FrameIdx, 0)
+			? TRules::StrikeBonusShots
+			: IsSpare(Frames, FrameIdx, 1) ? TRules::SpareBonusShots : 0;
+
+		// Sum up the following shots, which can run on past the next frame after a strike
+		for (auto NextIdx = FrameIdx + 1; BonusShots > 0 and NextIdx < NumFrames; NextIdx++)
+		{
+			const auto& NextFrame = Frames[NextIdx];
+			const auto NumShots = FMath::Min(BonusShots, GetNumThrownShots(NextFrame, NextIdx));
+			for (auto ShotIdx = 0; ShotIdx < NumShots; ShotIdx++)
+			{
+				Score += GetShotCount(NextFrame, ShotIdx);
+			}
+			BonusShots -= NumShots;
+		}
+
+		return Score;
+	}
+
+	// Get the total score as of a frame
+	static int32 GetScore(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx)
+	{
+		auto Score = 0;
+		for (auto Idx = 0; Idx <= FrameIdx and Idx < NumFrames; Idx++)
+		{
+			Score += GetFrameScore(Frames, Idx);
+		}
+		return Score;
+	}
+
+	// Move the cursor on from a shot that was just recorded. Returns true when that was the last shot of the game.
+	static bool Advance(TConstArrayView<FBowlingFrameScore> Frames, int32& FrameIdx, int32& ShotIdx)
+	{
+		if (IsShotAllowed(Frames[FrameIdx], FrameIdx, ShotIdx + 1))
+		{
+			ShotIdx++;
+			return false;
+		}
+
+		FrameIdx++;
+		ShotIdx = 0;
+		return FrameIdx == NumFrames;
+	}
+
+	// Get the best final score reachable from the cursor, knocking down every standing pin on each remaining shot
+	static int32 GetMaxPossibleScore(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx, int32 ShotIdx)
+	{
+		TArray<FBowlingFrameScore, TInlineAllocator<NumFrames>> BestFrames(Frames.GetData(), Frames.Num());
+		while (not IsGameOver(FrameIdx))
+		{
+			auto& Frame = BestFrames[FrameIdx];
+			Frame.Shots[ShotIdx] = GetRack(Frame, ShotIdx).Standing;
+			Advance(BestFrames, FrameIdx, ShotIdx);
+		}
+		return GetScore(BestFrames, FinalFrameIdx);
+	}
+
+private:
+	// Pinfall a ball counts for. With no-tap, NoTapPins or more with the first ball at a rack counts as the full rack.
+	static constexpr int32 GetCountedPinfall(int32 Pinfall, int32 RackBall)
+	{
+		if constexpr (TRules::NoTapPins > 0)
+		{
+			if (RackBall == 0 and Pinfall >= TRules::NoTapPins) { return NumPins; }
+		}
+		return Pinfall;
+	}
+
+	// Pinfall a recorded shot counts for, see GetCountedPinfall
+	static int32 GetShotCount(const FBowlingFrameScore& Frame, int32 ShotIdx)
+	{
+		if constexpr (TRules::NoTapPins > 0)
+		{
+			return GetCountedPinfall(Frame.Shots[ShotIdx], GetRack(Frame, ShotIdx).Ball);
+		}
+		else
+		{
+			return Frame.Shots[ShotIdx];
+		}
+	}
+
+	// Pinfall of a set of valued pins, bit 0 for the first
+	static constexpr int32 GetPinsValue(int32 Pins)
+	{
+		auto Value = 0;
+		for (auto Pin = 0; Pin < TRules::NumValuedPins; Pin++)
+		{
+			if (Pins & (1 << Pin)) { Value += TRules::PinValues[Pin]; }
+		}
+		return Value;
+	}
+
+	// Pins knocked down in a frame before a shot
+	static int32 GetPinfall(const FBowlingFrameScore& Frame, int32 ShotIdx)
+	{
+		auto Pinfall = 0;
+		for (auto Idx = 0; Idx < ShotIdx; Idx++)
+		{
+			Pinfall += GetShotCount(Frame, Idx);
+		}
+		return Pinfall;
+	}
+
+	// Shots actually thrown in a frame, which ends early once every pin is down (except for the final frame)
+	static int32 GetNumThrownShots(const FBowlingFrameScore& Frame, int32 FrameIdx)
+	{
+		if (FrameIdx == FinalFrameIdx) { return TRules::FinalFrameShots; }
+
+		auto Pinfall = 0;
+		for (auto Idx = 0; Idx < TRules::ShotsPerFrame; Idx++)
+		{
+			Pinfall += GetShotCount(Frame, Idx);
+			if (Pinfall >= NumPins) { return Idx + 1; }
+		}
+		return TRules::ShotsPerFrame;
+	}
+};
+
+/*
+ * A rule set's scorer behind plain function pointers, so a component can be handed its variant once instead of
+ * being templated. Each entry is a fully specialized TBowlingScorer function.
+ *
+ * There is one shared instance of each variant's rule set, see Get. Tell variants apart by Name rather than address,
+ * which also matches rule sets built with Make.
+ */
+struct FBowlingRuleSet
+{
+	// Variant the rules are for, from its rules' Name
+	const TCHAR* Name;
+
+	int32 NumFrames;
+	int32 NumPins;
+	uint16 RackMask;
+
+	int32 (*GetNumShots)(int32 FrameIdx);
+	FBowlingRack (*GetRack)(const FBowlingFrameScore& Frame, int32 ShotIdx);
+	bool (*IsValidShotScore)(TConstArrayView<FBowlingFrameScore> Frames, int32 Score, int32 FrameIdx, int32 ShotIdx);
+	uint16 (*GetStandingMask)(const FBowlingFrameScore& Frame, int32 ShotIdx);
+	bool (*IsValidPinMask)(TConstArrayView<FBowlingFrameScore> Frames, uint16 PinMask, int32 FrameIdx, int32 ShotIdx);
+	bool (*IsStrike)(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx, int32 ShotIdx);
+	bool (*IsSpare)(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx, int32 ShotIdx);
+	int32 (*GetFrameScore)(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx);
+	int32 (*GetScore)(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx);
+	bool (*Advance)(TConstArrayView<FBowlingFrameScore> Frames, int32& FrameIdx, int32& ShotIdx);
+	int32 (*GetMaxPossibleScore)(TConstArrayView<FBowlingFrameScore> Frames, int32 FrameIdx, int32 ShotIdx);
+
+	// The shared rule set for one of the variants below. Defined once in BowlingRuleSets.cpp rather than as a static
+	// in this header, which every module would get its own copy of.
+	template <typename TRules>
+	static const FBowlingRuleSet& Get();
+
+	// Build a rule set, for rules that aren't one of the shared variants
+	template <typename TRules>
+	static constexpr FBowlingRuleSet Make()
+	{
+		using FScorer = TBowlingScorer<TRules>;
+		return {
+			TRules::Name,
+			FScorer::NumFrames,
+			FScorer::NumPins,
+			TRules::RackMask,
+			&FScorer::GetNumShots,
+			&FScorer::GetRack,
+			&FScorer::IsValidShotScore,
+			&FScorer::GetStandingMask,
+			&FScorer::IsValidPinMask,
+			&FScorer::IsStrike,
+			&FScorer::IsSpare,
+			&FScorer::GetFrameScore,
+			&FScorer::GetScore,
+			&FScorer::Advance,
+			&FScorer::GetMaxPossibleScore,
+		};
+	}
+};
+
+template <> BOWLINGSCORESYSTEM_API const FBowlingRuleSet& FBowlingRuleSet::Get<FTenPinRules>();
+template <> BOWLINGSCORESYSTEM_API const FBowlingRuleSet& FBowlingRuleSet::Get<FNinePinRules>();
+template <> BOWLINGSCORESYSTEM_API const FBowlingRuleSet& FBowlingRuleSet::Get<FFivePinRules>();
+template <> BOWLINGSCORESYSTEM_API const FBowlingRuleSet& FBowlingRuleSet::Get<FCandlepinRules>();
@@ -3,32 +3,25 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "BowlingGameFlow.h"
+#include "BowlingRuleSets.h"
+#include "BowlingScoreSnapshot.h"
 #include "Components/ActorComponent.h"
 #include "BowlingScoreComponent.generated.h"
 
-USTRUCT()
-struct BOWLINGSCORESYSTEM_API FBowlingFrameScore
-{
-	GENERATED_BODY()
-
-	FBowlingFrameScore();
-
-	// Utility constructor primarily for testing
-	FBowlingFrameScore(int32 Shot1, int32 Shot2);
-
-	// Utility constructor primarily for testing
-	FBowlingFrameScore(int32 Shot1, int32 Shot2, int32 Shot3);
-
-	TArray<int32, TInlineAllocator<3>> Shots;
-};
+class UBowlingScoreComponent;
+class UBowlingScoringWorker;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBowlingScoreChangedSignature, UBowlingScoreComponent*, BowlingScoreComponent, int32, Frame);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBowlingResetSignature, UBowlingScoreComponent*, BowlingScoreComponent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnBowlingGameAdvancedSignature, UBowlingScoreComponent*, BowlingScoreComponent, int32, Frame, int32, Shot);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBowlingGameOverSignature, UBowlingScoreComponent*, BowlingScoreComponent);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnBowlingGameStateChanged, UBowlingScoreComponent* /*BowlingScoreComponent*/);
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnBowlingShotRecorded, UBowlingScoreComponent* /*BowlingScoreComponent*/, int32 /*Frame*/, int32 /*Shot*/, int32 /*Score*/);
 
 /*
  * Component for PlayerState (or anywhere really) to keep track of bowling score.
+ * Scores ten-pin, other variants are subclasses that pick their rule set (see BowlingVariantScoreComponents.h).
  */
 UCLASS()
 class BOWLINGSCORESYSTEM_API UBowlingScoreComponent : public UActorComponent
@@ -39,10 +32,22 @@ public:
 	// Sets default values for this component's properties
 	UBowlingScoreComponent();
 
-	// Reset the bowling game, starting over on Frame 1 Shot 1
+	// Reset the bowling game, starting over on Frame 1 Shot 1. Queued like SetScore when scored on a worker.
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	void Reset();
 
+	// Score the game on a worker thread as one of its lanes, instead of on the game thread. SetScore, SetPinMask and
+	// Reset are queued for the worker while it runs, and the game here catches up with what it publishes once a tick,
+	// making the same broadcasts scoring here would. The lane has to have been added with the component's rule set.
+	// Null goes back to scoring on the game thread.
+	void SetScoringWorker(UBowlingScoringWorker* InScoringWorker, int32 InLaneId);
+
+	// Is the game scored on a worker rather than here
+	bool IsScoredOnWorker() const { return ScoringWorker != nullptr; }
+
+	// The game as the scoring worker last published it, null unless it's scored on one
+	const FBowlingScoreSnapshot* GetPublishedSnapshot() const;
+
 	// Get the current frame. Returns -1 during game over.
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	int32 GetCurrentFrameNum() const;
@@ -51,10 +56,82 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	int32 GetCurrentShotNum() const;
 
+	// Number of frames in a game
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetNumFrames() const;
+
+	// Pinfall for knocking down a full rack
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetNumPins() const;
+
+	// Get the most shots a frame can take
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetNumShots(int32 Frame) const;
+
+	// Get the pins standing for the current shot. Returns 0 during game over.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetPinsStanding() const;
+
+	// Get which ball at the current rack of pins the current shot is, 1 when the pins have just been set.
+	// Returns -1 during game over.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetRackBallNum() const;
+
+	const FBowlingRuleSet& GetRuleSet() const { return *RuleSet; }
+
+	// Every shot of the game so far, later shots are zero
+	const TArray<FBowlingFrameScore>& GetFrameScores() const { return FrameScores; }
+
 	// Get the total score as of a specific frame
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	int32 GetScore(int32 Frame) const;
 
+	// Get the total score as of a frame, as it stood once ShotIndex shots had been recorded (0 for a new game)
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetScoreAt(int32 ShotIndex, int32 Frame) const;
+
+	// Get the frame and shot that were up next once ShotIndex shots had been recorded, -1 after the game was over.
+	// Returns false if that many shots haven't been recorded.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	bool GetCursorAt(int32 ShotIndex, int32& OutFrame, int32& OutShot) const;
+
+	// Number of shots recorded since the game was reset
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetNumShotsRecorded() const;
+
+	// Version of the last change to the game, including the cursor moving on. Versions are shared by every game, so
+	// one version is enough to ask what changed across all of them since (see UBowlingScoreExporter).
+	uint64 GetStateVersion() const { return StateVersion; }
+
+	// Version of the last change to a frame's shots or score, including bonus added by a later shot
+	uint64 GetFrameVersion(int32 Frame) const;
+
+	// Latest version handed out to any game
+	static uint64 GetLatestStateVersion();
+
+	// Hand out a new version, for changes to what's being watched rather than to a game itself
+	static uint64 AdvanceStateVersion();
+
+	// When the latest accepted shot arrived in SetScore, in cycles, for timing how long it takes to show up
+	uint64 GetShotArrivalCycles() const { return ShotArrivalCycles; }
+
+	// Heap memory held by the game, not counting the component itself
+	SIZE_T GetAllocatedSize() const;
+
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+
+	// Has the component been destroyed, games can't be waited on once it has
+	bool IsDestroyed() const { return bDestroyed; }
+
+	// co_await the shot the game is waiting for, from a coroutine on the game thread (see BowlingGameFlow.h). Resumes
+	// right away while the game is in progress, otherwise once it's reset.
+	FBowlingShotRequestAwaiter NextShotRequest() { return FBowlingShotRequestAwaiter(*this); }
+
+	// co_await the end of the game for its final score, see BowlingGameFlow.h
+	FBowlingGameOverAwaiter GameOver() { return FBowlingGameOverAwaiter(*this); }
+
 	// Get the specified shot's score
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	int32 GetShotScore(int32 Frame, int32 Shot) const;
@@ -62,18 +139,49 @@ public:
 	// Get the specified frame's score
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	int32 GetFrameScore(int32 Frame) const;
+
+	// Get the best final score the game can still reach, assuming every remaining shot knocks down every standing pin
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetMaxPossibleScore() const;
+
+	// Get every shot, mark and score of the game at once, for scoreboards to refresh from a single call. Not pure, so
+	// Blueprints copy it once per call rather than again for every pin that reads from it.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void GetSnapshot(FBowlingScoreSnapshot& OutSnapshot) const;
+
+	// GetSnapshot without the copy. The snapshot is only rebuilt once the game changes.
+	const FBowlingScoreSnapshot& GetCachedSnapshot() const;
 	
 	// Check if a shot score is valid for the current frame and shot.
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	bool IsValidShotScore(int32 Score) const;
 	
 	// Attempt to set the score for the current frame and shot
-	// Return indicates whether the score was accepted
+	// Return indicates whether the score was accepted, or when scored on a worker, queued for it
 	// Broadcasts OnGameAdvanced when score is recorded and game moves to the next shot 
 	// Broadcasts OnReset after the final score is recorded
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	bool SetScore(int32 Score);
 
+	// Check if a mask of pins knocked down is valid for the current frame and shot, bit 0 for pin 1 up to bit 9 for
+	// pin 10. Every pin in it has to be standing, as far as earlier balls at the rack say.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	bool IsValidPinMask(int32 PinMask) const;
+
+	// Attempt to record the current shot from the pins it knocked down, as a pinsetter reports them. Its score is the
+	// number of pins in the mask, otherwise the same as SetScore.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	bool SetPinMask(int32 PinMask);
+
+	// Get the pins a shot knocked down as a mask, 0 if it was recorded as a score alone
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetPinMask(int32 Frame, int32 Shot) const;
+
+	// Get the pins standing for the current shot as a mask. Returns 0 during game over, or when they aren't known
+	// because a ball at the rack was recorded as a score alone.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetPinsStandingMask() const;
+
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	bool IsSpare(int32 Frame, int32 Shot) const;
 
@@ -83,10 +191,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	bool IsGameOver() const;
 
+	// Has any shot been recorded since the game was last reset
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	bool HasStarted() const;
+
 	// Broadcast when the game is reset
 	UPROPERTY(BlueprintAssignable)
 	FOnBowlingResetSignature OnReset;
 
+	// Broadcast when a shot is recorded, with the frame the shot was recorded in
+	UPROPERTY(BlueprintAssignable)
+	FOnBowlingScoreChangedSignature OnScoreChanged;
+
+	// Native broadcast of every recorded shot, for systems that need the shot itself rather than the game state
+	FOnBowlingShotRecorded OnShotRecorded;
+
+	// Native broadcast after every shot and reset, and when the component is destroyed, for code waiting on the game
+	FOnBowlingGameStateChanged OnGameStateChanged;
+
 	// Broadcast when the game advances to the next shot
 	// Note: does not broadcast after the last shot
 	UPROPERTY(BlueprintAssignable)
@@ -101,24 +223,66 @@ protected:
 	// For example, if shot 1 on Frame 10 is entered, the game state will be assumed to be at Frame 10 Shot 1
 	bool IsValidShotScore(int32 Score, int32 Frame, int32 Shot) const;
 	
-	// Set the score for a given Frame and Shot
+	// Set the score for a given Frame and Shot, along with the pins knocked down if they're known
 	// Note: Due to time constraints this will only work for the current frame and shot, so it's not exposed
-	bool SetScore(int32 Score, int32 Frame, int32 Shot);
+	bool SetScore(int32 Score, int32 Frame, int32 Shot, uint16 PinMask = 0);
+
+	// Start the game over here and broadcast it
+	void ResetGame();
+
+	// Broadcast a shot once it's been recorded and the game has moved on
+	void BroadcastShot(int32 Frame, int32 Shot, int32 Score);
+
+	// Catch up with the game the scoring worker published for our lane, recording every shot it's taken since
+	UFUNCTION()
+	void ScoringLaneUpdated(int32 LaneId, const FBowlingScoreSnapshot& Published);
 
-	// Get the next shot from a given Frame and Shot that will be used for spare and strike scoring.
-	TPair<int32, int32> GetNextScoredShot(int32 Frame, int32 Shot) const;
+	// Size every frame for its shots and zero them, and start the history over. Frames are only allocated the first
+	// time.
+	void InitializeFrames();
+
+	// Add the scoresheet as it stands to the history
+	void RecordHistory();
+
+	// Give the game and any frame whose shots or score changed with the last recorded shot a new version
+	void UpdateVersions(int32 ShotFrameIdx);
+
+	// Switch to another variant's rules, for subclass constructors
+	void SetRuleSet(const FBowlingRuleSet& InRuleSet);
 
 	// Allow the testing class to manipulate internals for test setup
 	friend struct BowlingScoreTests;
 
 	TArray<FBowlingFrameScore> FrameScores;
 
+	const FBowlingRuleSet* RuleSet;
+
+	// The scoresheet after every recorded shot, starting with the empty one, so scrubbing back through a game never
+	// replays it. Holds the cumulative score of every frame, NumFrames entries per shot.
+	TArray<uint16> ScoreHistory;
+
+	// Frame and shot indices that were up next after every recorded shot, starting with Frame 1 Shot 1
+	TArray<TPair<uint8, uint8>> CursorHistory;
+
+	uint64 StateVersion = 0;
+	uint64 ShotArrivalCycles = 0;
+	bool bDestroyed = false;
+	TArray<uint64> FrameVersions;
+
+	// Last snapshot handed out, rebuilt when StateVersion moves on
+	mutable FBowlingScoreSnapshot Snapshot;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UBowlingScoringWorker> ScoringWorker;
+
+	int32 ScoringLaneId = 0;
+
+	// Version of the lane's game last caught up with, which every reset and accepted shot moves on by one
+	int64 ScoringLaneVersion = 0;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	int32 CurrentFrameIndex;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	int32 CurrentShotIndex;
-
-public:
-	virtual void InitializeComponent() override;
 };
@@ -0,0 +1,87 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BowlingScoreExporter.generated.h"
+
+class UBowlingScoreComponent;
+
+/*
+ * Exports live games for scoreboards that poll, as JSON or a compact binary form.
+ *
+ * Every export is a change feed for a consumer, one per scoreboard that polls: only the games and frames that changed
+ * since the consumer's last export are written, along with games that were removed. A consumer's first export has
+ * everything. Removed games are only remembered until every consumer has been told about them. Both forms are
+ * written straight into the caller's buffer, which is reset but never shrunk, so polling reuses its memory.
+ *
+ * JSON:
+ *   {"version":V,"games":[{"id":1,"full":true,"frame":3,"shot":1,"over":false,"score":45,
+ *     "frames":[{"frame":1,"shots":[10,0],"score":20}]}],"removed":[4]}
+ * Games are "full" when everything about them is included, e.g. for a new game. Frame and shot are -1 once the
+ * game is over, and shots not thrown yet are 0.
+ *
+ * Binary, little endian:
+ *   u64 Version, u16 NumGames, then for each game:
+ *     u32 Id, u8 Flags (1 full, 2 over), u8 Frame, u8 Shot (0 once over), u16 Score, u8 NumFrames, then for each frame:
+ *       u8 Frame, u8 NumShots, u8 Shots[NumShots], u16 Score
+ *   u16 NumRemoved, u32 Ids[NumRemoved]
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCORESYSTEM_API UBowlingScoreExporter : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Start exporting a game under an id, replacing any game already using it
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddGame(int32 GameId, UBowlingScoreComponent* BowlingScoreComponent);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveGame(int32 GameId);
+
+	// Start a change feed for a scoreboard, returns the consumer id to export with
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 AddConsumer();
+
+	// Stop holding on to removed games for a scoreboard that's gone
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveConsumer(int32 ConsumerId);
+
+	// Write what changed since the consumer's last export as UTF-8 JSON. Returns the version written.
+	uint64 ExportJson(int32 ConsumerId, TArray<uint8>& OutJson);
+
+	// Write what changed since the consumer's last export in the binary form. Returns the version written.
+	uint64 ExportBinary(int32 ConsumerId, TArray<uint8>& OutData);
+
+	// Removed games some consumer hasn't been told about yet
+	int32 GetNumRemovedGames() const { return RemovedGames.Num(); }
+
+protected:
+	struct FExportedGame
+	{
+		TWeakObjectPtr<UBowlingScoreComponent> BowlingScoreComponent;
+
+		// When the game was added, everything about it is new to anyone who asks about an earlier version
+		uint64 AddedVersion = 0;
+	};
+
+	template <typename TWriter>
+	uint64 Export(uint64 SinceVersion, TWriter& Writer) const;
+
+	// Move a consumer on to a version, forgetting removed games every consumer now knows about
+	void AdvanceConsumer(uint64& Cursor, uint64 Version);
+
+	void TrimRemovedGames();
+
+	TMap<int32, FExportedGame> Games;
+
+	// Games removed and when, so consumers that saw them can be told they're gone
+	TMap<int32, uint64> RemovedGames;
+
+	// Version each consumer was last exported
+	TMap<int32, uint64> Consumers;
+
+	int32 NextConsumerId = 1;
+};
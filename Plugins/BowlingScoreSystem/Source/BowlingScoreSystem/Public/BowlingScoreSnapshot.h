@@ -0,0 +1,76 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingScoreSnapshot.generated.h"
+
+// How a shot is marked on a scoresheet
+UENUM(BlueprintType)
+enum class EBowlingShotMark : uint8
+{
+	// Not thrown yet
+	None,
+	// Pinfall is shown as a number
+	Open,
+	Strike,
+	Spare,
+};
+
+USTRUCT(BlueprintType)
+struct BOWLINGSCORESYSTEM_API FBowlingFrameSnapshot
+{
+	GENERATED_BODY()
+
+	// Pinfall of every shot the frame can take, later shots are zero
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	TArray<int32> Shots;
+
+	// Mark for each shot, None for shots not thrown
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	TArray<EBowlingShotMark> Marks;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 NumShotsThrown = 0;
+
+	// Score of the frame on its own, including bonus from later shots
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 FrameScore = 0;
+
+	// Total score as of the frame
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 Score = 0;
+};
+
+/*
+ * Everything a scoreboard shows about a game, from one call to UBowlingScoreComponent::GetSnapshot.
+ */
+USTRUCT(BlueprintType)
+struct BOWLINGSCORESYSTEM_API FBowlingScoreSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	TArray<FBowlingFrameSnapshot> Frames;
+
+	// Frame and shot up next, -1 once the game is over
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 CurrentFrame = 1;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 CurrentShot = 1;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	bool bGameOver = false;
+
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 Score = 0;
+
+	// Best final score the game can still reach
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int32 MaxPossibleScore = 0;
+
+	// Game state version the snapshot was taken at, see UBowlingScoreComponent::GetStateVersion
+	UPROPERTY(BlueprintReadOnly, Category=Bowling)
+	int64 StateVersion = 0;
+};
@@ -4,6 +4,8 @@
 
 #include "Modules/ModuleManager.h"
 
+BOWLINGSCORESYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogBowling, Log, All);
+
 class FBowlingScoreSystemModule : public IModuleInterface
 {
 public:
@@ -0,0 +1,76 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
+#include "BowlingScoreboardPublisher.generated.h"
+
+struct FBowlingSharedScoreboardHeader;
+class UBowlingScoreComponent;
+
+/*
+ * Mirrors every lane's game into named shared memory, so display and overlay processes on the same machine can show
+ * live scores without asking the game for them. Each lane gets a fixed slot, rewritten on the game thread whenever a
+ * shot is recorded or the game is reset. The layout is in BowlingSharedScoreboard.h, and other processes read it with
+ * FBowlingScoreboardReader.
+ *
+ * Open the scoreboard, then add every lane.
+ */
+UCLASS()
+class BOWLINGSCORESYSTEM_API UBowlingScoreboardPublisher : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Create the shared memory with room for a number of lanes. Anything left under the same name by a process that
+	// died is cleared out.
+	bool Open(const FString& InName, int32 InNumSlots = 64);
+
+	// Stop publishing and release the shared memory
+	void Close();
+
+	bool IsOpen() const { return Region != nullptr; }
+
+	// Publish a lane's game in the first free slot. Returns the slot, or INDEX_NONE if they're all taken.
+	int32 AddLane(int32 LaneId, UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Stop publishing a lane and clear its slot
+	void RemoveLane(int32 LaneId);
+
+	// Slot a lane is published in, or INDEX_NONE
+	int32 GetLaneSlot(int32 LaneId) const;
+
+	virtual void BeginDestroy() override;
+
+protected:
+	struct FPublishedLane
+	{
+		TWeakObjectPtr<UBowlingScoreComponent> BowlingScoreComponent;
+		int32 Slot = INDEX_NONE;
+	};
+
+	FBowlingSharedScoreboardHeader* GetHeader() const;
+
+	// Write a lane's slot, or clear it when there's no component
+	void Publish(int32 Slot, int32 LaneId, const UBowlingScoreComponent* BowlingScoreComponent);
+
+	void Publish(UBowlingScoreComponent* BowlingScoreComponent);
+
+	void ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score);
+
+	UFUNCTION()
+	void GameReset(UBowlingScoreComponent* BowlingScoreComponent);
+
+	TMap<int32, FPublishedLane> Lanes;
+
+	// Reverse lookup of Lanes for delegates
+	TMap<TObjectKey<UBowlingScoreComponent>, int32> LaneIds;
+
+	// Which slots are taken
+	TBitArray<> UsedSlots;
+
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+};
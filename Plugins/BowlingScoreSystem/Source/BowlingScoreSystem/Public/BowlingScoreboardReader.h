@@ -0,0 +1,105 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+// POSIX shared memory, so there's nothing here for other platforms. Checked with the compiler's own macros rather than
+// the engine's, so the header still stands alone.
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BowlingSharedScoreboard.h"
+
+/*
+ * Reads the scoreboard a game publishes with UBowlingScoreboardPublisher, from another process on a Linux or macOS
+ * machine. Header only and needs nothing from the engine.
+ *
+ * Opening maps the region read-only and is the only time a syscall is made, lanes are read straight out of the
+ * mapping:
+ *
+ *   FBowlingScoreboardReader Reader;
+ *   if (Reader.Open("BowlingScoreboard"))
+ *   {
+ *       FBowlingSharedLaneState Lane;
+ *       for (uint32_t Slot = 0; Slot < Reader.GetNumSlots(); Slot++)
+ *       {
+ *           if (Reader.ReadLane(Slot, Lane) and Lane.LaneId != 0) { Draw(Lane); }
+ *       }
+ *   }
+ */
+class FBowlingScoreboardReader
+{
+public:
+	FBowlingScoreboardReader() = default;
+	FBowlingScoreboardReader(const FBowlingScoreboardReader&) = delete;
+	FBowlingScoreboardReader& operator=(const FBowlingScoreboardReader&) = delete;
+
+	~FBowlingScoreboardReader() { Close(); }
+
+	// Map a scoreboard by the name it was published under. Returns false if there isn't one, or it's laid out
+	// differently from what this header expects.
+	bool Open(const char* Name)
+	{
+		Close();
+
+		// The engine publishes POSIX shared memory under its name with a leading slash
+		const auto Path = std::string("/") + Name;
+		const auto Fd = shm_open(Path.c_str(), O_RDONLY, 0);
+		if (Fd < 0) { return false; }
+
+		struct stat Stat;
+		const auto bStat = fstat(Fd, &Stat) == 0 and static_cast<size_t>(Stat.st_size) >= sizeof(FBowlingSharedScoreboardHeader);
+		auto* Address = bStat ? mmap(nullptr, Stat.st_size, PROT_READ, MAP_SHARED, Fd, 0) : MAP_FAILED;
+		close(Fd);
+		if (Address == MAP_FAILED) { return false; }
+
+		Header = static_cast<const FBowlingSharedScoreboardHeader*>(Address);
+		Size = Stat.st_size;
+		if (not Header->IsValid() or FBowlingSharedScoreboardHeader::GetRegionSize(Header->NumSlots) > Size)
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void Close()
+	{
+		if (Header)
+		{
+			munmap(const_cast<FBowlingSharedScoreboardHeader*>(Header), Size);
+			Header = nullptr;
+			Size = 0;
+		}
+	}
+
+	bool IsOpen() const { return Header != nullptr; }
+
+	uint32_t GetNumSlots() const { return Header ? Header->NumSlots : 0; }
+
+	// Changes whenever any lane is published
+	uint64_t GetPublishCount() const { return Header ? Header->PublishCount.load(std::memory_order_acquire) : 0; }
+
+	// Copy out a lane's state. Returns false if the slot doesn't exist or kept being written while it was read.
+	bool ReadLane(uint32_t Slot, FBowlingSharedLaneState& OutState) const
+	{
+		return Slot < GetNumSlots() and Header->GetSlots()[Slot].Read(OutState);
+	}
+
+	// Look at a lane's state in place, see FBowlingSharedLaneSlot::Visit
+	template <typename TVisitor>
+	bool VisitLane(uint32_t Slot, TVisitor&& Visitor) const
+	{
+		return Slot < GetNumSlots() and Header->GetSlots()[Slot].Visit(static_cast<TVisitor&&>(Visitor));
+	}
+
+private:
+	const FBowlingSharedScoreboardHeader* Header = nullptr;
+	size_t Size = 0;
+};
+
+#endif
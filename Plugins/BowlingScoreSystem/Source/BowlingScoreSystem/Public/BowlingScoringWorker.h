@@ -0,0 +1,94 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingRuleSets.h"
+#include "BowlingScoreSnapshot.h"
+#include "Containers/Ticker.h"
+#include "UObject/Object.h"
+#include "BowlingScoringWorker.generated.h"
+
+class FBowlingScoringThread;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBowlingLaneUpdatedSignature, int32, LaneId, const FBowlingScoreSnapshot&, Snapshot);
+
+/*
+ * Scores lanes on a dedicated thread instead of the game thread.
+ *
+ * Each lane has a lock-free single-producer, single-consumer queue: whatever feeds a lane (a pinsetter thread, a
+ * network reader, a test) pushes shots from its own thread, and the scoring thread validates and applies them. The
+ * results reach the game thread as immutable snapshots, double buffered so the scoring thread fills one while the game
+ * thread reads the other. Once a tick the game thread takes the latest buffer and broadcasts OnLaneUpdated for every
+ * lane that changed in it.
+ *
+ * Add every lane, then start the worker. Lanes can't be added or removed while it's running. A score component
+ * scores its game on a lane with UBowlingScoreComponent::SetScoringWorker.
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCORESYSTEM_API UBowlingScoringWorker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingScoringWorker();
+	virtual ~UBowlingScoringWorker() override;
+
+	// Score a lane with a rule set. Lanes are numbered from 1.
+	void AddLane(int32 LaneId, const FBowlingRuleSet& RuleSet = FBowlingRuleSet::Get<FTenPinRules>());
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddTenPinLane(int32 LaneId) { AddLane(LaneId); }
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveLane(int32 LaneId);
+
+	// Start the scoring thread with every lane's game reset
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void Start();
+
+	// Stop the scoring thread, dropping shots not applied yet
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void Stop();
+
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	bool IsRunning() const { return Thread.IsValid(); }
+
+	// Queue a shot or reset for a lane. Each lane takes pushes from one thread at a time, which can be any thread.
+	// Returns false if the lane doesn't exist or its queue is full.
+	bool PushShot(int32 LaneId, int32 Pins);
+	bool PushReset(int32 LaneId);
+
+	// Take the latest snapshots from the scoring thread and broadcast the lanes that changed. Called every tick while
+	// running. Returns the number of lanes updated.
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 UpdateSnapshots();
+
+	// A lane's game as of the last UpdateSnapshots, or null. Its StateVersion counts the lane's own changes.
+	const FBowlingScoreSnapshot* GetSnapshot(int32 LaneId) const;
+
+	// Shots and resets applied by the scoring thread
+	int64 GetNumApplied() const;
+
+	// Shots the lane's game wouldn't take
+	int64 GetNumRejected() const;
+
+	// Broadcast on the game thread for every lane with a new snapshot
+	UPROPERTY(BlueprintAssignable)
+	FOnBowlingLaneUpdatedSignature OnLaneUpdated;
+
+	// Shots each lane can have waiting, pushes fail once it's full
+	static constexpr int32 QueueCapacity = 255;
+
+	virtual void BeginDestroy() override;
+
+protected:
+	bool Tick(float DeltaTime);
+
+	// Rule set of each lane, in the order the scoring thread keeps them
+	TArray<TPair<int32, const FBowlingRuleSet*>> Lanes;
+
+	TUniquePtr<FBowlingScoringThread> Thread;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
@@ -0,0 +1,130 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Layout of the shared memory scoreboard published by UBowlingScoreboardPublisher, for display and overlay processes
+ * on the same machine. Plain C++ with nothing from the engine, so other processes can include it as is (see
+ * BowlingScoreboardReader.h, for Linux and macOS).
+ *
+ * The region is a header followed by fixed-size slots, one per lane, each on its own cache lines. Every slot is
+ * guarded by a seqlock: the game is the only writer and makes the sequence odd while it writes, readers retry until
+ * they see the same even sequence before and after reading. Reading never takes a lock or makes a syscall.
+ */
+
+// A lane's game as it stands
+struct FBowlingSharedLaneState
+{
+	static constexpr int MaxFrames = 10;
+	static constexpr int MaxShots = 3;
+
+	// Game state version, which changes with every shot and reset
+	uint64_t Version;
+
+	// Lane the slot is for, 0 when the slot isn't in use
+	uint32_t LaneId;
+
+	// Frame and shot up next starting from 1, -1 once the game is over
+	int8_t CurrentFrame;
+	int8_t CurrentShot;
+
+	uint8_t NumFrames;
+
+	// Pinfall for knocking down a full rack
+	uint8_t NumPins;
+
+	// Pinfall of every shot, MaxShots per frame, later shots are zero
+	uint8_t Shots[MaxFrames * MaxShots];
+
+	// Total score as of each frame
+	uint16_t FrameTotals[MaxFrames];
+
+	// Best final score the game can still reach
+	uint16_t MaxPossibleScore;
+};
+
+struct alignas(64) FBowlingSharedLaneSlot
+{
+	// Odd while the state is being written
+	std::atomic<uint32_t> Sequence;
+
+	FBowlingSharedLaneState State;
+
+	// Replace the state. Only ever called by the one writer.
+	void Write(const FBowlingSharedLaneState& NewState)
+	{
+		const auto Begin = Sequence.load(std::memory_order_relaxed);
+		Sequence.store(Begin + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		std::memcpy(&State, &NewState, sizeof(State));
+
+		Sequence.store(Begin + 2, std::memory_order_release);
+	}
+
+	// Look at the state in place, without copying it. Visit can see a state that's being written, so it may only read;
+	// its result is only returned once the state is known not to have changed underneath it. Returns false after
+	// MaxAttempts tries that all overlapped a write.
+	template <typename TVisitor>
+	bool Visit(TVisitor&& Visitor, int MaxAttempts = 64) const
+	{
+		for (auto Attempt = 0; Attempt < MaxAttempts; Attempt++)
+		{
+			const auto Begin = Sequence.load(std::memory_order_acquire);
+			if (Begin & 1) { continue; }
+
+			Visitor(State);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Sequence.load(std::memory_order_relaxed) == Begin) { return true; }
+		}
+		return false;
+	}
+
+	// Copy out a consistent state
+	bool Read(FBowlingSharedLaneState& OutState, int MaxAttempts = 64) const
+	{
+		return Visit([&OutState](const FBowlingSharedLaneState& Current)
+		{
+			std::memcpy(&OutState, &Current, sizeof(OutState));
+		}, MaxAttempts);
+	}
+};
+
+struct alignas(64) FBowlingSharedScoreboardHeader
+{
+	static constexpr uint32_t ExpectedMagic = 0x534C5742; // "BWLS"
+	static constexpr uint32_t ExpectedLayoutVersion = 1;
+
+	uint32_t Magic;
+	uint32_t LayoutVersion;
+	uint32_t NumSlots;
+	uint32_t SlotSize;
+
+	// Bumped after every slot written, so a reader can tell whether anything changed with a single load
+	std::atomic<uint64_t> PublishCount;
+
+	static size_t GetRegionSize(uint32_t NumSlots)
+	{
+		return sizeof(FBowlingSharedScoreboardHeader) + NumSlots * sizeof(FBowlingSharedLaneSlot);
+	}
+
+	// Is this a scoreboard laid out the way this header expects
+	bool IsValid() const
+	{
+		return Magic == ExpectedMagic and LayoutVersion == ExpectedLayoutVersion
+			and SlotSize == sizeof(FBowlingSharedLaneSlot);
+	}
+
+	FBowlingSharedLaneSlot* GetSlots() { return reinterpret_cast<FBowlingSharedLaneSlot*>(this + 1); }
+	const FBowlingSharedLaneSlot* GetSlots() const { return reinterpret_cast<const FBowlingSharedLaneSlot*>(this + 1); }
+};
+
+// Both processes map the same memory, so the atomics must work without anything outside of it
+static_assert(std::atomic<uint32_t>::is_always_lock_free and std::atomic<uint64_t>::is_always_lock_free);
+static_assert(sizeof(FBowlingSharedLaneSlot) % 64 == 0 and sizeof(FBowlingSharedScoreboardHeader) % 64 == 0);
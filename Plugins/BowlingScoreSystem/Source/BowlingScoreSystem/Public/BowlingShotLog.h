@@ -0,0 +1,122 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
+#include "BowlingShotLog.generated.h"
+
+class FBowlingShotLogWriter;
+class UBowlingScoreComponent;
+
+// One event in the shot log, kept small and fixed size so a torn write can only ever damage the last record
+struct FBowlingShotLogRecord
+{
+	enum class EType : uint8
+	{
+		Reset,
+		Shot,
+	};
+
+	// How far into its input the event's source had read once it was applied, see SetInputOffset
+	uint64 InputOffset = 0;
+
+	uint16 LaneId = 0;
+	EType Type = EType::Reset;
+	uint8 Frame = 0;
+	uint8 Shot = 0;
+	uint8 Score = 0;
+	uint16 Checksum = 0;
+
+	uint16 CalculateChecksum() const;
+};
+static_assert(sizeof(FBowlingShotLogRecord) == 16, "Shot log records are written to disk as-is");
+
+/*
+ * Write-ahead log of every shot and reset for a set of lanes, so in-progress games survive the process dying.
+ * Events are appended on the game thread without blocking. A writer thread collects everything that arrives within
+ * the group commit window into one batch and syncs it to disk once, so 60 lanes don't cost 60 disk syncs.
+ *
+ * On startup: Open the log, add every lane, then Recover before any new shots are entered.
+ */
+UCLASS()
+class BOWLINGSCORESYSTEM_API UBowlingShotLog : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UBowlingShotLog();
+	virtual ~UBowlingShotLog() override;
+
+	// Open the log for appending and start the writer thread. Existing events are loaded for Recover, and a damaged
+	// final record from a crash mid-write is dropped.
+	bool Open(const FString& InPath, double InGroupCommitWindowSeconds = 0.002);
+
+	// Write out anything pending and stop the writer thread
+	void Close();
+
+	bool IsOpen() const { return Writer.IsValid(); }
+
+	// Log every shot and reset for a lane
+	void AddLane(int32 LaneId, UBowlingScoreComponent* BowlingScoreComponent);
+
+	void RemoveLane(int32 LaneId);
+
+	// Replay the events loaded by Open into the lanes that have been added, restoring their games.
+	// Returns the number of events replayed.
+	int32 Recover();
+
+	// For events read from an input like a file or stream, the offset just past what has been read and applied once
+	// the next events are. It's logged with them, so after a crash input can resume from GetRecoveredInputOffset
+	// without applying anything twice or skipping events that never reached the disk.
+	void SetInputOffset(uint64 InInputOffset) { InputOffset = InInputOffset; }
+
+	// Input offset of the last event loaded by Open, 0 if there were none
+	uint64 GetRecoveredInputOffset() const { return RecoveredInputOffset; }
+
+	// Start a new empty log, e.g. once the night's games have been archived
+	void Truncate();
+
+	// Block until every event appended so far is on disk. Returns false if the log can't be written, events past
+	// GetDurableCount are then only in memory and are retried until the log is closed.
+	bool Flush();
+
+	// Number of events appended, and the number of those known to be on disk
+	uint64 GetAppendedCount() const;
+	uint64 GetDurableCount() const;
+
+	// The last write to disk failed and is being retried
+	bool HasWriteFailed() const;
+
+	virtual void BeginDestroy() override;
+
+protected:
+	void Append(FBowlingShotLogRecord Record);
+
+	void ShotRecorded(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot, int32 Score);
+
+	UFUNCTION()
+	void GameReset(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UPROPERTY()
+	TMap<int32, TObjectPtr<UBowlingScoreComponent>> Lanes;
+
+	// Reverse lookup of Lanes for delegates
+	TMap<TObjectKey<UBowlingScoreComponent>, int32> LaneIds;
+
+	// Events found in the log when it was opened
+	TArray<FBowlingShotLogRecord> RecoveredRecords;
+	uint64 RecoveredInputOffset = 0;
+
+	// Logged with every event appended
+	uint64 InputOffset = 0;
+
+	// Events are not logged again while they're being replayed
+	bool bRecovering = false;
+
+	FString Path;
+	double GroupCommitWindowSeconds = 0.002;
+
+	TUniquePtr<FBowlingShotLogWriter> Writer;
+};
@@ -0,0 +1,248 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "BowlingTeamMatch.generated.h"
+
+class UBowlingScoreComponent;
+
+// One game of a series, kept once the component has moved on to the next
+struct FBowlingGameRecord
+{
+	static constexpr int32 MaxFrames = 10;
+
+	// Total score as of each frame
+	int32 FrameTotals[MaxFrames];
+
+	int32 NumFrames;
+
+	// Total score so far
+	int32 Score;
+
+	bool bFinished;
+
+	// Score of a frame on its own, frames are numbered from 1
+	int32 GetFrameScore(int32 Frame) const
+	{
+		if (Frame < 1 or Frame > NumFrames) { return 0; }
+		return FrameTotals[Frame - 1] - (Frame > 1 ? FrameTotals[Frame - 2] : 0);
+	}
+};
+
+/*
+ * Game records handed out from slabs of GamesPerSlab, so a league night's games come out of a few large blocks and
+ * games freed when a series is done are reused by the next one instead of going back to the heap. Slabs are only
+ * released by Empty.
+ *
+ * Only for use on the game thread.
+ */
+class BOWLINGSCORESYSTEM_API FBowlingGamePool
+{
+public:
+	static constexpr int32 GamesPerSlab = 64;
+
+	FBowlingGamePool() = default;
+	FBowlingGamePool(const FBowlingGamePool&) = delete;
+	FBowlingGamePool& operator=(const FBowlingGamePool&) = delete;
+
+	// Shared by every match, so one night's games are reused by the next
+	static FBowlingGamePool& Get();
+
+	// A zeroed game, grows the pool by a slab if none are free
+	FBowlingGameRecord* Allocate();
+
+	void Free(FBowlingGameRecord* Game);
+
+	int32 GetNumAllocated() const { return Slabs.Num() * GamesPerSlab - FreeGames.Num(); }
+	int32 GetNumSlabs() const { return Slabs.Num(); }
+
+	// Release every slab, every game has to have been freed
+	void Empty();
+
+private:
+	struct FSlab
+	{
+		FBowlingGameRecord Games[GamesPerSlab];
+	};
+
+	TArray<TUniquePtr<FSlab>> Slabs;
+	TArray<FBowlingGameRecord*> FreeGames;
+};
+
+/*
+ * Series and team totals for a league match. Each series is a run of NumGames games that are one bowler's, or in the
+ * Baker format, a whole team's bowled together. Teams add up their series.
+ *
+ * Totals are kept up to date from each game's cumulative score as it's bowled: only the change since the last update
+ * is added to the series and its team, nothing is ever summed again from scratch. Handicap is added once per game
+ * started.
+ */
+class BOWLINGSCORESYSTEM_API FBowlingTeamMatch
+{
+public:
+	explicit FBowlingTeamMatch(int32 InNumGames = 3, FBowlingGamePool& InPool = FBowlingGamePool::Get());
+	~FBowlingTeamMatch();
+
+	FBowlingTeamMatch(const FBowlingTeamMatch&) = delete;
+	FBowlingTeamMatch& operator=(const FBowlingTeamMatch&) = delete;
+
+	// Games per series, only before any series have been added
+	void SetNumGames(int32 InNumGames);
+
+	// Returns the new team's index
+	int32 AddTeam();
+
+	// Add a series to a team, with pins of handicap for each game. Returns the new series' index.
+	int32 AddSeries(int32 Team, int32 Handicap = 0);
+
+	// Update the game in progress from its total as of each frame bowled so far, starting the series' next game if
+	// the last one was finished. Returns false once the series has all its games.
+	bool UpdateGame(int32 Series, TConstArrayView<int32> FrameTotals);
+
+	// Count the game in progress as finished
+	void FinishGame(int32 Series);
+
+	// Take the game in progress back off the totals, e.g. when it's restarted before being finished
+	void AbandonGame(int32 Series);
+
+	// Games started in a series, including one in progress
+	int32 GetNumGamesStarted(int32 Series) const;
+
+	bool IsSeriesComplete(int32 Series) const;
+
+	// Get a game of a series, games are numbered from 1. Returns nullptr if it hasn't been started.
+	const FBowlingGameRecord* GetGame(int32 Series, int32 Game) const;
+
+	int32 GetSeriesTotal(int32 Series, bool bWithHandicap = false) const;
+	int32 GetTeamTotal(int32 Team, bool bWithHandicap = false) const;
+
+	// A team's total for one game of every series
+	int32 GetTeamGameTotal(int32 Team, int32 Game, bool bWithHandicap = false) const;
+
+	int32 GetNumGames() const { return NumGames; }
+	int32 GetNumTeams() const { return Teams.Num(); }
+	int32 GetNumSeries() const { return SeriesList.Num(); }
+
+	// Clear every game for a new night with the same teams, giving them back to the pool
+	void ResetGames();
+
+private:
+	struct FSeries
+	{
+		int32 Team = 0;
+		int32 Handicap = 0;
+		int32 Total = 0;
+
+		// Last one is in progress unless it's finished
+		TArray<FBowlingGameRecord*, TInlineAllocator<3>> Games;
+
+		bool IsGameInProgress() const { return not Games.IsEmpty() and not Games.Last()->bFinished; }
+	};
+
+	struct FTeam
+	{
+		int32 Total = 0;
+		int32 HandicapTotal = 0;
+		TArray<int32> Series;
+	};
+
+	int32 NumGames;
+	FBowlingGamePool& Pool;
+	TArray<FSeries> SeriesList;
+	TArray<FTeam> Teams;
+};
+
+/*
+ * Team match fed by bowlers' UBowlingScoreComponents. A component's games make up a series, each game is counted once
+ * it's over and resetting the component starts the next one. Resetting a game before it's over takes it back off the
+ * totals.
+ *
+ * In the Baker format a team bowls one game together on a single component, taking frames in turn.
+ */
+UCLASS(BlueprintType)
+class BOWLINGSCORESYSTEM_API UBowlingTeamMatch : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Games per series, only before anything has been added
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void SetNumGames(int32 InNumGames);
+
+	// Returns the team number, which starts from 0
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 AddTeam();
+
+	// Add a bowler's games to a team
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddBowler(int32 Team, UBowlingScoreComponent* BowlingScoreComponent, int32 BowlerId, int32 Handicap = 0);
+
+	// Add a team's Baker games, bowled in the order given and starting over each game
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void AddBakerGame(int32 Team, UBowlingScoreComponent* BowlingScoreComponent, const TArray<int32>& BowlerIds,
+	                  int32 Handicap = 0);
+
+	// Stop following a component's games, what it already bowled stays in the totals
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void RemoveComponent(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetSeriesTotal(int32 BowlerId, bool bWithHandicap) const;
+
+	// Score of one of a bowler's games, starting from 1
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetGameScore(int32 BowlerId, int32 Game) const;
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetTeamTotal(int32 Team, bool bWithHandicap) const;
+
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetTeamGameTotal(int32 Team, int32 Game, bool bWithHandicap) const;
+
+	// Bowler who bowls a frame of a Baker game, INDEX_NONE for a component that isn't one
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetBakerBowler(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame) const;
+
+	// Pins a bowler scored in the frames they bowled in their team's Baker games
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	int32 GetBakerPinfall(int32 BowlerId) const;
+
+	// Clear every game for a new night with the same bowlers and teams
+	UFUNCTION(BlueprintCallable, Category=Bowling)
+	void ResetGames();
+
+	const FBowlingTeamMatch& GetMatch() const { return Match; }
+
+	// Handicap for a bowler's average, as a percentage of how far it is under the basis
+	UFUNCTION(BlueprintPure, Category=Bowling)
+	static int32 GetHandicap(int32 Average, int32 Basis = 220, float Percentage = 0.9f);
+
+protected:
+	UFUNCTION()
+	void ScoreChanged(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame);
+
+	UFUNCTION()
+	void GameOver(UBowlingScoreComponent* BowlingScoreComponent);
+
+	UFUNCTION()
+	void GameReset(UBowlingScoreComponent* BowlingScoreComponent);
+
+	// Follow a component's games as a series
+	void BindComponent(UBowlingScoreComponent* BowlingScoreComponent, int32 Series);
+
+	// Copy the game in progress into its series
+	void UpdateGame(UBowlingScoreComponent* BowlingScoreComponent, int32 Series);
+
+	// Series for each component
+	UPROPERTY()
+	TMap<TObjectPtr<UBowlingScoreComponent>, int32> Components;
+
+	TMap<int32, int32> BowlerSeries;
+
+	// Bowlers taking turns in each Baker series
+	TMap<int32, TArray<int32>> BakerBowlers;
+
+	FBowlingTeamMatch Match;
+};
@@ -0,0 +1,39 @@
+﻿// Partly Atomic LLC 2025
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingVariantScoreComponents.generated.h"
+
+/*
+ * Score components for the other variants of bowling. Each one only picks its rule set, see BowlingRuleSets.h.
+ */
+
+UCLASS()
+class BOWLINGSCORESYSTEM_API UNinePinScoreComponent : public UBowlingScoreComponent
+{
+	GENERATED_BODY()
+
+public:
+	UNinePinScoreComponent();
+};
+
+UCLASS()
+class BOWLINGSCORESYSTEM_API UFivePinScoreComponent : public UBowlingScoreComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFivePinScoreComponent();
+};
+
+// Also for duckpin, which is scored by the same rules (see FCandlepinRules)
+UCLASS()
+class BOWLINGSCORESYSTEM_API UCandlepinScoreComponent : public UBowlingScoreComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCandlepinScoreComponent();
+};
@@ -21,7 +21,14 @@ public class BowlingScoreSystemTests : ModuleRules
                 "Slate",
                 "SlateCore",
                 "CQTest",
-                "BowlingScoreSystem"
+                "Json",
+                "Projects",
+                "Sockets",
+                "MassEntity",
+                "BowlingScoreSystem",
+                "BowlingScoreUI",
+                "BowlingScoreIngest",
+                "BowlingScoreMass"
             }
         );
     }
@@ -0,0 +1,110 @@
+﻿#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "BowlingCountingMalloc.h"
+#include "BowlingLeaderboard.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "Components/Button.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/StrongObjectPtr.h"
+
+TEST_CLASS(BowlingAllocationTests, "Bowling.Allocations")
+{
+	static constexpr const TCHAR* ScoreWidgetClassPath = TEXT("/Game/Bowling/BP_BowlingScoreWidget.BP_BowlingScoreWidget_C");
+
+	FActorTestSpawner Spawner;
+
+	// Strikes, spares, open frames and a final frame with a bonus ball
+	static constexpr int32 Shots[] = {10, 7, 3, 9, 0, 10, 0, 8, 8, 2, 0, 6, 10, 10, 10, 8, 1};
+
+	// Once every buffer has grown to fit a game, entering shots and starting over shouldn't allocate
+	TEST_METHOD(Allocations_SteadyStateShots)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		TStrongObjectPtr<UBowlingLeaderboard> Leaderboard(NewObject<UBowlingLeaderboard>());
+		Leaderboard->AddBowler(Bowling, 1);
+
+		// Warm up with a couple of games
+		for (auto Game = 0; Game < 2; Game++)
+		{
+			for (auto Pins : Shots)
+			{
+				ASSERT_THAT(IsTrue(Bowling->SetScore(Pins)));
+			}
+			Bowling->Reset();
+		}
+
+		// Nothing is reported until the counting is done
+		int32 ShotAllocations[UE_ARRAY_COUNT(Shots)] = {};
+		for (auto ShotIdx = 0; ShotIdx < UE_ARRAY_COUNT(Shots); ShotIdx++)
+		{
+			const FBowlingCountingMalloc::FScope CountingScope;
+			Bowling->SetScore(Shots[ShotIdx]);
+			ShotAllocations[ShotIdx] = CountingScope.GetNumAllocations();
+		}
+		int32 ResetAllocations;
+		{
+			const FBowlingCountingMalloc::FScope CountingScope;
+			Bowling->Reset();
+			ResetAllocations = CountingScope.GetNumAllocations();
+		}
+
+		for (auto ShotIdx = 0; ShotIdx < UE_ARRAY_COUNT(Shots); ShotIdx++)
+		{
+			ASSERT_THAT(AreEqual(0, ShotAllocations[ShotIdx],
+				FString::Format(TEXT("Shot {0} allocated {1} times"), {ShotIdx + 1, ShotAllocations[ShotIdx]})));
+		}
+		ASSERT_THAT(AreEqual(0, ResetAllocations, TEXT("Reset allocated")));
+		ASSERT_THAT(IsFalse(Bowling->HasStarted()));
+		ASSERT_THAT(AreEqual(1, Leaderboard->GetRank(1)));
+	}
+
+	// The same shots with the game's scorecard showing them, handing focus on to the next shot's text box or the reset
+	// button, shouldn't allocate either. Needs the project's /Game/Bowling/BP_BowlingScoreWidget.
+	TEST_METHOD(Allocations_SteadyStateScorecard)
+	{
+		auto* ScoreWidgetClass = LoadClass<UUserWidget>(nullptr, ScoreWidgetClassPath);
+		ASSERT_THAT(IsNotNull(ScoreWidgetClass, FString::Printf(TEXT("Could not load %s"), ScoreWidgetClassPath)));
+
+		// The scorecard finds the game on its owning player's state
+		auto& Controller = Spawner.SpawnActor<APlayerController>();
+		auto& PlayerState = Spawner.SpawnActor<APlayerState>();
+		Controller.PlayerState = &PlayerState;
+		auto* Bowling = NewObject<UBowlingScoreComponent>(&PlayerState);
+		Bowling->RegisterComponent();
+
+		// Building its Slate widgets constructs the scorecard and its frames, no viewport needed
+		TStrongObjectPtr<UUserWidget> ScoreWidget(CreateWidget<UUserWidget>(&Controller, ScoreWidgetClass));
+		ASSERT_THAT(IsNotNull(ScoreWidget.Get()));
+		ScoreWidget->TakeWidget();
+		auto* ResetButton = Cast<UButton>(ScoreWidget->WidgetTree->FindWidget(TEXT("ResetButton")));
+		ASSERT_THAT(IsNotNull(ResetButton));
+
+		// Warm up with a couple of games, starting each new one from the scorecard
+		for (auto Game = 0; Game < 2; Game++)
+		{
+			for (auto Pins : Shots)
+			{
+				ASSERT_THAT(IsTrue(Bowling->SetScore(Pins)));
+			}
+			ResetButton->OnClicked.Broadcast();
+		}
+
+		int32 ShotAllocations[UE_ARRAY_COUNT(Shots)] = {};
+		for (auto ShotIdx = 0; ShotIdx < UE_ARRAY_COUNT(Shots); ShotIdx++)
+		{
+			const FBowlingCountingMalloc::FScope CountingScope;
+			Bowling->SetScore(Shots[ShotIdx]);
+			ShotAllocations[ShotIdx] = CountingScope.GetNumAllocations();
+		}
+
+		for (auto ShotIdx = 0; ShotIdx < UE_ARRAY_COUNT(Shots); ShotIdx++)
+		{
+			ASSERT_THAT(AreEqual(0, ShotAllocations[ShotIdx],
+				FString::Format(TEXT("Shot {0} allocated {1} times"), {ShotIdx + 1, ShotAllocations[ShotIdx]})));
+		}
+		ASSERT_THAT(IsTrue(Bowling->IsGameOver()));
+	}
+};
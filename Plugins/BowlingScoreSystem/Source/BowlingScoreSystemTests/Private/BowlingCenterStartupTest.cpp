@@ -0,0 +1,94 @@
+﻿#include "Blueprint/UserWidget.h"
+#include "BowlingFrameWidget.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreSystem.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectHash.h"
+
+/*
+ * Opening a whole center at once, a player with a game and a scorecard for every lane. Needs the project's
+ * /Game/Bowling/BP_BowlingScoreWidget.
+ */
+TEST_CLASS(BowlingCenterStartupTests, "Bowling.Startup")
+{
+	static constexpr const TCHAR* ScoreWidgetClassPath = TEXT("/Game/Bowling/BP_BowlingScoreWidget.BP_BowlingScoreWidget_C");
+	static constexpr int32 NumLanes = 100;
+
+	// Opening a full center has to take well under a second
+	static constexpr double StartupBudgetSeconds = 0.5;
+
+	FActorTestSpawner Spawner;
+	UClass* ScoreWidgetClass;
+	TArray<UBowlingScoreComponent*> Games;
+	TArray<TStrongObjectPtr<UUserWidget>> Scorecards;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Games.Reset();
+		Scorecards.Reset();
+		ScoreWidgetClass = LoadClass<UUserWidget>(nullptr, ScoreWidgetClassPath);
+		ASSERT_THAT(IsNotNull(ScoreWidgetClass, FString::Printf(TEXT("Could not load %s"), ScoreWidgetClassPath)));
+	}
+
+	// A player for every lane, the way the game sets them up, with the scorecard finding the game on its state
+	void OpenCenter()
+	{
+		for (auto Lane = 0; Lane < NumLanes; Lane++)
+		{
+			auto& Controller = Spawner.SpawnActor<APlayerController>();
+			auto& PlayerState = Spawner.SpawnActor<APlayerState>();
+			Controller.PlayerState = &PlayerState;
+			auto* Bowling = NewObject<UBowlingScoreComponent>(&PlayerState);
+			Bowling->RegisterComponent();
+			Games.Add(Bowling);
+			Scorecards.Emplace(CreateWidget<UUserWidget>(&Controller, ScoreWidgetClass));
+		}
+	}
+
+	static int32 CountFrameWidgets()
+	{
+		TArray<UObject*> FrameWidgets;
+		GetObjectsOfClass(UBowlingFrameWidget::StaticClass(), FrameWidgets);
+		return FrameWidgets.Num();
+	}
+
+	// Every lane's game is set up once and never reset while the center opens, and the lane on screen is ready inside
+	// the budget
+	TEST_METHOD(Startup_CenterColdStart)
+	{
+		const auto StartVersion = UBowlingScoreComponent::GetLatestStateVersion();
+		const auto StartTime = FPlatformTime::Seconds();
+		OpenCenter();
+		Scorecards[0]->TakeWidget();
+		const auto Elapsed = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogBowling, Display, TEXT("Opened %d lanes in %.3fms"), NumLanes, Elapsed * 1000.0);
+
+		// Setting up a game's frames hands out a version, so does every reset
+		const auto NumSetUps = UBowlingScoreComponent::GetLatestStateVersion() - StartVersion;
+		ASSERT_THAT(AreEqual(static_cast<uint64>(NumLanes), NumSetUps, TEXT("Games were set up more than once")));
+		for (const auto* Bowling : Games)
+		{
+			ASSERT_THAT(IsFalse(Bowling->HasStarted()));
+		}
+		ASSERT_THAT(IsTrue(Elapsed < StartupBudgetSeconds,
+			FString::Printf(TEXT("Opening %d lanes took %.3fs, over the %.3fs budget"), NumLanes, Elapsed,
+				StartupBudgetSeconds)));
+	}
+
+	// Scorecards made for every lane only build their frames once they're shown
+	TEST_METHOD(Startup_FramesBuiltWhenShown)
+	{
+		const auto NumFrameWidgets = CountFrameWidgets();
+		OpenCenter();
+		ASSERT_THAT(AreEqual(NumFrameWidgets, CountFrameWidgets()));
+
+		Scorecards[0]->TakeWidget();
+		ASSERT_THAT(AreEqual(NumFrameWidgets + Games[0]->GetNumFrames(), CountFrameWidgets()));
+	}
+};
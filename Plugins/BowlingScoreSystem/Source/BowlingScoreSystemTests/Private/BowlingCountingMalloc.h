@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+/*
+ * Forwards to the real allocator, counting what a thread allocates while it has a FBowlingCountingMalloc::FScope open.
+ * It's put in front of GMalloc the first time a scope opens and stays there for the rest of the run, so no thread
+ * ever calls into an allocator that's gone. Threads without a scope open aren't counted.
+ */
+class FBowlingCountingMalloc final : public FMalloc
+{
+public:
+	// Counts the current thread's allocations for as long as it's alive
+	class FScope
+	{
+	public:
+		FScope() : Outer(ThreadCount)
+		{
+			Install();
+			ThreadCount = &NumAllocations;
+		}
+
+		~FScope() { ThreadCount = Outer; }
+
+		FScope(const FScope&) = delete;
+		FScope& operator=(const FScope&) = delete;
+
+		int32 GetNumAllocations() const { return NumAllocations; }
+
+	private:
+		int32 NumAllocations = 0;
+
+		// Scope this one was opened inside of, which doesn't count what this one does
+		int32* Outer;
+	};
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		// Reallocating to nothing is a free
+		if (Count > 0) { CountAllocation(); }
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0) { CountAllocation(); }
+		return Inner->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void UpdateStats() override { Inner->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return TEXT("BowlingCountingMalloc"); }
+
+private:
+	explicit FBowlingCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+	// Never freed, other threads may be allocating through it right up until the process exits
+	static void Install()
+	{
+		static const auto bInstalled = []
+		{
+			GMalloc = new FBowlingCountingMalloc(GMalloc);
+			return true;
+		}();
+		(void)bInstalled;
+	}
+
+	static void CountAllocation()
+	{
+		if (ThreadCount) { (*ThreadCount)++; }
+	}
+
+	// Count of the scope open on this thread, if there is one
+	static inline thread_local int32* ThreadCount = nullptr;
+
+	FMalloc* Inner;
+};
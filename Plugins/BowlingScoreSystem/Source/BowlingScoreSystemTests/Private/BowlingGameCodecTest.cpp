@@ -0,0 +1,130 @@
+﻿#include "BowlingGameCodec.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+TEST_CLASS(BowlingGameCodecTests, "Bowling.Codec")
+{
+	FActorTestSpawner Spawner;
+	UBowlingScoreComponent* Bowling;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+	}
+
+	// Bowl games where every standing pin has the same chance of falling, returning the packed shot stream
+	TArray<uint8> BowlGames(int32 NumGames, FRandomStream& RandomStream)
+	{
+		TArray<uint8> Shots;
+		for (auto Game = 0; Game < NumGames; Game++)
+		{
+			Bowling->Reset();
+			while (not Bowling->IsGameOver())
+			{
+				auto Pins = 0;
+				for (auto Pin = 0; Pin < Bowling->GetPinsStanding(); Pin++)
+				{
+					Pins += RandomStream.GetFraction() < 0.85f ? 1 : 0;
+				}
+				Bowling->SetScore(Pins);
+			}
+			FBowlingGameCodec::AppendGame(Bowling->GetFrameScores(), Shots);
+		}
+		return Shots;
+	}
+
+	TEST_METHOD(Codec_RoundTrip)
+	{
+		FRandomStream RandomStream(1234);
+		const auto Shots = BowlGames(1000, RandomStream);
+
+		FBowlingGameCodec Codec;
+		ASSERT_THAT(IsTrue(Codec.Train(Shots)));
+
+		FBowlingGameArchive Archive;
+		ASSERT_THAT(IsTrue(Codec.Encode(Shots, Archive)));
+		ASSERT_THAT(AreEqual(1000, Archive.NumGames));
+		ASSERT_THAT(AreEqual(16, Archive.GetNumBlocks()));
+
+		// Well under a byte per shot once the model knows how the bowlers play
+		ASSERT_THAT(IsTrue(Archive.Data.Num() * 3 < Shots.Num()));
+
+		TArray<uint8> Decoded;
+		ASSERT_THAT(IsTrue(Codec.Decode(Archive, Decoded)));
+		ASSERT_THAT(IsTrue(Decoded == Shots));
+	}
+
+	// Games can be pulled out of the middle of the archive without decoding the rest
+	TEST_METHOD(Codec_RandomAccess)
+	{
+		FRandomStream RandomStream(5678);
+		TArray<TArray<uint8>> Games;
+		TArray<uint8> Shots;
+		for (auto Game = 0; Game < 200; Game++)
+		{
+			Games.Add(BowlGames(1, RandomStream));
+			Shots.Append(Games.Last());
+		}
+
+		FBowlingGameCodec Codec;
+		Codec.Train(Shots);
+		FBowlingGameArchive Archive;
+		Archive.GamesPerBlock = 16;
+		ASSERT_THAT(IsTrue(Codec.Encode(Shots, Archive)));
+
+		for (auto Game : {0, 15, 16, 100, 199})
+		{
+			TArray<uint8> Decoded;
+			ASSERT_THAT(IsTrue(Codec.DecodeGame(Archive, Game, Decoded)));
+			ASSERT_THAT(IsTrue(Decoded == Games[Game]), FString::Format(TEXT("Game {0}"), {Game}));
+		}
+
+		TArray<uint8> Decoded;
+		ASSERT_THAT(IsFalse(Codec.DecodeGame(Archive, 200, Decoded)));
+	}
+
+	TEST_METHOD(Codec_RejectsIllegalGames)
+	{
+		FBowlingGameCodec Codec;
+		FBowlingGameArchive Archive;
+
+		// Second shot knocks down more pins than were left
+		ASSERT_THAT(IsFalse(Codec.Encode({5, 6}, Archive)));
+
+		// Game isn't finished
+		ASSERT_THAT(IsFalse(Codec.Encode({10, 10, 3}, Archive)));
+		ASSERT_THAT(AreEqual(0, Archive.NumGames));
+	}
+
+	// Archive and model written at one site and read at another
+	TEST_METHOD(Codec_Serialize)
+	{
+		FRandomStream RandomStream(91011);
+		const auto Shots = BowlGames(100, RandomStream);
+
+		FBowlingGameCodec Codec;
+		Codec.Train(Shots);
+		FBowlingGameArchive Archive;
+		Codec.Encode(Shots, Archive);
+
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Codec.SerializeModel(Writer);
+		Writer << Archive;
+
+		FBowlingGameCodec LoadedCodec;
+		FBowlingGameArchive LoadedArchive;
+		FMemoryReader Reader(Bytes);
+		LoadedCodec.SerializeModel(Reader);
+		Reader << LoadedArchive;
+		ASSERT_THAT(IsFalse(Reader.IsError()));
+
+		TArray<uint8> Decoded;
+		ASSERT_THAT(IsTrue(LoadedCodec.Decode(LoadedArchive, Decoded)));
+		ASSERT_THAT(IsTrue(Decoded == Shots));
+	}
+};
@@ -0,0 +1,122 @@
+﻿#include "Async/TaskGraphInterfaces.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingGameFlowTests, "Bowling.GameFlow")
+{
+	FActorTestSpawner Spawner;
+	UBowlingScoreComponent* Bowling;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+	}
+
+	// Coroutines resume in game thread tasks
+	static void RunGameThreadTasks()
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	}
+
+	struct FResult
+	{
+		int32 NumShots = 0;
+		int32 FinalScore = -1;
+		FBowlingShotRequest Request = {-2, -2, -2};
+		bool bDone = false;
+	};
+
+	// Knock down every pin standing, one shot per resume
+	static FBowlingGameFlow BowlStrikes(UBowlingScoreComponent* Game, TSharedRef<FResult> Result)
+	{
+		while (not Game->IsGameOver())
+		{
+			const auto Request = co_await Game->NextShotRequest();
+			if (Request.IsGameOver()) { break; }
+			Game->SetScore(Request.PinsStanding);
+			Result->NumShots++;
+		}
+		Result->FinalScore = co_await Game->GameOver();
+		Result->bDone = true;
+	}
+
+	static FBowlingGameFlow AwaitShotRequest(UBowlingScoreComponent* Game, TSharedRef<FResult> Result)
+	{
+		Result->Request = co_await Game->NextShotRequest();
+		Result->bDone = true;
+	}
+
+	static FBowlingGameFlow AwaitGameOver(UBowlingScoreComponent* Game, TSharedRef<FResult> Result)
+	{
+		Result->FinalScore = co_await Game->GameOver();
+		Result->bDone = true;
+	}
+
+	TEST_METHOD(GameFlow_ScriptedBowler)
+	{
+		const auto Result = MakeShared<FResult>();
+		BowlStrikes(Bowling, Result);
+
+		// Suspended until the game thread runs its tasks
+		ASSERT_THAT(AreEqual(0, Result->NumShots));
+
+		for (auto Tick = 0; Tick < 100 and not Result->bDone; Tick++)
+		{
+			RunGameThreadTasks();
+		}
+		ASSERT_THAT(IsTrue(Result->bDone));
+		ASSERT_THAT(AreEqual(12, Result->NumShots));
+		ASSERT_THAT(AreEqual(300, Result->FinalScore));
+	}
+
+	// A finished game asks for its next shot once it's reset
+	TEST_METHOD(GameFlow_ShotRequestWaitsForReset)
+	{
+		while (Bowling->SetScore(0)) {}
+
+		const auto Result = MakeShared<FResult>();
+		AwaitShotRequest(Bowling, Result);
+		RunGameThreadTasks();
+		ASSERT_THAT(IsFalse(Result->bDone));
+
+		Bowling->Reset();
+		ASSERT_THAT(IsFalse(Result->bDone));
+		RunGameThreadTasks();
+		ASSERT_THAT(IsTrue(Result->bDone));
+		ASSERT_THAT(AreEqual(1, Result->Request.Frame));
+		ASSERT_THAT(AreEqual(1, Result->Request.Shot));
+		ASSERT_THAT(AreEqual(10, Result->Request.PinsStanding));
+	}
+
+	TEST_METHOD(GameFlow_GameOverWaitsForLastShot)
+	{
+		const auto Result = MakeShared<FResult>();
+		AwaitGameOver(Bowling, Result);
+
+		for (auto Shot = 0; Shot < 19; Shot++)
+		{
+			Bowling->SetScore(4);
+			RunGameThreadTasks();
+		}
+		ASSERT_THAT(IsFalse(Result->bDone));
+
+		Bowling->SetScore(4);
+		RunGameThreadTasks();
+		ASSERT_THAT(IsTrue(Result->bDone));
+		ASSERT_THAT(AreEqual(80, Result->FinalScore));
+	}
+
+	// Nothing is left waiting on a game that goes away
+	TEST_METHOD(GameFlow_Destroyed)
+	{
+		const auto Result = MakeShared<FResult>();
+		AwaitGameOver(Bowling, Result);
+
+		Bowling->OnComponentDestroyed(false);
+		RunGameThreadTasks();
+		ASSERT_THAT(IsTrue(Result->bDone));
+		ASSERT_THAT(AreEqual(0, Result->FinalScore));
+	}
+};
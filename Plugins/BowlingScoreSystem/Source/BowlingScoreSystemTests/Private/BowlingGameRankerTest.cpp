@@ -0,0 +1,77 @@
+﻿#include "BowlingGameRanker.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingGameRankerTests, "Bowling.Ranker")
+{
+	FBowlingGameRanker Ranker;
+
+	TEST_METHOD(Ranker_NumGames)
+	{
+		ASSERT_THAT(IsTrue(Ranker.IsSupported()));
+		ASSERT_THAT(AreEqual(5726805883325784576ull, Ranker.GetNumGames()));
+		ASSERT_THAT(IsTrue(TBowlingGameRanker<FNinePinRules>().IsSupported()));
+
+		// Three balls a frame has too many games for 64 bits
+		ASSERT_THAT(IsFalse(TBowlingGameRanker<FCandlepinRules>().IsSupported()));
+	}
+
+	TEST_METHOD(Ranker_Ends)
+	{
+		TArray<uint8> Gutters;
+		Gutters.Init(0, 20);
+		uint64 Id = 1;
+		ASSERT_THAT(IsTrue(Ranker.Rank(Gutters, Id)));
+		ASSERT_THAT(AreEqual(0ull, Id));
+
+		TArray<uint8> Perfect;
+		Perfect.Init(10, 12);
+		ASSERT_THAT(IsTrue(Ranker.Rank(Perfect, Id)));
+		ASSERT_THAT(AreEqual(Ranker.GetNumGames() - 1, Id));
+
+		TArray<uint8> Shots;
+		ASSERT_THAT(IsFalse(Ranker.Unrank(Ranker.GetNumGames(), Shots)));
+	}
+
+	TEST_METHOD(Ranker_RejectsIllegalGames)
+	{
+		uint64 Id = 0;
+		TArray<uint8> Shots = {8, 2, 5, 4, 9, 0, 10, 10, 5, 5, 5, 3, 6, 3, 9, 1, 9, 1, 10};
+		ASSERT_THAT(IsTrue(Ranker.Rank(Shots, Id)));
+
+		// Unfinished, one shot too many, and too many pins
+		ASSERT_THAT(IsFalse(Ranker.Rank(TConstArrayView<uint8>(Shots).LeftChop(1), Id)));
+		Shots.Add(3);
+		ASSERT_THAT(IsFalse(Ranker.Rank(Shots, Id)));
+		ASSERT_THAT(IsFalse(Ranker.Rank({5, 6}, Id)));
+	}
+
+	// Random ids unrank to games the score component accepts, and rank back to the same id
+	TEST_METHOD(Ranker_RoundTrip)
+	{
+		FActorTestSpawner Spawner;
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		FRandomStream RandomStream(1234);
+
+		for (auto Sample = 0; Sample < 1000; Sample++)
+		{
+			const auto Random = static_cast<uint64>(RandomStream.GetUnsignedInt()) << 32 | RandomStream.GetUnsignedInt();
+			const auto Id = Random % Ranker.GetNumGames();
+
+			TArray<uint8> Shots;
+			ASSERT_THAT(IsTrue(Ranker.Unrank(Id, Shots)));
+
+			Bowling->Reset();
+			for (auto Pins : Shots)
+			{
+				ASSERT_THAT(IsTrue(Bowling->SetScore(Pins)));
+			}
+			ASSERT_THAT(IsTrue(Bowling->IsGameOver()));
+
+			uint64 RankedId = 0;
+			ASSERT_THAT(IsTrue(Ranker.Rank(Shots, RankedId)));
+			ASSERT_THAT(AreEqual(Id, RankedId));
+		}
+	}
+};
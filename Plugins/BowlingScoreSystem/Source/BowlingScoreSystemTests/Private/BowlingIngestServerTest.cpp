@@ -0,0 +1,192 @@
+﻿#include "BowlingIngestProtocol.h"
+#include "BowlingIngestServer.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace
+{
+	constexpr int32 NumLanes = 100;
+	constexpr int32 LanesPerConnection = 10;
+
+	// Lanes after these send datagrams instead
+	constexpr int32 NumStreamLanes = 90;
+
+	// Every tenth lane bowls a perfect game, the rest knock down the same pins with every ball
+	TArray<uint8> GetLaneShots(int32 LaneId)
+	{
+		TArray<uint8> Shots;
+		if (LaneId % 10 == 0)
+		{
+			Shots.Init(10, 12);
+		}
+		else
+		{
+			Shots.Init(static_cast<uint8>(LaneId % 6), 20);
+		}
+		return Shots;
+	}
+
+	int32 GetLaneScore(int32 LaneId)
+	{
+		return LaneId % 10 == 0 ? 300 : 20 * (LaneId % 6);
+	}
+
+	FSocket* Connect(FName SocketType, int32 Port)
+	{
+		auto* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+		auto Address = SocketSubsystem->CreateInternetAddr();
+		Address->SetLoopbackAddress();
+		Address->SetPort(Port);
+
+		auto* Socket = SocketSubsystem->CreateSocket(SocketType, TEXT("BowlingIngestTestClient"), Address->GetProtocolType());
+		if (Socket and not Socket->Connect(*Address))
+		{
+			SocketSubsystem->DestroySocket(Socket);
+			return nullptr;
+		}
+		return Socket;
+	}
+
+	bool SendAll(FSocket* Socket, const TArray<uint8>& Data, int32 ChunkSize)
+	{
+		for (auto Offset = 0; Offset < Data.Num(); Offset += ChunkSize)
+		{
+			int32 BytesSent = 0;
+			const auto Size = FMath::Min(ChunkSize, Data.Num() - Offset);
+			if (not Socket->Send(Data.GetData() + Offset, Size, BytesSent) or BytesSent != Size) { return false; }
+		}
+		return true;
+	}
+}
+
+TEST_CLASS(BowlingIngestServerTests, "Bowling.Ingest")
+{
+	FActorTestSpawner Spawner;
+	TStrongObjectPtr<UBowlingIngestServer> ServerRef;
+
+	TEST_METHOD(Ingest_MessageRoundTrip)
+	{
+		FBowlingIngestMessage Message;
+		Message.Type = FBowlingIngestMessage::EType::Reset;
+		Message.Pins = 7;
+		Message.LaneId = 0x1234;
+		Message.Sequence = 0xdeadbeef;
+
+		uint8 Data[FBowlingIngestMessage::Size];
+		Message.Write(Data);
+		ASSERT_THAT(AreEqual(0x34, static_cast<int32>(Data[2])));
+
+		FBowlingIngestMessage Read;
+		ASSERT_THAT(IsTrue(Read.Read(Data)));
+		ASSERT_THAT(IsTrue(Read.Type == FBowlingIngestMessage::EType::Reset));
+		ASSERT_THAT(AreEqual(7, static_cast<int32>(Read.Pins)));
+		ASSERT_THAT(AreEqual(0x1234, static_cast<int32>(Read.LaneId)));
+		ASSERT_THAT(AreEqual(0xdeadbeef, Read.Sequence));
+
+		// Unknown types and lane 0 aren't messages
+		Data[0] = 9;
+		ASSERT_THAT(IsFalse(Read.Read(Data)));
+		Message.LaneId = 0;
+		Message.Write(Data);
+		ASSERT_THAT(IsFalse(Read.Read(Data)));
+	}
+
+	// Loopback client playing 100 lanes at once, most over TCP and the rest over UDP with repeated datagrams
+	TEST_METHOD(Ingest_LoopbackLanes)
+	{
+		// Kept alive across the latent commands
+		auto* Server = NewObject<UBowlingIngestServer>();
+		ServerRef.Reset(Server);
+		ASSERT_THAT(IsTrue(Server->Start(0, 0, true)));
+
+		TArray<UBowlingScoreComponent*> Lanes;
+		for (auto LaneId = 1; LaneId <= NumLanes; LaneId++)
+		{
+			auto* BowlingScoreComponent = &Spawner.SpawnObject<UBowlingScoreComponent>();
+			Server->AddLane(LaneId, BowlingScoreComponent);
+			Lanes.Add(BowlingScoreComponent);
+		}
+
+		auto NumShots = 0;
+		auto NumRepeated = 0;
+
+		// Each connection interleaves its lanes' shots, split across sends that don't line up with messages
+		for (auto FirstLane = 1; FirstLane <= NumStreamLanes; FirstLane += LanesPerConnection)
+		{
+			TArray<uint8> Stream;
+			for (auto ShotIdx = 0; ShotIdx < 20; ShotIdx++)
+			{
+				for (auto LaneId = FirstLane; LaneId < FirstLane + LanesPerConnection; LaneId++)
+				{
+					const auto Shots = GetLaneShots(LaneId);
+					if (not Shots.IsValidIndex(ShotIdx)) { continue; }
+
+					FBowlingIngestMessage Message;
+					Message.LaneId = static_cast<uint16>(LaneId);
+					Message.Pins = Shots[ShotIdx];
+					Message.Write(&Stream[Stream.AddUninitialized(FBowlingIngestMessage::Size)]);
+					NumShots++;
+				}
+			}
+
+			auto* Socket = Connect(NAME_Stream, Server->GetStreamPort());
+			ASSERT_THAT(IsNotNull(Socket));
+			ASSERT_THAT(IsTrue(SendAll(Socket, Stream, 13)));
+			Socket->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		}
+
+		// Every datagram repeats the lane's previous shot, which has to be dropped
+		auto* DatagramSocket = Connect(NAME_DGram, Server->GetDatagramPort());
+		ASSERT_THAT(IsNotNull(DatagramSocket));
+		for (auto LaneId = NumStreamLanes + 1; LaneId <= NumLanes; LaneId++)
+		{
+			const auto Shots = GetLaneShots(LaneId);
+			FBowlingIngestMessage Previous;
+			for (auto ShotIdx = 0; ShotIdx < Shots.Num(); ShotIdx++)
+			{
+				FBowlingIngestMessage Message;
+				Message.LaneId = static_cast<uint16>(LaneId);
+				Message.Pins = Shots[ShotIdx];
+				Message.Sequence = ShotIdx + 1;
+
+				TArray<uint8> Datagram;
+				if (ShotIdx > 0)
+				{
+					Previous.Write(&Datagram[Datagram.AddUninitialized(FBowlingIngestMessage::Size)]);
+					NumRepeated++;
+				}
+				Message.Write(&Datagram[Datagram.AddUninitialized(FBowlingIngestMessage::Size)]);
+				ASSERT_THAT(IsTrue(SendAll(DatagramSocket, Datagram, Datagram.Num())));
+				NumShots++;
+				Previous = Message;
+			}
+		}
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(DatagramSocket);
+
+		TestCommandBuilder
+			.Until([Lanes]
+			{
+				for (auto* BowlingScoreComponent : Lanes)
+				{
+					if (not BowlingScoreComponent->IsGameOver()) { return false; }
+				}
+				return true;
+			})
+			.Then([this, Server, Lanes, NumShots, NumRepeated]
+			{
+				for (auto LaneIdx = 0; LaneIdx < Lanes.Num(); LaneIdx++)
+				{
+					ASSERT_THAT(AreEqual(GetLaneScore(LaneIdx + 1), Lanes[LaneIdx]->GetScore(10)));
+				}
+				ASSERT_THAT(AreEqual(static_cast<int64>(NumShots), Server->GetNumApplied()));
+				ASSERT_THAT(AreEqual(static_cast<int64>(NumRepeated), Server->GetNumRejected()));
+				ASSERT_THAT(AreEqual(static_cast<int64>(0), Server->GetNumMalformed()));
+				Server->Stop();
+			});
+	}
+};
@@ -0,0 +1,198 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "BowlingCountingMalloc.h"
+#include "BowlingFrameWidget.h"
+#include "BowlingLatencyTracker.h"
+#include "BowlingScoreComponent.h"
+#include "Components/ActorTestSpawner.h"
+#include "Components/Button.h"
+#include "Components/EditableTextBox.h"
+#include "Components/TextBlock.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Input/Events.h"
+#include "UObject/StrongObjectPtr.h"
+
+// A replayed keystroke and what came of it
+struct FBowlingKeystroke
+{
+	TCHAR Character = 0;
+
+	// Handling the key, from it reaching the text box to the scorecard's widgets being up to date and ready for the
+	// next one. Laying out and painting the change is left to Slate's next tick and isn't counted.
+	double Micros = 0.0;
+	int32 Allocations = 0;
+
+	// Recorded as a shot, rather than rejected by ValidateTextEntry
+	bool bAccepted = false;
+
+	// Had no enabled text box to go to, the way Slate drops keys for disabled widgets
+	bool bDropped = false;
+
+	// Afterwards the box for the shot up next was enabled and the one its frame wants focus on
+	bool bFocusHandedOff = false;
+};
+
+/*
+ * Replays typed scores into a scorecard the way front-desk staff enter them, one character per keystroke. Each key
+ * goes to the text box the current frame wants focus on and is typed straight into its SEditableText, so the whole
+ * chain of OnTextChanged, ValidateTextEntry, SetScore, OnGameAdvanced, GameAdvanced and UpdateScore runs for it
+ * before it returns. The scorecard's Slate widgets are built without a viewport, so it runs under -nullrhi, and
+ * nothing ticks or paints them: what's timed is handling the key, not getting it on screen.
+ */
+class FBowlingInputReplay
+{
+public:
+	static constexpr const TCHAR* ScoreWidgetClassPath = TEXT("/Game/Bowling/BP_BowlingScoreWidget.BP_BowlingScoreWidget_C");
+
+	// Build a player with a score component and the game's scorecard for it. Returns false if the scorecard blueprint
+	// couldn't be loaded.
+	bool Setup(FActorTestSpawner& Spawner)
+	{
+		auto* ScoreWidgetClass = LoadClass<UUserWidget>(nullptr, ScoreWidgetClassPath);
+		if (not ScoreWidgetClass) { return false; }
+
+		// The scorecard finds the game on its owning player's state
+		auto& Controller = Spawner.SpawnActor<APlayerController>();
+		auto& PlayerState = Spawner.SpawnActor<APlayerState>();
+		Controller.PlayerState = &PlayerState;
+		Bowling = NewObject<UBowlingScoreComponent>(&PlayerState);
+		Bowling->RegisterComponent();
+
+		ScoreWidget.Reset(CreateWidget<UUserWidget>(&Controller, ScoreWidgetClass));
+		if (not ScoreWidget) { return false; }
+
+		// Building its Slate widgets constructs the scorecard and its frames, no viewport needed
+		ScoreWidget->TakeWidget();
+		Latencies = MakeUnique<FBowlingLatencyHistogram>();
+		return true;
+	}
+
+	// Type every character of Keys in turn
+	void Type(const FString& Keys)
+	{
+		for (const auto Character : Keys)
+		{
+			Press(Character);
+		}
+	}
+
+	void Press(TCHAR Character)
+	{
+		auto& Keystroke = Keystrokes.AddDefaulted_GetRef();
+		Keystroke.Character = Character;
+
+		auto* TextBox = GetFocusedTextBox();
+		TSharedPtr<SWidget> EditableText;
+		if (TextBox and TextBox->GetIsEnabled()) { EditableText = FindEditableText(TextBox->TakeWidget()); }
+		if (not EditableText)
+		{
+			Keystroke.bDropped = true;
+			return;
+		}
+
+		const auto NumShots = Bowling->GetNumShotsRecorded();
+		const FCharacterEvent CharacterEvent(Character, FModifierKeysState(), 0, false);
+
+		uint64 StartCycles;
+		uint64 EndCycles;
+		{
+			const FBowlingCountingMalloc::FScope CountingScope;
+			StartCycles = FPlatformTime::Cycles64();
+			EditableText->OnKeyChar(FGeometry(), CharacterEvent);
+			EndCycles = FPlatformTime::Cycles64();
+			Keystroke.Allocations = CountingScope.GetNumAllocations();
+		}
+
+		Keystroke.Micros = FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0;
+		Keystroke.bAccepted = Bowling->GetNumShotsRecorded() > NumShots;
+		Latencies->Record(static_cast<uint64>(Keystroke.Micros));
+
+		// Game over hands focus to the reset button instead
+		if (Bowling->IsGameOver())
+		{
+			Keystroke.bFocusHandedOff = GetFocusedTextBox() == nullptr;
+		}
+		else
+		{
+			auto* NextTextBox = GetShotTextBox(Bowling->GetCurrentFrameNum(), Bowling->GetCurrentShotNum());
+			Keystroke.bFocusHandedOff = NextTextBox and NextTextBox == GetFocusedTextBox()
+				and NextTextBox->GetIsEnabled() and not NextTextBox->GetIsReadOnly();
+		}
+	}
+
+	// Click the scorecard's reset button for a new game
+	void ClickReset()
+	{
+		if (auto* ResetButton = Cast<UButton>(ScoreWidget->WidgetTree->FindWidget(TEXT("ResetButton"))))
+		{
+			ResetButton->OnClicked.Broadcast();
+		}
+	}
+
+	UBowlingScoreComponent* GetBowling() const { return Bowling; }
+	UUserWidget* GetScoreWidget() const { return ScoreWidget.Get(); }
+
+	UBowlingFrameWidget* GetFrameWidget(int32 Frame) const
+	{
+		return Cast<UBowlingFrameWidget>(ScoreWidget->WidgetTree->FindWidget(*FString::Printf(TEXT("Frame%d"), Frame)));
+	}
+
+	// Text box for a shot of a frame, null if the frame doesn't have the shot
+	UEditableTextBox* GetShotTextBox(int32 Frame, int32 Shot) const
+	{
+		const auto* FrameWidget = GetFrameWidget(Frame);
+		if (not FrameWidget) { return nullptr; }
+		const auto Name = FString::Printf(TEXT("Shot%dTextBox"), Shot);
+		return Cast<UEditableTextBox>(FrameWidget->WidgetTree->FindWidget(*Name));
+	}
+
+	FText GetFrameScoreText(int32 Frame) const
+	{
+		const auto* FrameWidget = GetFrameWidget(Frame);
+		if (not FrameWidget) { return FText::GetEmpty(); }
+
+		const auto* ScoreText = Cast<UTextBlock>(FrameWidget->WidgetTree->FindWidget(TEXT("ScoreText")));
+		return ScoreText ? ScoreText->GetText() : FText::GetEmpty();
+	}
+
+	// Text box keys go to: the one the current frame wants focus on, null once the game is over
+	UEditableTextBox* GetFocusedTextBox() const
+	{
+		const auto* FrameWidget = Bowling->IsGameOver() ? nullptr : GetFrameWidget(Bowling->GetCurrentFrameNum());
+		return FrameWidget ? Cast<UEditableTextBox>(FrameWidget->GetDesiredFocusWidget()) : nullptr;
+	}
+
+	const TArray<FBowlingKeystroke>& GetKeystrokes() const { return Keystrokes; }
+	const FBowlingLatencyHistogram& GetLatencies() const { return *Latencies; }
+
+	void ResetStats()
+	{
+		Keystrokes.Reset();
+		Latencies->Reset();
+	}
+
+private:
+	// The text box's editable text, which is what receives typed characters
+	static TSharedPtr<SWidget> FindEditableText(const TSharedRef<SWidget>& Widget)
+	{
+		if (Widget->GetType() == TEXT("SEditableText")) { return Widget; }
+
+		auto* Children = Widget->GetChildren();
+		for (auto ChildIdx = 0; Children and ChildIdx < Children->Num(); ChildIdx++)
+		{
+			if (auto Found = FindEditableText(Children->GetChildAt(ChildIdx))) { return Found; }
+		}
+		return nullptr;
+	}
+
+	// Kept alive by the player state it's on
+	UBowlingScoreComponent* Bowling = nullptr;
+
+	TStrongObjectPtr<UUserWidget> ScoreWidget;
+	TArray<FBowlingKeystroke> Keystrokes;
+	TUniquePtr<FBowlingLatencyHistogram> Latencies;
+};
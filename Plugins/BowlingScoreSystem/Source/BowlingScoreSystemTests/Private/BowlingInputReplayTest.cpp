@@ -0,0 +1,171 @@
+﻿#include "BowlingInputReplay.h"
+#include "BowlingPerformanceBaselines.h"
+#include "CQTest.h"
+
+/*
+ * Typed score entry through the game's scorecard, see FBowlingInputReplay. Needs the project's
+ * /Game/Bowling/BP_BowlingScoreWidget. The allocations a key may make are a baseline in Baselines/Performance.json,
+ * recorded with -BowlingRecordBaselines like Bowling.Performance's.
+ */
+TEST_CLASS(BowlingInputReplayTests, "Bowling.InputReplay")
+{
+	FActorTestSpawner Spawner;
+	FBowlingInputReplay Replay;
+
+	// A game typed at the front desk. A stray / on a first ball, a letter and a 5 with only two pins standing are
+	// rejected along the way, and it finishes on 185.
+	static constexpr const TCHAR* LeagueGame = TEXT("9/X/72a8/x0/X85/X9/7");
+
+	// Handling a key can't take a whole frame at 60 Hz, or there's nothing left of it to lay out and paint the change
+	static constexpr uint64 FrameBudgetMicros = 16667;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Replay = FBowlingInputReplay();
+		ASSERT_THAT(IsTrue(Replay.Setup(Spawner),
+			FString::Printf(TEXT("Could not create the scorecard from %s"), FBowlingInputReplay::ScoreWidgetClassPath)));
+	}
+
+	TEST_METHOD(Input_ReplayGame)
+	{
+		Replay.Type(LeagueGame);
+
+		auto* Bowling = Replay.GetBowling();
+		ASSERT_THAT(IsTrue(Bowling->IsGameOver()));
+		ASSERT_THAT(AreEqual(185, Bowling->GetScore(10)));
+
+		auto NumAccepted = 0;
+		for (const auto& Keystroke : Replay.GetKeystrokes())
+		{
+			NumAccepted += Keystroke.bAccepted ? 1 : 0;
+			ASSERT_THAT(IsFalse(Keystroke.bDropped));
+			ASSERT_THAT(IsTrue(Keystroke.bFocusHandedOff,
+				FString::Printf(TEXT("Focus wasn't handed off after typing %c"), Keystroke.Character)));
+		}
+		ASSERT_THAT(AreEqual(17, NumAccepted));
+
+		// Numbers that finish a rack are shown as marks
+		ASSERT_THAT(AreEqual(FString(TEXT("9")), Replay.GetShotTextBox(1, 1)->GetText().ToString()));
+		ASSERT_THAT(AreEqual(FString(TEXT("/")), Replay.GetShotTextBox(1, 2)->GetText().ToString()));
+		ASSERT_THAT(AreEqual(FString(TEXT("/")), Replay.GetShotTextBox(6, 2)->GetText().ToString()));
+		ASSERT_THAT(AreEqual(FString(TEXT("7")), Replay.GetShotTextBox(10, 3)->GetText().ToString()));
+		ASSERT_THAT(AreEqual(FString(TEXT("48")), Replay.GetFrameScoreText(3).ToString()));
+		ASSERT_THAT(AreEqual(FString(TEXT("185")), Replay.GetFrameScoreText(10).ToString()));
+
+		// Nothing takes keys once the game is over, until it's reset from the scorecard
+		Replay.Press('9');
+		ASSERT_THAT(IsTrue(Replay.GetKeystrokes().Last().bDropped));
+
+		Replay.ClickReset();
+		ASSERT_THAT(AreEqual(0, Bowling->GetNumShotsRecorded()));
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(1, 1)));
+		ASSERT_THAT(IsTrue(Replay.GetShotTextBox(1, 1)->GetText().IsEmpty()));
+		ASSERT_THAT(IsTrue(Replay.GetFrameScoreText(10).IsEmpty()));
+	}
+
+	// SetCurrentGameState moves entry along one box at a time, and a rejected key leaves it where it was
+	TEST_METHOD(Input_FocusHandOff)
+	{
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(1, 1)));
+
+		Replay.Press('X');
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(2, 1)));
+		ASSERT_THAT(IsFalse(Replay.GetShotTextBox(1, 1)->GetIsEnabled()));
+
+		Replay.Press('3');
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(2, 2)));
+
+		Replay.Press('9');
+		ASSERT_THAT(IsFalse(Replay.GetKeystrokes().Last().bAccepted));
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(2, 2)));
+		ASSERT_THAT(IsTrue(Replay.GetShotTextBox(2, 2)->GetIsEnabled()));
+		ASSERT_THAT(IsTrue(Replay.GetShotTextBox(2, 2)->GetText().IsEmpty()));
+
+		Replay.Press('6');
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(3, 1)));
+
+		// The final frame takes a third box after a strike
+		Replay.Type(TEXT("XXXXXXXXX"));
+		ASSERT_THAT(IsTrue(Replay.GetFocusedTextBox() == Replay.GetShotTextBox(10, 3)));
+		ASSERT_THAT(IsNull(Replay.GetShotTextBox(9, 3)));
+
+		Replay.Press('X');
+		ASSERT_THAT(IsTrue(Replay.GetBowling()->IsGameOver()));
+		ASSERT_THAT(IsNull(Replay.GetFocusedTextBox()));
+	}
+
+	// Games typed one after another, timing how long every key takes to handle, from reaching the text box to the
+	// scorecard's widgets being up to date
+	TEST_METHOD(Input_KeystrokeHandling)
+	{
+		constexpr auto NumGames = 20;
+		const auto Baseline = FBowlingPerformanceBaselines::Load(TEXT("Input_KeystrokeHandling"));
+		ASSERT_THAT(IsTrue(Baseline.IsValid(), FString::Printf(
+			TEXT("No baseline for Input_KeystrokeHandling in %s"), *FBowlingPerformanceBaselines::GetPath())));
+
+		// The first game warms up caches and shared text, the rest are what the desk sees all night
+		Replay.Type(LeagueGame);
+		Replay.ClickReset();
+		Replay.ResetStats();
+
+		TArray<int32> GameAllocations;
+		for (auto Game = 1; Game < NumGames; Game++)
+		{
+			const auto FirstKeystroke = Replay.GetKeystrokes().Num();
+			Replay.Type(LeagueGame);
+			ASSERT_THAT(AreEqual(185, Replay.GetBowling()->GetScore(10)));
+
+			auto Allocations = 0;
+			for (auto Idx = FirstKeystroke; Idx < Replay.GetKeystrokes().Num(); Idx++)
+			{
+				Allocations += Replay.GetKeystrokes()[Idx].Allocations;
+			}
+			GameAllocations.Add(Allocations);
+			Replay.ClickReset();
+		}
+
+		auto MaxMicros = 0.0;
+		auto MaxAllocations = 0;
+		for (const auto& Keystroke : Replay.GetKeystrokes())
+		{
+			MaxMicros = FMath::Max(MaxMicros, Keystroke.Micros);
+			MaxAllocations = FMath::Max(MaxAllocations, Keystroke.Allocations);
+		}
+
+		// Only the games after the warm-up were recorded, so one slow key from a cold cache doesn't decide it
+		const auto& Latencies = Replay.GetLatencies();
+		const auto P99Micros = Latencies.GetPercentile(0.99);
+		TestRunner.AddInfo(FString::Printf(
+			TEXT("%llu keystrokes, handled in p50 %llu us, p99 %llu us, max %.0f us, at most %d allocations per key, "
+				"%d per game typed"), Latencies.GetCount(), Latencies.GetPercentile(0.5), P99Micros, MaxMicros,
+			MaxAllocations, GameAllocations.Last()));
+
+		ASSERT_THAT(IsTrue(P99Micros < FrameBudgetMicros,
+			FString::Printf(TEXT("p99 keystroke handling took %llu us, longer than a frame"), P99Micros)));
+
+		if (FBowlingPerformanceBaselines::IsRecording())
+		{
+			ASSERT_THAT(IsTrue(FBowlingPerformanceBaselines::Record(TEXT("Input_KeystrokeHandling"),
+				{{TEXT("KeyAllocations"), static_cast<double>(MaxAllocations)}}),
+				TEXT("Could not record the baseline for Input_KeystrokeHandling")));
+		}
+		else
+		{
+			double KeyAllocations = 0.0;
+			double KeyAllocationTolerance = 0.0;
+			Baseline->TryGetNumberField(TEXT("KeyAllocationTolerance"), KeyAllocationTolerance);
+			ASSERT_THAT(IsTrue(Baseline->TryGetNumberField(TEXT("KeyAllocations"), KeyAllocations),
+				TEXT("Input_KeystrokeHandling has no \"KeyAllocations\" baseline, record one with "
+					"-BowlingRecordBaselines")));
+			ASSERT_THAT(IsTrue(MaxAllocations <= KeyAllocations + KeyAllocationTolerance,
+				FString::Printf(TEXT("A keystroke allocated %d times, baseline is %.0f"), MaxAllocations,
+					KeyAllocations)));
+		}
+
+		// Nothing builds up from game to game
+		ASSERT_THAT(IsTrue(GameAllocations.Last() <= GameAllocations[0],
+			FString::Printf(TEXT("Typing a game allocated %d times, up from %d"), GameAllocations.Last(),
+				GameAllocations[0])));
+	}
+};
@@ -0,0 +1,113 @@
+﻿#include "BowlingLaneServerCommandlet.h"
+#include "BowlingShotLog.h"
+#include "CQTest.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+TEST_CLASS(BowlingLaneServerTests, "Bowling.LaneServer")
+{
+	FString InputPath;
+	FString OutputPath;
+	FString LogPath;
+
+	BEFORE_EACH()
+	{
+		const auto Dir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"));
+		InputPath = FPaths::Combine(Dir, TEXT("BowlingLaneServerInput.txt"));
+		OutputPath = FPaths::Combine(Dir, TEXT("BowlingLaneServerOutput.txt"));
+		LogPath = FPaths::Combine(Dir, TEXT("BowlingLaneServerLog.bin"));
+		DeleteFiles();
+	}
+
+	AFTER_EACH()
+	{
+		DeleteFiles();
+	}
+
+	void DeleteFiles()
+	{
+		auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.DeleteFile(*InputPath);
+		PlatformFile.DeleteFile(*OutputPath);
+		PlatformFile.DeleteFile(*LogPath);
+	}
+
+	// Run the server over the input in a "new process"
+	int32 RunServer(const TCHAR* ExtraParams = TEXT(""))
+	{
+		auto* Server = NewObject<UBowlingLaneServerCommandlet>();
+		return Server->Main(FString::Printf(TEXT("-Input=\"%s\" -Output=\"%s\" -ShotLog=\"%s\" %s"), *InputPath,
+		                                    *OutputPath, *LogPath, ExtraParams));
+	}
+
+	// Lane state published by every run so far
+	TArray<FString> GetOutput()
+	{
+		TArray<FString> Lines;
+		FFileHelper::LoadFileToStringArray(Lines, *OutputPath);
+		return Lines;
+	}
+
+	// Every lane keeps its own game and publishes it after each command
+	TEST_METHOD(LaneServer_ScoresLanes)
+	{
+		ASSERT_THAT(IsTrue(FFileHelper::SaveStringToFile(TEXT("1 10\n2 7\n2 3\n1 4\n# comment\n\n2 reset\n"),
+		                                                  *InputPath)));
+		ASSERT_THAT(AreEqual(0, RunServer(TEXT("-Lanes=2"))));
+
+		const auto Output = GetOutput();
+		ASSERT_THAT(AreEqual(5, Output.Num()));
+		ASSERT_THAT(AreEqual(FString(TEXT("{\"lane\":1,\"frame\":2,\"shot\":1,\"over\":false,"
+			"\"scores\":[10,10,10,10,10,10,10,10,10,10]}")), Output[0]));
+		ASSERT_THAT(AreEqual(FString(TEXT("{\"lane\":2,\"frame\":2,\"shot\":1,\"over\":false,"
+			"\"scores\":[10,10,10,10,10,10,10,10,10,10]}")), Output[2]));
+		ASSERT_THAT(IsTrue(Output[3].StartsWith(TEXT("{\"lane\":1,\"frame\":2,\"shot\":2,\"over\":false,"
+			"\"scores\":[14,18,"))));
+		ASSERT_THAT(AreEqual(FString(TEXT("{\"lane\":2,\"frame\":1,\"shot\":1,\"over\":false,"
+			"\"scores\":[0,0,0,0,0,0,0,0,0,0]}")), Output[4]));
+	}
+
+	// Anything that isn't a whole pin count for a lane that exists is logged and skipped, and nothing is published
+	TEST_METHOD(LaneServer_IgnoresBadInput)
+	{
+		ASSERT_THAT(IsTrue(FFileHelper::SaveStringToFile(
+			TEXT("1 1.5\n1 +3\n1 -0\n1 x\n1 11\n3 5\n1\nbowl\n1 4\n"), *InputPath)));
+		ASSERT_THAT(AreEqual(0, RunServer()));
+
+		const auto Output = GetOutput();
+		ASSERT_THAT(AreEqual(1, Output.Num()));
+		ASSERT_THAT(IsTrue(Output[0].StartsWith(TEXT("{\"lane\":1,\"frame\":1,\"shot\":2,"))));
+	}
+
+	// The server dies partway through the input, before its last shot reached the disk, and is restarted on the same
+	// input once the lane controller has written more of it
+	TEST_METHOD(LaneServer_RestartMidInput)
+	{
+		ASSERT_THAT(IsTrue(FFileHelper::SaveStringToFile(TEXT("1 9\n1 1\n1 10\n1 3\n1 4\n"), *InputPath)));
+		ASSERT_THAT(AreEqual(0, RunServer()));
+
+		// Lose the last shot and leave a torn record in its place
+		TArray<uint8> Data;
+		ASSERT_THAT(IsTrue(FFileHelper::LoadFileToArray(Data, *LogPath)));
+		ASSERT_THAT(AreEqual(5 * static_cast<int32>(sizeof(FBowlingShotLogRecord)), Data.Num()));
+		Data.SetNum(4 * sizeof(FBowlingShotLogRecord) + 3);
+		ASSERT_THAT(IsTrue(FFileHelper::SaveArrayToFile(Data, *LogPath)));
+
+		ASSERT_THAT(IsTrue(FFileHelper::SaveStringToFile(TEXT("1 5\n1 2\n"), *InputPath,
+		                                                  FFileHelper::EEncodingOptions::AutoDetect,
+		                                                  &IFileManager::Get(), FILEWRITE_Append)));
+		ASSERT_THAT(AreEqual(0, RunServer()));
+
+		// 9/ X 34 52, with every shot applied exactly once
+		const auto Output = GetOutput();
+		ASSERT_THAT(AreEqual(8, Output.Num()));
+		ASSERT_THAT(IsTrue(Output.Last().StartsWith(TEXT("{\"lane\":1,\"frame\":5,\"shot\":1,\"over\":false,"))));
+		ASSERT_THAT(IsTrue(Output.Last().Contains(TEXT("\"scores\":[20,37,44,51,"))));
+
+		// Restarting again with nothing new has nothing left to apply
+		ASSERT_THAT(AreEqual(0, RunServer()));
+		ASSERT_THAT(AreEqual(8, GetOutput().Num()));
+	}
+};
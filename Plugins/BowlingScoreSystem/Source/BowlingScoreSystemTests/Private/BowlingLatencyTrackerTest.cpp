@@ -0,0 +1,130 @@
+﻿#include "BowlingLatencyTracker.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/StringOutputDevice.h"
+
+TEST_CLASS(BowlingLatencyTrackerTests, "Bowling.Latency")
+{
+	FActorTestSpawner Spawner;
+	IConsoleVariable* Enabled = nullptr;
+	bool bWasEnabled = false;
+
+	// Shots are only timed when asked for
+	BEFORE_EACH()
+	{
+		Enabled = IConsoleManager::Get().FindConsoleVariable(TEXT("Bowling.Latency.Enabled"));
+		ASSERT_THAT(IsNotNull(Enabled));
+		bWasEnabled = Enabled->GetBool();
+		Enabled->Set(true);
+	}
+
+	AFTER_EACH()
+	{
+		if (Enabled) { Enabled->Set(bWasEnabled); }
+	}
+
+	TEST_METHOD(Latency_HistogramPercentiles)
+	{
+		auto Histogram = MakeUnique<FBowlingLatencyHistogram>();
+		ASSERT_THAT(AreEqual(0ull, Histogram->GetPercentile(0.5)));
+
+		for (auto Micros = 1; Micros <= 1000; Micros++)
+		{
+			Histogram->Record(Micros);
+		}
+
+		// Reported as the top of the bucket, which is never more than about 3% over
+		ASSERT_THAT(AreEqual(1000ull, Histogram->GetCount()));
+		const auto P50 = Histogram->GetPercentile(0.5);
+		const auto P99 = Histogram->GetPercentile(0.99);
+		const auto P999 = Histogram->GetPercentile(0.999);
+		ASSERT_THAT(IsTrue(P50 >= 500 and P50 <= 515));
+		ASSERT_THAT(IsTrue(P99 >= 990 and P99 <= 1020));
+		ASSERT_THAT(IsTrue(P999 >= 999 and P999 <= 1030));
+
+		// Small values are exact and huge ones are clamped rather than lost
+		Histogram->Reset();
+		Histogram->Record(7);
+		Histogram->Record(MAX_uint64);
+		ASSERT_THAT(AreEqual(7ull, Histogram->GetPercentile(0.5)));
+		ASSERT_THAT(AreEqual(static_cast<uint64>(MAX_uint32), Histogram->GetPercentile(1.0)));
+	}
+
+	TEST_METHOD(Latency_BucketBounds)
+	{
+		for (auto Bucket = 0; Bucket < FBowlingLatencyHistogram::NumBuckets; Bucket++)
+		{
+			const auto Min = FBowlingLatencyHistogram::GetBucketMin(Bucket);
+			const auto Max = FBowlingLatencyHistogram::GetBucketMax(Bucket);
+			ASSERT_THAT(AreEqual(Bucket, FBowlingLatencyHistogram::GetBucket(Min)));
+			ASSERT_THAT(AreEqual(Bucket, FBowlingLatencyHistogram::GetBucket(Max)));
+			if (Bucket > 0)
+			{
+				ASSERT_THAT(AreEqual(FBowlingLatencyHistogram::GetBucketMax(Bucket - 1) + 1, Min));
+			}
+		}
+	}
+
+	// Without a scorecard only the component's own stages are reached
+	TEST_METHOD(Latency_RecordsShots)
+	{
+		auto* BowlingScoreComponent = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		BowlingScoreComponent->SetScore(10);
+		BowlingScoreComponent->SetScore(4);
+		BowlingScoreComponent->SetScore(5);
+
+		// Rejected shots aren't timed
+		BowlingScoreComponent->SetScore(11);
+
+		auto& Tracker = FBowlingLatencyTracker::Get();
+		const auto* Recorded = Tracker.Find(*BowlingScoreComponent, EBowlingLatencyStage::Recorded);
+		const auto* Broadcast = Tracker.Find(*BowlingScoreComponent, EBowlingLatencyStage::Broadcast);
+		const auto* GameAdvanced = Tracker.Find(*BowlingScoreComponent, EBowlingLatencyStage::GameAdvanced);
+		ASSERT_THAT(IsNotNull(Recorded));
+		ASSERT_THAT(AreEqual(3ull, Recorded->GetCount()));
+		ASSERT_THAT(AreEqual(3ull, Broadcast->GetCount()));
+		ASSERT_THAT(AreEqual(0ull, GameAdvanced->GetCount()));
+		ASSERT_THAT(IsTrue(Recorded->GetPercentile(1.0) <= Broadcast->GetPercentile(1.0)));
+
+		const auto Path = FPaths::AutomationTransientDir() / TEXT("BowlingLatency.csv");
+		ASSERT_THAT(IsTrue(Tracker.DumpCsv(Path)));
+		TArray<FString> Lines;
+		ASSERT_THAT(IsTrue(FFileHelper::LoadFileToStringArray(Lines, *Path)));
+		ASSERT_THAT(AreEqual(FString(TEXT("Lane,Stage,Shots,P50Us,P99Us,P999Us")), Lines[0]));
+		ASSERT_THAT(IsTrue(Lines.ContainsByPredicate([&](const FString& Line)
+		{
+			return Line.StartsWith(BowlingScoreComponent->GetReadableName() + TEXT(",Broadcast,3,"));
+		})));
+
+		// The lane goes with its component
+		BowlingScoreComponent->OnComponentDestroyed(false);
+		ASSERT_THAT(IsNull(Tracker.Find(*BowlingScoreComponent, EBowlingLatencyStage::Recorded)));
+	}
+
+	// More shots in a frame than are kept for the render thread are counted rather than lost without a trace
+	TEST_METHOD(Latency_CountsUntimedRenders)
+	{
+		auto& Tracker = FBowlingLatencyTracker::Get();
+		const auto NumUntimed = Tracker.GetNumUntimedRenders();
+
+		// Nothing draws a frame in between
+		auto* BowlingScoreComponent = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		for (auto Game = 0; Game < 30; Game++)
+		{
+			while (not BowlingScoreComponent->IsGameOver())
+			{
+				BowlingScoreComponent->SetScore(10);
+			}
+			BowlingScoreComponent->Reset();
+		}
+		ASSERT_THAT(IsTrue(Tracker.GetNumUntimedRenders() > NumUntimed));
+
+		FStringOutputDevice Report;
+		Tracker.Report(Report);
+		ASSERT_THAT(IsTrue(Report.Contains(TEXT("weren't timed to the screen"))));
+	}
+};
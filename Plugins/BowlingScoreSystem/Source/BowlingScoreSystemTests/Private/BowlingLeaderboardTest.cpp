@@ -0,0 +1,135 @@
+﻿#include "BowlingLeaderboard.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingLeaderboardTests, "Bowling.Leaderboard")
+{
+	// Check the leaderboard against a plain sort of the same entries
+	void CheckAgainstSort(const FBowlingLeaderboard& Leaderboard, TArray<FBowlingLeaderboardEntry> Expected)
+	{
+		Expected.Sort([](const FBowlingLeaderboardEntry& A, const FBowlingLeaderboardEntry& B)
+		{
+			return A.GetTotal() > B.GetTotal() or (A.GetTotal() == B.GetTotal() and A.BowlerId < B.BowlerId);
+		});
+
+		ASSERT_THAT(AreEqual(Expected.Num(), Leaderboard.Num()));
+
+		TArray<FBowlingLeaderboardEntry> Entries;
+		Leaderboard.GetRange(1, Expected.Num(), Entries);
+		ASSERT_THAT(AreEqual(Expected.Num(), Entries.Num()));
+
+		for (auto Idx = 0; Idx < Expected.Num(); Idx++)
+		{
+			ASSERT_THAT(AreEqual(Expected[Idx].BowlerId, Entries[Idx].BowlerId,
+				FString::Format(TEXT("Position {0}: Expected bowler {1} instead of {2}"),
+					{Idx + 1, Expected[Idx].BowlerId, Entries[Idx].BowlerId})));
+
+			auto Rank = Leaderboard.GetRank(Expected[Idx].BowlerId);
+			ASSERT_THAT(AreEqual(Idx + 1, Rank,
+				FString::Format(TEXT("Bowler {0}: Expected rank {1} instead of {2}"), {Expected[Idx].BowlerId, Idx + 1, Rank})));
+		}
+	}
+
+	TEST_METHOD(Leaderboard_Empty)
+	{
+		FBowlingLeaderboard Leaderboard;
+		TArray<FBowlingLeaderboardEntry> Entries;
+		Leaderboard.GetRange(1, 10, Entries);
+
+		ASSERT_THAT(AreEqual(0, Leaderboard.Num()));
+		ASSERT_THAT(AreEqual(0, Entries.Num()));
+		ASSERT_THAT(AreEqual(INDEX_NONE, Leaderboard.GetRank(1)));
+		ASSERT_THAT(IsFalse(Leaderboard.Remove(1)));
+	}
+
+	// Simulate a tournament where every shot updates one entrant
+	TEST_METHOD(Leaderboard_IncrementalUpdates)
+	{
+		FRandomStream Random(1234);
+		FBowlingLeaderboard Leaderboard;
+		TArray<FBowlingLeaderboardEntry> Expected;
+
+		for (auto BowlerId = 0; BowlerId < 400; BowlerId++)
+		{
+			auto& Entry = Expected.AddDefaulted_GetRef();
+			Entry.BowlerId = BowlerId;
+			Entry.SeriesTotal = Random.RandRange(0, 600);
+			Leaderboard.Update(Entry);
+		}
+		CheckAgainstSort(Leaderboard, Expected);
+
+		for (auto Shot = 0; Shot < 4000; Shot++)
+		{
+			auto& Entry = Expected[Random.RandRange(0, Expected.Num() - 1)];
+			Entry.CurrentScore += Random.RandRange(0, 10);
+			Leaderboard.Update(Entry);
+		}
+		CheckAgainstSort(Leaderboard, Expected);
+
+		for (auto Removed = 0; Removed < 100; Removed++)
+		{
+			auto Idx = Random.RandRange(0, Expected.Num() - 1);
+			ASSERT_THAT(IsTrue(Leaderboard.Remove(Expected[Idx].BowlerId)));
+			Expected.RemoveAtSwap(Idx);
+		}
+		CheckAgainstSort(Leaderboard, Expected);
+	}
+
+	TEST_METHOD(Leaderboard_Range)
+	{
+		FBowlingLeaderboard Leaderboard;
+		for (auto BowlerId = 1; BowlerId <= 100; BowlerId++)
+		{
+			FBowlingLeaderboardEntry Entry;
+			Entry.BowlerId = BowlerId;
+			Entry.SeriesTotal = 1000 - BowlerId;
+			Leaderboard.Update(Entry);
+		}
+
+		// Positions 50-60
+		TArray<FBowlingLeaderboardEntry> Entries;
+		Leaderboard.GetRange(50, 11, Entries);
+		ASSERT_THAT(AreEqual(11, Entries.Num()));
+		ASSERT_THAT(AreEqual(50, Entries[0].BowlerId));
+		ASSERT_THAT(AreEqual(60, Entries[10].BowlerId));
+
+		// Ranges running off the end are clipped
+		Leaderboard.GetRange(95, 10, Entries);
+		ASSERT_THAT(AreEqual(6, Entries.Num()));
+		Leaderboard.GetRange(101, 10, Entries);
+		ASSERT_THAT(AreEqual(0, Entries.Num()));
+	}
+
+	TEST_METHOD(Leaderboard_FedByScoreComponent)
+	{
+		FActorTestSpawner Spawner;
+		auto* Leader = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		auto* Trailer = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		auto* Leaderboard = NewObject<UBowlingLeaderboard>();
+		Leaderboard->AddBowler(Leader, 1);
+		Leaderboard->AddBowler(Trailer, 2);
+
+		ASSERT_THAT(AreEqual(300, Leaderboard->GetStandings().Find(1)->MaxPossibleScore));
+
+		Trailer->SetScore(5);
+		ASSERT_THAT(AreEqual(1, Leaderboard->GetRank(2)));
+		ASSERT_THAT(AreEqual(5, Leaderboard->GetStandings().Find(2)->CurrentScore));
+		ASSERT_THAT(AreEqual(290, Leaderboard->GetStandings().Find(2)->MaxPossibleScore));
+
+		// Perfect game for the leader
+		for (auto i = 0; i < 12; i++)
+		{
+			Leader->SetScore(10);
+		}
+		ASSERT_THAT(AreEqual(1, Leaderboard->GetRank(1)));
+		ASSERT_THAT(AreEqual(300, Leaderboard->GetStandings().Find(1)->SeriesTotal));
+		ASSERT_THAT(AreEqual(0, Leaderboard->GetStandings().Find(1)->CurrentScore));
+
+		// Series total carries over into the next game
+		Leader->Reset();
+		Leader->SetScore(3);
+		ASSERT_THAT(AreEqual(303, Leaderboard->GetStandings().Find(1)->GetTotal()));
+		ASSERT_THAT(AreEqual(1, Leaderboard->GetRank(1)));
+	}
+};
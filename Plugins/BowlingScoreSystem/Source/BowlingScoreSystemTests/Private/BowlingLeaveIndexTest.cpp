@@ -0,0 +1,105 @@
+﻿#include "BowlingLeaveIndex.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "UObject/StrongObjectPtr.h"
+
+TEST_CLASS(BowlingLeaveIndexTests, "Bowling.Leaves")
+{
+	FActorTestSpawner Spawner;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+	}
+
+	// Pins as a leave, e.g. Pins({7, 10})
+	static uint16 Pins(std::initializer_list<int32> PinNums)
+	{
+		uint16 Mask = 0;
+		for (const auto Pin : PinNums)
+		{
+			Mask |= static_cast<uint16>(1 << (Pin - 1));
+		}
+		return Mask;
+	}
+
+	TEST_METHOD(Leaves_Sets)
+	{
+		ASSERT_THAT(IsTrue(FBowlingLeaveSet::IsSplit(Pins({7, 10}))));
+		ASSERT_THAT(IsTrue(FBowlingLeaveSet::IsSplit(Pins({4, 6}))));
+		ASSERT_THAT(IsTrue(FBowlingLeaveSet::IsSplit(Pins({3, 10}))));
+		ASSERT_THAT(IsFalse(FBowlingLeaveSet::IsSplit(Pins({4, 5}))));
+		ASSERT_THAT(IsFalse(FBowlingLeaveSet::IsSplit(Pins({10}))));
+
+		// The head pin is still standing
+		ASSERT_THAT(IsFalse(FBowlingLeaveSet::IsSplit(Pins({1, 2, 10}))));
+
+		ASSERT_THAT(AreEqual(226, FBowlingLeaveSet::Splits().Num()));
+		ASSERT_THAT(IsTrue(FBowlingLeaveSet::Splits().Contains(Pins({6, 7, 10}))));
+
+		const auto TenPin = FBowlingLeaveSet::Containing(Pins({10}));
+		ASSERT_THAT(AreEqual(512, TenPin.Num()));
+		ASSERT_THAT(AreEqual(1, FBowlingLeaveSet::Containing(FBowlingFrameScore::FullPinMask).Num()));
+
+		// Splits with the 10 pin, every one of them has it
+		const auto TenPinSplits = FBowlingLeaveSet::Splits() & TenPin;
+		auto NumVisited = 0;
+		TenPinSplits.ForEach([&](uint16 Leave)
+		{
+			NumVisited += (Leave & Pins({10})) != 0 and FBowlingLeaveSet::IsSplit(Leave) ? 1 : 0;
+		});
+		ASSERT_THAT(AreEqual(TenPinSplits.Num(), NumVisited));
+	}
+
+	TEST_METHOD(Leaves_Index)
+	{
+		FBowlingLeaveIndex Index;
+		Index.Record(1, TEXT("Monday"), Pins({7, 10}), false);
+		Index.Record(1, TEXT("Monday"), Pins({7, 10}), true);
+		Index.Record(1, TEXT("Monday"), Pins({10}), true);
+		Index.Record(2, TEXT("Monday"), Pins({7, 10}), false);
+		Index.Record(3, TEXT("Tuesday"), Pins({4, 5}), true);
+
+		const auto SevenTen = Index.GetBowlerStats(1, FBowlingLeaveSet::Only(Pins({7, 10})));
+		ASSERT_THAT(AreEqual(2, SevenTen.Attempts));
+		ASSERT_THAT(AreEqual(1, SevenTen.Conversions));
+		ASSERT_THAT(AreEqual(0.5f, SevenTen.GetConversionRate()));
+
+		const auto TenPin = FBowlingLeaveSet::Containing(Pins({10}));
+		ASSERT_THAT(AreEqual(3, Index.GetBowlerStats(1, TenPin).Attempts));
+		ASSERT_THAT(AreEqual(4, Index.GetLeagueStats(TEXT("Monday"), TenPin).Attempts));
+		ASSERT_THAT(AreEqual(3, Index.GetLeagueStats(TEXT("Monday"), FBowlingLeaveSet::Splits()).Attempts));
+		ASSERT_THAT(AreEqual(2, Index.GetTotalStats(FBowlingLeaveSet::Splits() | FBowlingLeaveSet::Only(Pins({4, 5}))).Conversions));
+		ASSERT_THAT(AreEqual(0, Index.GetBowlerStats(4, TenPin).Attempts));
+
+		ASSERT_THAT(AreEqual(2, Index.GetBowlerLeaves(1).Num()));
+		ASSERT_THAT(IsTrue(Index.GetLeagueLeaves(TEXT("Tuesday")).Contains(Pins({4, 5}))));
+	}
+
+	// Counted as the component records shots with their pins
+	TEST_METHOD(Leaves_FromComponent)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		TStrongObjectPtr<UBowlingLeaveIndex> Leaves(NewObject<UBowlingLeaveIndex>());
+		Leaves->AddBowler(Bowling, 5, TEXT("Monday"));
+
+		// Leave the 7-10, pick up the 10
+		Bowling->SetPinMask(FBowlingFrameScore::FullPinMask & ~Pins({7, 10}));
+		Bowling->SetPinMask(Pins({10}));
+
+		// Leave the 4-5, pick them up by count alone
+		Bowling->SetPinMask(FBowlingFrameScore::FullPinMask & ~Pins({4, 5}));
+		Bowling->SetScore(2);
+
+		// A strike leaves nothing, and a first ball recorded as a count doesn't say what was left
+		Bowling->SetScore(10);
+		Bowling->SetScore(8);
+		Bowling->SetScore(1);
+
+		ASSERT_THAT(AreEqual(1, Leaves->GetSplitStats(5).Attempts));
+		ASSERT_THAT(AreEqual(0, Leaves->GetSplitStats(5).Conversions));
+		ASSERT_THAT(AreEqual(1, Leaves->GetLeaveStats(5, Pins({4, 5})).Conversions));
+		ASSERT_THAT(AreEqual(2, Leaves->GetIndex().GetTotalStats(FBowlingLeaveSet::Containing(0)).Attempts));
+	}
+};
@@ -0,0 +1,149 @@
+﻿#include "BowlingMassSubsystem.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingMassTests, "Bowling.Mass")
+{
+	FActorTestSpawner Spawner;
+	UBowlingMassSubsystem* Mass;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Mass = Spawner.GetWorld().GetSubsystem<UBowlingMassSubsystem>();
+		ASSERT_THAT(IsNotNull(Mass));
+	}
+
+	// Every game is updated together, one shot each per update
+	TEST_METHOD(Mass_ThousandsOfGames)
+	{
+		constexpr auto NumGames = 2000;
+		TArray<FMassEntityHandle> Games;
+		for (auto Game = 0; Game < NumGames; Game++)
+		{
+			Games.Add(Mass->CreateGame());
+		}
+
+		// Even games are perfect, odd games are spares of 5, 5 all the way through
+		for (auto Shot = 0; Shot < 21; Shot++)
+		{
+			for (auto Game = 0; Game < NumGames; Game++)
+			{
+				if (Game % 2 == 0 and Shot >= 12) { continue; }
+				ASSERT_THAT(IsTrue(Mass->SubmitShot(Games[Game], Game % 2 == 0 ? 10 : 5)));
+			}
+			Mass->Process();
+		}
+
+		for (auto Game = 0; Game < NumGames; Game++)
+		{
+			const auto* Totals = Mass->GetFragment<FBowlingTotalsFragment>(Games[Game]);
+			ASSERT_THAT(IsNotNull(Totals));
+			ASSERT_THAT(AreEqual(Game % 2 == 0 ? 300 : 150, Totals->GetScore()));
+			ASSERT_THAT(AreEqual(0, static_cast<int32>(Totals->NumRejected)));
+			ASSERT_THAT(IsTrue(Mass->GetFragment<FBowlingDisplayFragment>(Games[Game])->bGameOver));
+		}
+
+		const auto Stats = Mass->GetStats();
+		ASSERT_THAT(AreEqual(NumGames, Stats.NumGames));
+		ASSERT_THAT(AreEqual(NumGames, Stats.NumGamesOver));
+		ASSERT_THAT(AreEqual(int64{NumGames / 2 * (12 + 21)}, Stats.NumShots));
+		ASSERT_THAT(AreEqual(int64{NumGames / 2 * 12}, Stats.NumStrikes));
+		ASSERT_THAT(AreEqual(int64{NumGames / 2 * 10}, Stats.NumSpares));
+		ASSERT_THAT(AreEqual(int64{NumGames / 2 * (300 + 150)}, Stats.TotalScore));
+		ASSERT_THAT(AreEqual(300, Stats.HighScore));
+	}
+
+	TEST_METHOD(Mass_DisplayState)
+	{
+		const auto Game = Mass->CreateGame();
+		Mass->SubmitShot(Game, 10);
+		Mass->Process();
+
+		const auto* Display = Mass->GetFragment<FBowlingDisplayFragment>(Game);
+		const auto* Totals = Mass->GetFragment<FBowlingTotalsFragment>(Game);
+		const auto* Cursor = Mass->GetFragment<FBowlingCursorFragment>(Game);
+		ASSERT_THAT(AreEqual(2, static_cast<int32>(Display->CurrentFrame)));
+		ASSERT_THAT(AreEqual(1, static_cast<int32>(Display->CurrentShot)));
+		ASSERT_THAT(AreEqual(10, static_cast<int32>(Cursor->PinsStanding)));
+		ASSERT_THAT(AreEqual(300, static_cast<int32>(Totals->MaxPossibleScore)));
+
+		// Only 3 pins are left for the 5
+		Mass->SubmitShot(Game, 7);
+		Mass->SubmitShot(Game, 5);
+		Mass->SubmitShot(Game, 3);
+		Mass->Process();
+		ASSERT_THAT(AreEqual(1, static_cast<int32>(Totals->NumRejected)));
+		ASSERT_THAT(AreEqual(20, static_cast<int32>(Totals->FrameTotals[0])));
+		ASSERT_THAT(AreEqual(30, Totals->GetScore()));
+		ASSERT_THAT(AreEqual(3, static_cast<int32>(Display->CurrentFrame)));
+
+		// The strike's bonus changed frame 1 along with the spare in frame 2, and every frame after them
+		ASSERT_THAT(AreEqual(0b1111111111, static_cast<int32>(Display->ChangedFrames)));
+
+		// Nothing to redraw when nothing was bowled
+		Mass->Process();
+		ASSERT_THAT(AreEqual(0, static_cast<int32>(Display->ChangedFrames)));
+
+		Mass->ResetGame(Game);
+		Mass->Process();
+		ASSERT_THAT(AreEqual(0, Totals->GetScore()));
+		ASSERT_THAT(AreEqual(1, static_cast<int32>(Display->CurrentFrame)));
+		ASSERT_THAT(AreEqual(300, static_cast<int32>(Totals->MaxPossibleScore)));
+	}
+
+	// Games played through a component show up in Mass
+	TEST_METHOD(Mass_BoundComponent)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Bowling->SetScore(10);
+		Mass->BindComponent(Bowling);
+
+		for (auto Pins : {9, 1, 4, 5})
+		{
+			Bowling->SetScore(Pins);
+		}
+		Mass->Process();
+
+		const auto Game = Mass->FindGame(Bowling);
+		const auto* Totals = Mass->GetFragment<FBowlingTotalsFragment>(Game);
+		ASSERT_THAT(IsNotNull(Totals));
+		ASSERT_THAT(AreEqual(Bowling->GetScore(10), Totals->GetScore()));
+		ASSERT_THAT(AreEqual(Bowling->GetMaxPossibleScore(), static_cast<int32>(Totals->MaxPossibleScore)));
+		ASSERT_THAT(AreEqual(Bowling->GetCurrentFrameNum(),
+			static_cast<int32>(Mass->GetFragment<FBowlingDisplayFragment>(Game)->CurrentFrame)));
+
+		Bowling->Reset();
+		Mass->Process();
+		ASSERT_THAT(AreEqual(0, Totals->GetScore()));
+
+		Mass->UnbindComponent(Bowling);
+		ASSERT_THAT(IsFalse(Mass->FindGame(Bowling).IsValid()));
+	}
+
+	// A destroyed component takes its game with it
+	TEST_METHOD(Mass_DestroyedComponent)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Mass->BindComponent(Bowling);
+		const auto Game = Mass->FindGame(Bowling);
+		ASSERT_THAT(IsTrue(Game.IsValid()));
+
+		Bowling->OnComponentDestroyed(false);
+		ASSERT_THAT(IsFalse(Mass->FindGame(Bowling).IsValid()));
+		ASSERT_THAT(IsNull(Mass->GetFragment<FBowlingTotalsFragment>(Game)));
+	}
+
+	// Variants are found by name, so a rule set doesn't have to be the shared instance
+	TEST_METHOD(Mass_FindVariant)
+	{
+		constexpr auto NinePin = FBowlingRuleSet::Make<FNinePinRules>();
+		auto Variant = EBowlingVariant::TenPin;
+		ASSERT_THAT(IsTrue(FBowlingRulesFragment::FindVariant(NinePin, Variant)));
+		ASSERT_THAT(IsTrue(Variant == EBowlingVariant::NinePin));
+
+		ASSERT_THAT(IsTrue(FBowlingRulesFragment::FindVariant(FBowlingRuleSet::Get<FCandlepinRules>(), Variant)));
+		ASSERT_THAT(IsTrue(Variant == EBowlingVariant::Candlepin));
+	}
+};
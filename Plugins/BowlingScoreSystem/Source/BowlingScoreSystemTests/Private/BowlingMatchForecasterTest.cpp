@@ -0,0 +1,96 @@
+﻿#include "BowlingMatchForecaster.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "UObject/StrongObjectPtr.h"
+
+TEST_CLASS(BowlingMatchForecasterTests, "Bowling.Forecast")
+{
+	FActorTestSpawner Spawner;
+	UBowlingScoreComponent* Leader;
+	UBowlingScoreComponent* Trailer;
+	TStrongObjectPtr<UBowlingMatchForecaster> ForecasterRef;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Leader = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Trailer = &Spawner.SpawnObject<UBowlingScoreComponent>();
+	}
+
+	TEST_METHOD(Forecast_FinishedGames)
+	{
+		// Perfect game against a gutter game
+		while (Leader->SetScore(10)) {}
+		while (Trailer->SetScore(0)) {}
+
+		FRandomStream RandomStream(1234);
+		FBowlingForecast Forecast;
+		UBowlingMatchForecaster::Simulate({FBowlingGameSnapshot::Capture(*Leader), FBowlingGameSnapshot::Capture(*Trailer)},
+		                                  100, 0.85f, RandomStream, Forecast);
+
+		ASSERT_THAT(AreEqual(100, Forecast.NumSimulations));
+		ASSERT_THAT(AreEqual(1.f, Forecast.WinProbabilities[0]));
+		ASSERT_THAT(AreEqual(0.f, Forecast.WinProbabilities[1]));
+		ASSERT_THAT(AreEqual(300.f, Forecast.ExpectedScores[0]));
+		ASSERT_THAT(AreEqual(0.f, Forecast.ExpectedScores[1]));
+	}
+
+	TEST_METHOD(Forecast_EvenMatch)
+	{
+		FRandomStream RandomStream(1234);
+		FBowlingForecast Forecast;
+		const TArray<FBowlingGameSnapshot> Games = {
+			FBowlingGameSnapshot::Capture(*Leader), FBowlingGameSnapshot::Capture(*Trailer)
+		};
+
+		// Simulating in chunks folds each chunk into the running averages
+		for (auto Chunk = 0; Chunk < 10; Chunk++)
+		{
+			UBowlingMatchForecaster::Simulate(Games, 400, 0.85f, RandomStream, Forecast);
+		}
+
+		ASSERT_THAT(AreEqual(4000, Forecast.NumSimulations));
+		ASSERT_THAT(IsNear(1.f, Forecast.WinProbabilities[0] + Forecast.WinProbabilities[1], 0.001f));
+		ASSERT_THAT(IsNear(0.5f, Forecast.WinProbabilities[0], 0.05f));
+		ASSERT_THAT(IsNear(Forecast.ExpectedScores[0], Forecast.ExpectedScores[1], 5.f));
+	}
+
+	// Shots restart the forecast and the new odds arrive on the game thread
+	TEST_METHOD(Forecast_StreamsAfterShot)
+	{
+		// Kept alive across the latent commands
+		auto* Forecaster = NewObject<UBowlingMatchForecaster>();
+		ForecasterRef.Reset(Forecaster);
+		Forecaster->NumSimulations = 2000;
+		Forecaster->SimulationsPerChunk = 250;
+		auto MatchId = Forecaster->AddMatch({Leader, Trailer});
+
+		// Leader is 3 strikes up going into the last frame
+		TestCommandBuilder
+			.Do([this, Forecaster]
+			{
+				for (auto Frame = 1; Frame <= 9; Frame++)
+				{
+					Leader->SetScore(Frame <= 3 ? 10 : 4);
+					if (Frame > 3) { Leader->SetScore(4); }
+					Trailer->SetScore(4);
+					Trailer->SetScore(4);
+				}
+			})
+			.Until([Forecaster, MatchId]
+			{
+				FBowlingForecast Forecast;
+				return Forecaster->GetForecast(MatchId, Forecast) and Forecast.NumSimulations == 2000;
+			})
+			.Then([this, Forecaster, MatchId]
+			{
+				FBowlingForecast Forecast;
+				ASSERT_THAT(IsTrue(Forecaster->GetForecast(MatchId, Forecast)));
+				ASSERT_THAT(IsTrue(Forecast.WinProbabilities[0] > 0.9f));
+				ASSERT_THAT(IsTrue(Forecast.ExpectedScores[0] > Forecast.ExpectedScores[1]));
+				Forecaster->RemoveMatch(MatchId);
+				ASSERT_THAT(IsFalse(Forecaster->GetForecast(MatchId, Forecast)));
+			});
+	}
+};
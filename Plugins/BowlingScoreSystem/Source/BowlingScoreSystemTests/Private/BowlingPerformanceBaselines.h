@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformMisc.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+/*
+ * The checked-in numbers in Baselines/Performance.json that performance tests are gated on, one object per test.
+ * Numbers are only ever taken on the machine in RatioMachine: run the tests there with -BowlingRecordBaselines and
+ * each one writes what it measured back to the file, along with the machine it ran on, instead of checking it.
+ */
+struct FBowlingPerformanceBaselines
+{
+	static FString GetPath()
+	{
+		const auto Plugin = IPluginManager::Get().FindPlugin(TEXT("BowlingScoreSystem"));
+		if (not Plugin) { return FString(); }
+		return Plugin->GetBaseDir() / TEXT("Source/BowlingScoreSystemTests/Baselines/Performance.json");
+	}
+
+	// Measuring to record rather than to check
+	static bool IsRecording()
+	{
+		return FParse::Param(FCommandLine::Get(), TEXT("BowlingRecordBaselines"));
+	}
+
+	// CPU and build configuration, what the numbers depend on
+	static FString GetThisMachine()
+	{
+		return FString::Printf(TEXT("%s, %s %s"), *FPlatformMisc::GetCPUBrand().TrimStartAndEnd(),
+			FPlatformProperties::IniPlatformName(), LexToString(FApp::GetBuildConfiguration()));
+	}
+
+	// Every baseline, null if the file is missing or isn't valid JSON
+	static TSharedPtr<FJsonObject> LoadAll()
+	{
+		FString Json;
+		if (not FFileHelper::LoadFileToString(Json, *GetPath())) { return nullptr; }
+
+		TSharedPtr<FJsonObject> Baselines;
+		if (not FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Baselines)) { return nullptr; }
+		return Baselines;
+	}
+
+	// One test's baselines, null if it has none
+	static TSharedPtr<FJsonObject> Load(const FString& Name)
+	{
+		const auto Baselines = LoadAll();
+		if (not Baselines or not Baselines->HasTypedField<EJson::Object>(Name)) { return nullptr; }
+		return Baselines->GetObjectField(Name);
+	}
+
+	// Machine the baselines were recorded on, empty if they haven't been
+	static FString GetRatioMachine()
+	{
+		const auto Baselines = LoadAll();
+		FString Machine;
+		if (Baselines) { Baselines->TryGetStringField(TEXT("RatioMachine"), Machine); }
+		return Machine;
+	}
+
+	// Write numbers measured for a test into its baseline, and this machine as the one they were recorded on
+	static bool Record(const FString& Name, const TMap<FString, double>& Values)
+	{
+		const auto Baselines = LoadAll();
+		if (not Baselines) { return false; }
+
+		auto Baseline = Baselines->HasTypedField<EJson::Object>(Name)
+			? Baselines->GetObjectField(Name)
+			: MakeShared<FJsonObject>();
+		for (const auto& [Field, Value] : Values)
+		{
+			Baseline->SetNumberField(Field, Value);
+		}
+		Baselines->SetObjectField(Name, Baseline);
+		Baselines->SetStringField(TEXT("RatioMachine"), GetThisMachine());
+
+		FString Json;
+		const auto Writer = TJsonWriterFactory<>::Create(&Json);
+		if (not FJsonSerializer::Serialize(Baselines.ToSharedRef(), Writer)) { return false; }
+		return FFileHelper::SaveStringToFile(Json + TEXT("\n"), *GetPath(), FFileHelper::EEncodingOptions::ForceUTF8);
+	}
+};
@@ -0,0 +1,288 @@
+﻿#include "Algo/Sort.h"
+#include "BowlingCountingMalloc.h"
+#include "BowlingLeaderboard.h"
+#include "BowlingPerformanceBaselines.h"
+#include "BowlingPinfallModel.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreExporter.h"
+#include "BowlingTeamMatch.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "UObject/StrongObjectPtr.h"
+
+/*
+ * Fixed, seeded workloads checked against the baselines in Baselines/Performance.json. Each workload is run once to
+ * warm up, then three more times counting game thread allocations, and the fastest run is compared.
+ *
+ * Allocations are a hard gate. Time is gated as a ratio to a reference workload timed alongside it in the same
+ * process, so a baseline holds on any machine rather than only the one it was taken on. A workload without a recorded
+ * ratio fails. Run with -BowlingRecordBaselines on the machine in RatioMachine, a Development build under -nullrhi, to
+ * record what every workload measures instead of checking it.
+ */
+TEST_CLASS(BowlingPerformanceTests, "Bowling.Performance")
+{
+	FActorTestSpawner Spawner;
+
+	// Sorting and hashing plain integers, nothing of the plugin's, so its time only changes with the machine and build
+	struct FReferenceWorkload
+	{
+		TArray<uint32> Source;
+		TArray<uint32> Values;
+
+		FReferenceWorkload()
+		{
+			FRandomStream Random(1617);
+			Source.SetNumUninitialized(1 << 16);
+			for (auto& Value : Source)
+			{
+				Value = Random.GetUnsignedInt();
+			}
+			Values.SetNumUninitialized(Source.Num());
+		}
+
+		uint32 Run()
+		{
+			FMemory::Memcpy(Values.GetData(), Source.GetData(), Source.Num() * Source.GetTypeSize());
+			Algo::Sort(Values);
+
+			uint32 Hash = 0;
+			for (auto Value : Values)
+			{
+				Hash = HashCombineFast(Hash, Value);
+			}
+			return Hash;
+		}
+	};
+
+	void Measure(const FString& Name, TFunctionRef<void()> Workload)
+	{
+		const auto Baseline = FBowlingPerformanceBaselines::Load(Name);
+		ASSERT_THAT(IsTrue(Baseline.IsValid(), FString::Printf(TEXT("No baseline for %s in %s"), *Name,
+			*FBowlingPerformanceBaselines::GetPath())));
+
+		// Caches and buffers grow to fit the first time through
+		FReferenceWorkload Reference;
+		Reference.Run();
+		Workload();
+
+		// Taking turns, so anything else slowing the machine down slows both
+		auto ReferenceMilliseconds = MAX_dbl;
+		auto Milliseconds = MAX_dbl;
+		auto Allocations = 0;
+		for (auto Run = 0; Run < 3; Run++)
+		{
+			auto Start = FPlatformTime::Seconds();
+			Reference.Run();
+			ReferenceMilliseconds = FMath::Min(ReferenceMilliseconds, (FPlatformTime::Seconds() - Start) * 1000.0);
+
+			const FBowlingCountingMalloc::FScope CountingScope;
+			Start = FPlatformTime::Seconds();
+			Workload();
+			const auto Elapsed = FPlatformTime::Seconds() - Start;
+
+			Milliseconds = FMath::Min(Milliseconds, Elapsed * 1000.0);
+			Allocations = FMath::Max(Allocations, CountingScope.GetNumAllocations());
+		}
+		const auto Ratio = Milliseconds / ReferenceMilliseconds;
+
+		TestRunner.AddInfo(FString::Printf(TEXT("%s: %.2f ms, %.2fx the reference's %.2f ms, %d allocations"), *Name,
+			Milliseconds, Ratio, ReferenceMilliseconds, Allocations));
+
+		double BaselineAllocations = 0.0;
+		double AllocationTolerance = 0.0;
+		Baseline->TryGetNumberField(TEXT("AllocationTolerance"), AllocationTolerance);
+		ASSERT_THAT(IsTrue(Baseline->TryGetNumberField(TEXT("Allocations"), BaselineAllocations),
+			FString::Printf(TEXT("%s has no \"Allocations\" baseline"), *Name)));
+		ASSERT_THAT(IsTrue(Allocations <= BaselineAllocations + AllocationTolerance,
+			FString::Printf(TEXT("%s allocated %d times, baseline is %.0f"), *Name, Allocations, BaselineAllocations)));
+
+		// Allocations are the same on every machine, only the time depends on the one it's taken on
+		if (FBowlingPerformanceBaselines::IsRecording())
+		{
+			ASSERT_THAT(IsTrue(FBowlingPerformanceBaselines::Record(Name, {{TEXT("Ratio"), Ratio}}),
+				FString::Printf(TEXT("Could not record the baseline for %s"), *Name)));
+			return;
+		}
+
+		double BaselineRatio = 0.0;
+		double RatioTolerance = 1.0;
+		Baseline->TryGetNumberField(TEXT("RatioTolerance"), RatioTolerance);
+		ASSERT_THAT(IsTrue(Baseline->TryGetNumberField(TEXT("Ratio"), BaselineRatio) and BaselineRatio > 0.0,
+			FString::Printf(TEXT("%s has no \"Ratio\" baseline, record one with -BowlingRecordBaselines"), *Name)));
+		ASSERT_THAT(IsFalse(FBowlingPerformanceBaselines::GetRatioMachine().IsEmpty(),
+			TEXT("Performance.json doesn't say which machine its ratios were recorded on")));
+		ASSERT_THAT(IsTrue(Ratio <= BaselineRatio * RatioTolerance,
+			FString::Printf(TEXT("%s took %.2fx the reference workload, more than %.1fx its baseline of %.2fx"), *Name,
+				Ratio, RatioTolerance, BaselineRatio)));
+	}
+
+	// Knock down a seeded random number of the standing pins on every shot until the game is over
+	static int32 PlayRandomGame(UBowlingScoreComponent& Bowling, FRandomStream& Random)
+	{
+		while (not Bowling.IsGameOver())
+		{
+			Bowling.SetScore(Random.RandRange(0, Bowling.GetPinsStanding()));
+		}
+		return Bowling.GetScore(Bowling.GetNumFrames());
+	}
+
+	TEST_METHOD(Perf_TenThousandGames)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+
+		Measure(TEXT("Perf_TenThousandGames"), [Bowling]
+		{
+			FRandomStream Random(1234);
+			for (auto Game = 0; Game < 10000; Game++)
+			{
+				PlayRandomGame(*Bowling, Random);
+				Bowling->Reset();
+			}
+		});
+	}
+
+	TEST_METHOD(Perf_MillionValidations)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+
+		// Scores to check, some of them out of range
+		FRandomStream Random(5678);
+		int32 Scores[1024];
+		for (auto& Score : Scores)
+		{
+			Score = Random.RandRange(-1, 11);
+		}
+
+		auto NumValid = 0;
+		Measure(TEXT("Perf_MillionValidations"), [Bowling, &Scores, &NumValid]
+		{
+			FRandomStream GameRandom(91011);
+			Bowling->Reset();
+
+			// Checked a hundred at a time against every state a game passes through
+			NumValid = 0;
+			for (auto Validation = 0; Validation < 1000000; Validation++)
+			{
+				NumValid += Bowling->IsValidShotScore(Scores[Validation % UE_ARRAY_COUNT(Scores)]) ? 1 : 0;
+				if (Validation % 100 == 99)
+				{
+					if (Bowling->IsGameOver()) { Bowling->Reset(); }
+					Bowling->SetScore(GameRandom.RandRange(0, Bowling->GetPinsStanding()));
+				}
+			}
+		});
+
+		ASSERT_THAT(IsTrue(NumValid > 0));
+	}
+
+	// Simulated first balls at a full rack, spread over the deliveries a house full of league bowlers throws
+	TEST_METHOD(Perf_HundredThousandSimulatedShots)
+	{
+		const FBowlingPinfallModel Model;
+		auto NumStrikes = 0;
+		Measure(TEXT("Perf_HundredThousandSimulatedShots"), [&Model, &NumStrikes]
+		{
+			FRandomStream Random(1415);
+			FBowlingDelivery Delivery;
+			NumStrikes = 0;
+			for (auto Shot = 0; Shot < 100000; Shot++)
+			{
+				Delivery.Speed = Random.FRandRange(14.0f, 21.0f);
+				Delivery.EntryAngle = Random.FRandRange(2.0f, 8.0f);
+				Delivery.Board = Random.FRandRange(10.0f, 25.0f);
+				Delivery.RevRate = Random.FRandRange(150.0f, 500.0f);
+				const auto PinsDown = Model.Simulate(Delivery, FBowlingFrameScore::FullPinMask, Random);
+				NumStrikes += PinsDown == FBowlingFrameScore::FullPinMask ? 1 : 0;
+			}
+		});
+
+		ASSERT_THAT(IsTrue(NumStrikes > 0));
+	}
+
+	// Sixty lanes bowling series of three, with a leaderboard and a polled scoreboard feed watching
+	TEST_METHOD(Perf_CenterSession)
+	{
+		constexpr auto NumLanes = 60;
+		TArray<UBowlingScoreComponent*> Lanes;
+		TStrongObjectPtr<UBowlingLeaderboard> Leaderboard(NewObject<UBowlingLeaderboard>());
+		TStrongObjectPtr<UBowlingScoreExporter> Exporter(NewObject<UBowlingScoreExporter>());
+		for (auto Lane = 0; Lane < NumLanes; Lane++)
+		{
+			auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+			Lanes.Add(Bowling);
+			Leaderboard->AddBowler(Bowling, Lane + 1);
+			Exporter->AddGame(Lane + 1, Bowling);
+		}
+
+		const auto Consumer = Exporter->AddConsumer();
+		TArray<uint8> Json;
+		Exporter->ExportJson(Consumer, Json);
+
+		Measure(TEXT("Perf_CenterSession"), [&]
+		{
+			FRandomStream Random(1213);
+			for (auto Session = 0; Session < 10; Session++)
+			{
+				for (auto Game = 0; Game < 3; Game++)
+				{
+					// Every lane bowls a shot in turn, and the scoreboard polls after each round
+					auto NumPlaying = NumLanes;
+					while (NumPlaying > 0)
+					{
+						NumPlaying = 0;
+						for (auto* Bowling : Lanes)
+						{
+							if (Bowling->IsGameOver()) { continue; }
+							Bowling->SetScore(Random.RandRange(0, Bowling->GetPinsStanding()));
+							NumPlaying++;
+						}
+						Exporter->ExportJson(Consumer, Json);
+					}
+
+					for (auto* Bowling : Lanes)
+					{
+						Bowling->Reset();
+					}
+				}
+			}
+		});
+
+		ASSERT_THAT(AreEqual(NumLanes, Leaderboard->GetStandings().Num()));
+	}
+
+	// A league night of sixty lanes, six bowlers to a lane each bowling a series of three, with team totals kept live
+	TEST_METHOD(Perf_LeagueNight)
+	{
+		constexpr auto NumLanes = 60;
+		constexpr auto BowlersPerLane = 6;
+		TArray<UBowlingScoreComponent*> Bowlers;
+		TStrongObjectPtr<UBowlingTeamMatch> Match(NewObject<UBowlingTeamMatch>());
+		for (auto Lane = 0; Lane < NumLanes; Lane++)
+		{
+			const auto Team = Match->AddTeam();
+			for (auto Bowler = 0; Bowler < BowlersPerLane; Bowler++)
+			{
+				auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+				Bowlers.Add(Bowling);
+				Match->AddBowler(Team, Bowling, Lane * BowlersPerLane + Bowler, Bowler * 5);
+			}
+		}
+
+		Measure(TEXT("Perf_LeagueNight"), [&]
+		{
+			FRandomStream Random(1617);
+			Match->ResetGames();
+			for (auto Game = 0; Game < 3; Game++)
+			{
+				for (auto* Bowling : Bowlers)
+				{
+					Bowling->Reset();
+					PlayRandomGame(*Bowling, Random);
+				}
+			}
+		});
+
+		ASSERT_THAT(AreEqual(Match->GetTeamTotal(0, false), Match->GetTeamGameTotal(0, 1, false)
+			+ Match->GetTeamGameTotal(0, 2, false) + Match->GetTeamGameTotal(0, 3, false)));
+	}
+};
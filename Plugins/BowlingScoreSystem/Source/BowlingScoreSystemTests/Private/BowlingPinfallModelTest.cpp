@@ -0,0 +1,141 @@
+﻿#include "BowlingPinfallModel.h"
+#include "BowlingScoreComponent.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingPinfallModelTests, "Bowling.Pinfall")
+{
+	FActorTestSpawner Spawner;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+	}
+
+	static FBowlingDelivery Delivery(float Board, float EntryAngle, bool bLeftHanded = false)
+	{
+		FBowlingDelivery Result;
+		Result.Board = Board;
+		Result.EntryAngle = EntryAngle;
+		Result.bLeftHanded = bLeftHanded;
+		return Result;
+	}
+
+	// Strikes out of a number of first balls
+	static int32 CountStrikes(const FBowlingPinfallModel& Model, const FBowlingDelivery& Delivery, int32 NumShots)
+	{
+		FRandomStream Random(42);
+		auto NumStrikes = 0;
+		for (auto Shot = 0; Shot < NumShots; Shot++)
+		{
+			const auto PinsDown = Model.Simulate(Delivery, FBowlingFrameScore::FullPinMask, Random);
+			NumStrikes += PinsDown == FBowlingFrameScore::FullPinMask ? 1 : 0;
+		}
+		return NumStrikes;
+	}
+
+	TEST_METHOD(Pinfall_Deliveries)
+	{
+		const FBowlingPinfallModel Model;
+
+		// A ball in the pocket strikes far more often than a light or high hit, and one down the edge can't strike
+		const auto Pocket = CountStrikes(Model, Delivery(17.5f, 6.0f), 1000);
+		ASSERT_THAT(IsTrue(Pocket > CountStrikes(Model, Delivery(14.0f, 6.0f), 1000)));
+		ASSERT_THAT(IsTrue(Pocket > CountStrikes(Model, Delivery(20.0f, 6.0f), 1000)));
+		ASSERT_THAT(IsTrue(Pocket > 500));
+		ASSERT_THAT(AreEqual(0, CountStrikes(Model, Delivery(2.0f, 0.0f), 1000)));
+
+		// Only standing pins can fall
+		FRandomStream Random(7);
+		for (auto Shot = 0; Shot < 100; Shot++)
+		{
+			const auto PinsDown = Model.Simulate(Delivery(17.5f, 6.0f), 0b1001000000, Random);
+			ASSERT_THAT(AreEqual(0, PinsDown & ~0b1001000000));
+		}
+
+		// A left-handed bowler is a mirror image, their pocket is between the 1 and 2 pins
+		FRandomStream RightRandom(11);
+		FRandomStream LeftRandom(11);
+		const auto Right = Model.Simulate(Delivery(10.0f, 4.0f), FBowlingFrameScore::FullPinMask, RightRandom);
+		const auto Left = Model.Simulate(Delivery(10.0f, 4.0f, true), FBowlingFrameScore::FullPinMask, LeftRandom);
+		constexpr int32 MirrorPins[] = {0, 2, 1, 5, 4, 3, 9, 8, 7, 6};
+		for (auto Pin = 0; Pin < 10; Pin++)
+		{
+			ASSERT_THAT(AreEqual((Right >> Pin) & 1, (Left >> MirrorPins[Pin]) & 1));
+		}
+		ASSERT_THAT(AreEqual(Model.GetFallProbability(Delivery(10.0f, 4.0f), 5, 0),
+			Model.GetFallProbability(Delivery(10.0f, 4.0f, true), 3, 0)));
+
+		// Pins are more likely to go when the pins around them have
+		ASSERT_THAT(IsTrue(Model.GetFallProbability(Delivery(17.5f, 6.0f), 9, 0b0100100000)
+			> Model.GetFallProbability(Delivery(17.5f, 6.0f), 9, 0)));
+	}
+
+	// Simulated shots are recorded with their pins, so leaves and spares score as they would from a pinsetter
+	TEST_METHOD(Pinfall_Bowl)
+	{
+		auto& Bowling = Spawner.SpawnObject<UBowlingScoreComponent>();
+		const FBowlingPinfallModel Model;
+		FRandomStream Random(1234);
+
+		for (auto Game = 0; Game < 20; Game++)
+		{
+			Bowling.Reset();
+			while (not Bowling.IsGameOver())
+			{
+				const auto Frame = Bowling.GetCurrentFrameNum();
+				const auto Shot = Bowling.GetCurrentShotNum();
+				const auto Standing = Bowling.GetPinsStandingMask();
+				ASSERT_THAT(IsTrue(Model.Bowl(Bowling, Delivery(Random.FRandRange(12.0f, 22.0f), 5.0f), Random)));
+
+				const auto PinMask = Bowling.GetPinMask(Frame, Shot);
+				ASSERT_THAT(AreEqual(0, PinMask & ~Standing));
+				ASSERT_THAT(AreEqual(static_cast<int32>(FMath::CountBits(PinMask)), Bowling.GetFrameScores()[Frame - 1].Shots[Shot - 1]));
+			}
+		}
+
+		// Nothing left to bowl at
+		ASSERT_THAT(IsFalse(Model.Bowl(Bowling, Delivery(17.5f, 6.0f), Random)));
+	}
+
+	// Fitting to shots carried by a different model gets closer to them
+	TEST_METHOD(Pinfall_Calibration)
+	{
+		FBowlingPinfallModel Recorded;
+		for (auto& PinWeights : Recorded.Weights)
+		{
+			PinWeights[FBowlingPinfallModel::Contact] = 5.0f;
+			PinWeights[FBowlingPinfallModel::Speed] = 0.8f;
+			PinWeights[FBowlingPinfallModel::Neighbours] = 3.0f;
+		}
+
+		FRandomStream Random(99);
+		TArray<FBowlingRecordedShot> Shots;
+		for (auto Idx = 0; Idx < 2000; Idx++)
+		{
+			auto& Shot = Shots.AddDefaulted_GetRef();
+			Shot.Delivery.Speed = Random.FRandRange(14.0f, 21.0f);
+			Shot.Delivery.EntryAngle = Random.FRandRange(2.0f, 8.0f);
+			Shot.Delivery.Board = Random.FRandRange(10.0f, 25.0f);
+			Shot.Delivery.RevRate = Random.FRandRange(150.0f, 500.0f);
+			Shot.Delivery.bLeftHanded = Random.RandRange(0, 4) == 0;
+			Shot.Standing = FBowlingFrameScore::FullPinMask;
+			Shot.PinsDown = Recorded.Simulate(Shot.Delivery, Shot.Standing, Random);
+		}
+
+		FBowlingPinfallModel Model;
+		const auto InitialLoss = Model.GetLogLoss(Shots);
+		const auto FittedLoss = Model.Fit(Shots, 200);
+		ASSERT_THAT(IsTrue(FittedLoss < InitialLoss));
+		ASSERT_THAT(IsTrue(FittedLoss < Recorded.GetLogLoss(Shots) + 0.05));
+
+		// Faster balls carry more in the recording
+		ASSERT_THAT(IsTrue(Model.Weights[0][FBowlingPinfallModel::Speed] > 0.0f));
+
+		// Weights survive being saved
+		FBowlingPinfallModel Loaded;
+		ASSERT_THAT(IsTrue(Loaded.LoadFromString(Model.SaveToString())));
+		ASSERT_THAT(IsNear(Model.GetLogLoss(Shots), Loaded.GetLogLoss(Shots), 1e-4));
+		ASSERT_THAT(IsFalse(Loaded.LoadFromString(TEXT("1 0 0 0"))));
+	}
+};
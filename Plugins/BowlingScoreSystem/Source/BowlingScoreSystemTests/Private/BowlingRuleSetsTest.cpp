@@ -0,0 +1,203 @@
+﻿#include "BowlingRuleSets.h"
+#include "BowlingVariantScoreComponents.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingRuleSetsTests, "Bowling.RuleSets")
+{
+	FActorTestSpawner Spawner;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+	}
+
+	// Bowl every remaining shot with the same pinfall, returning the number of shots it took to finish the game
+	int32 BowlOut(UBowlingScoreComponent* Bowling, int32 Score)
+	{
+		auto NumShots = 0;
+		while (not Bowling->IsGameOver() and Bowling->SetScore(Score))
+		{
+			NumShots++;
+		}
+		return NumShots;
+	}
+
+	TEST_METHOD(RuleSets_Layout)
+	{
+		static_assert(TBowlingScorer<FTenPinRules>::GetNumShots(0) == 2);
+		static_assert(TBowlingScorer<FTenPinRules>::GetNumShots(9) == 3);
+		static_assert(TBowlingScorer<FFivePinRules>::GetNumShots(0) == 3);
+		static_assert(TBowlingScorer<FCandlepinRules>::GetNumShots(9) == 3);
+
+		auto* Candlepin = &Spawner.SpawnObject<UCandlepinScoreComponent>();
+		ASSERT_THAT(AreEqual(10, Candlepin->GetNumFrames()));
+		ASSERT_THAT(AreEqual(3, Candlepin->GetNumShots(1)));
+		ASSERT_THAT(AreEqual(0, Candlepin->GetNumShots(11)));
+	}
+
+	TEST_METHOD(RuleSets_PerfectGames)
+	{
+		auto* NinePin = &Spawner.SpawnObject<UNinePinScoreComponent>();
+		auto* FivePin = &Spawner.SpawnObject<UFivePinScoreComponent>();
+		auto* Candlepin = &Spawner.SpawnObject<UCandlepinScoreComponent>();
+
+		ASSERT_THAT(AreEqual(300, NinePin->GetMaxPossibleScore()));
+		ASSERT_THAT(AreEqual(450, FivePin->GetMaxPossibleScore()));
+		ASSERT_THAT(AreEqual(300, Candlepin->GetMaxPossibleScore()));
+
+		for (auto* Bowling : {NinePin, FivePin, Candlepin})
+		{
+			ASSERT_THAT(AreEqual(12, BowlOut(Bowling, Bowling->GetNumPins())));
+			ASSERT_THAT(AreEqual(Bowling->GetNumPins() * 30, Bowling->GetScore(10)));
+		}
+
+		// Nine with every ball is still a perfect game at no-tap
+		auto* NoTap = &Spawner.SpawnObject<UNinePinScoreComponent>();
+		ASSERT_THAT(AreEqual(12, BowlOut(NoTap, 9)));
+		ASSERT_THAT(AreEqual(300, NoTap->GetScore(10)));
+	}
+
+	// Nine down with the first ball at a rack is a strike, anywhere else it's nine
+	TEST_METHOD(RuleSets_NinePinNoTap)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UNinePinScoreComponent>();
+		ASSERT_THAT(AreEqual(10, Bowling->GetNumPins()));
+		ASSERT_THAT(IsTrue(Bowling->IsValidShotScore(10)));
+
+		ASSERT_THAT(IsTrue(Bowling->SetScore(9)));
+		ASSERT_THAT(IsTrue(Bowling->IsStrike(1, 1)));
+		ASSERT_THAT(AreEqual(2, Bowling->GetCurrentFrameNum()));
+
+		// Eight isn't enough
+		ASSERT_THAT(IsTrue(Bowling->SetScore(8)));
+		ASSERT_THAT(IsFalse(Bowling->IsStrike(2, 1)));
+		ASSERT_THAT(AreEqual(2, Bowling->GetPinsStanding()));
+		ASSERT_THAT(IsTrue(Bowling->SetScore(2)));
+		ASSERT_THAT(IsTrue(Bowling->IsSpare(2, 2)));
+
+		ASSERT_THAT(IsTrue(Bowling->SetScore(9)));
+		ASSERT_THAT(IsTrue(Bowling->IsStrike(3, 1)));
+
+		// Nine with the second ball is short of a spare
+		ASSERT_THAT(IsTrue(Bowling->SetScore(0)));
+		ASSERT_THAT(IsTrue(Bowling->SetScore(9)));
+		ASSERT_THAT(IsFalse(Bowling->IsSpare(4, 2)));
+		ASSERT_THAT(AreEqual(5, Bowling->GetCurrentFrameNum()));
+
+		ASSERT_THAT(AreEqual(20, Bowling->GetFrameScore(1)));
+		ASSERT_THAT(AreEqual(20, Bowling->GetFrameScore(2)));
+		ASSERT_THAT(AreEqual(19, Bowling->GetFrameScore(3)));
+		ASSERT_THAT(AreEqual(9, Bowling->GetFrameScore(4)));
+
+		// The final frame's pins are set again after a no-tap strike
+		for (auto Frame = 5; Frame < 10; Frame++)
+		{
+			Bowling->SetScore(0);
+			Bowling->SetScore(0);
+		}
+		ASSERT_THAT(IsTrue(Bowling->SetScore(9)));
+		ASSERT_THAT(AreEqual(10, Bowling->GetPinsStanding()));
+		ASSERT_THAT(IsTrue(Bowling->SetScore(9)));
+		ASSERT_THAT(IsTrue(Bowling->IsStrike(10, 2)));
+		ASSERT_THAT(IsTrue(Bowling->SetScore(3)));
+		ASSERT_THAT(IsTrue(Bowling->IsGameOver()));
+		ASSERT_THAT(AreEqual(68 + 23, Bowling->GetScore(10)));
+	}
+
+	// Three balls a frame, with a bonus only for clearing the pins with the first or second ball
+	TEST_METHOD(RuleSets_CandlepinFrames)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UCandlepinScoreComponent>();
+
+		// Open frame
+		Bowling->SetScore(3);
+		Bowling->SetScore(4);
+		ASSERT_THAT(AreEqual(3, Bowling->GetCurrentShotNum()));
+		ASSERT_THAT(AreEqual(3, Bowling->GetPinsStanding()));
+		Bowling->SetScore(2);
+		ASSERT_THAT(AreEqual(9, Bowling->GetFrameScore(1)));
+
+		// Clearing the pins with the third ball is worth ten with no bonus
+		Bowling->SetScore(3);
+		Bowling->SetScore(4);
+		Bowling->SetScore(3);
+		ASSERT_THAT(IsFalse(Bowling->IsSpare(2, 3)));
+		ASSERT_THAT(IsFalse(Bowling->IsStrike(2, 3)));
+
+		// Spare ends the frame early
+		Bowling->SetScore(6);
+		ASSERT_THAT(AreEqual(2, Bowling->GetRackBallNum()));
+		Bowling->SetScore(4);
+		ASSERT_THAT(IsTrue(Bowling->IsSpare(3, 2)));
+		ASSERT_THAT(AreEqual(4, Bowling->GetCurrentFrameNum()));
+
+		Bowling->SetScore(5);
+		Bowling->SetScore(4);
+		Bowling->SetScore(0);
+		ASSERT_THAT(AreEqual(10, Bowling->GetFrameScore(2)));
+		ASSERT_THAT(AreEqual(15, Bowling->GetFrameScore(3)));
+		ASSERT_THAT(AreEqual(9, Bowling->GetFrameScore(4)));
+
+		// The final frame always gets all three balls
+		ASSERT_THAT(AreEqual(18, BowlOut(Bowling, 1)));
+		ASSERT_THAT(AreEqual(43 + 18, Bowling->GetScore(10)));
+	}
+
+	TEST_METHOD(RuleSets_FivePinStrikeBonus)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UFivePinScoreComponent>();
+		Bowling->SetScore(15);
+		ASSERT_THAT(AreEqual(2, Bowling->GetCurrentFrameNum()));
+		Bowling->SetScore(5);
+		Bowling->SetScore(10);
+		ASSERT_THAT(IsTrue(Bowling->IsSpare(2, 2)));
+		Bowling->SetScore(15);
+		ASSERT_THAT(AreEqual(30, Bowling->GetFrameScore(1)));
+		ASSERT_THAT(AreEqual(30, Bowling->GetFrameScore(2)));
+	}
+
+	// Only totals some of the 2-3-5-3-2 pins add up to can be knocked down
+	TEST_METHOD(RuleSets_FivePinValidation)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UFivePinScoreComponent>();
+		ASSERT_THAT(IsFalse(Bowling->IsValidShotScore(1)));
+		ASSERT_THAT(IsFalse(Bowling->IsValidShotScore(14)));
+		ASSERT_THAT(IsTrue(Bowling->IsValidShotScore(13)));
+
+		// Ten down leaves a 2 and a 3, or the 5 on its own
+		ASSERT_THAT(IsTrue(Bowling->SetScore(10)));
+		ASSERT_THAT(IsFalse(Bowling->IsValidShotScore(1)));
+		ASSERT_THAT(IsFalse(Bowling->IsValidShotScore(4)));
+		ASSERT_THAT(IsTrue(Bowling->IsValidShotScore(2)));
+		ASSERT_THAT(IsTrue(Bowling->IsValidShotScore(3)));
+		ASSERT_THAT(IsTrue(Bowling->SetScore(5)));
+		ASSERT_THAT(IsTrue(Bowling->IsSpare(1, 2)));
+	}
+
+	// Every module shares one rule set per variant
+	TEST_METHOD(RuleSets_SharedInstances)
+	{
+		auto* Candlepin = &Spawner.SpawnObject<UCandlepinScoreComponent>();
+		auto* NinePin = &Spawner.SpawnObject<UNinePinScoreComponent>();
+		ASSERT_THAT(IsTrue(&Candlepin->GetRuleSet() == &FBowlingRuleSet::Get<FCandlepinRules>()));
+		ASSERT_THAT(IsTrue(&NinePin->GetRuleSet() == &FBowlingRuleSet::Get<FNinePinRules>()));
+		ASSERT_THAT(AreEqual(FString(TEXT("Candlepin")), FString(Candlepin->GetRuleSet().Name)));
+		ASSERT_THAT(AreEqual(FString(TEXT("NinePin")), FString(NinePin->GetRuleSet().Name)));
+	}
+
+	// Pin masks need every pin to be worth one
+	TEST_METHOD(RuleSets_PinMasks)
+	{
+		auto* NinePin = &Spawner.SpawnObject<UNinePinScoreComponent>();
+		auto* FivePin = &Spawner.SpawnObject<UFivePinScoreComponent>();
+
+		// Leaving the head pin standing is still a no-tap strike, and the next frame gets a full rack
+		ASSERT_THAT(IsTrue(NinePin->SetPinMask(0b1111111110)));
+		ASSERT_THAT(IsTrue(NinePin->IsStrike(1, 1)));
+		ASSERT_THAT(AreEqual(0b1111111111, NinePin->GetPinsStandingMask()));
+
+		ASSERT_THAT(IsFalse(FivePin->IsValidPinMask(0b0000000001)));
+		ASSERT_THAT(AreEqual(0, FivePin->GetPinsStandingMask()));
+	}
+};
@@ -645,4 +645,147 @@ TEST_CLASS(BowlingScoreTests, "Bowling.Score")
 		auto TotalScore = Bowling->GetScore(10);
 		ASSERT_THAT(AreEqual(149, TotalScore));
 	}
+
+	// Scrubbing through the history matches replaying the game up to each shot
+	TEST_METHOD(BowlingScore_History)
+	{
+		TArray<int32> Shots = {8, 2, 5, 4, 9, 0, 10, 10, 5, 5, 5, 3, 6, 3, 9, 1, 9, 1, 10};
+		for (auto&& Shot : Shots)
+		{
+			ASSERT_THAT(IsTrue(Bowling->SetScore(Shot)));
+		}
+		ASSERT_THAT(AreEqual(Shots.Num(), Bowling->GetNumShotsRecorded()));
+
+		auto* Replay = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		for (auto ShotIndex = 0; ShotIndex <= Shots.Num(); ShotIndex++)
+		{
+			if (ShotIndex > 0) { Replay->SetScore(Shots[ShotIndex - 1]); }
+
+			for (auto Frame = 1; Frame <= 10; Frame++)
+			{
+				ASSERT_THAT(AreEqual(Replay->GetScore(Frame), Bowling->GetScoreAt(ShotIndex, Frame),
+					FString::Format(TEXT("Shot {0} Frame {1}"), {ShotIndex, Frame})));
+			}
+
+			auto Frame = 0;
+			auto Shot = 0;
+			ASSERT_THAT(IsTrue(Bowling->GetCursorAt(ShotIndex, Frame, Shot)));
+			ASSERT_THAT(AreEqual(Replay->GetCurrentFrameNum(), Frame));
+			ASSERT_THAT(AreEqual(Replay->GetCurrentShotNum(), Shot));
+		}
+
+		auto Frame = 0;
+		auto Shot = 0;
+		ASSERT_THAT(IsFalse(Bowling->GetCursorAt(Shots.Num() + 1, Frame, Shot)));
+		ASSERT_THAT(AreEqual(0, Bowling->GetScoreAt(Shots.Num() + 1, 10)));
+
+		Bowling->Reset();
+		ASSERT_THAT(AreEqual(0, Bowling->GetNumShotsRecorded()));
+		ASSERT_THAT(IsTrue(Bowling->GetCursorAt(0, Frame, Shot)));
+		ASSERT_THAT(AreEqual(1, Frame));
+		ASSERT_THAT(AreEqual(1, Shot));
+	}
+
+	// A game's memory is all set aside up front and doesn't grow as it's played or replayed
+	TEST_METHOD(BowlingScore_AllocatedSize)
+	{
+		const auto Bytes = Bowling->GetAllocatedSize();
+		ASSERT_THAT(IsTrue(Bytes > 0));
+
+		for (auto Game = 0; Game < 3; Game++)
+		{
+			while (Bowling->SetScore(10)) {}
+			ASSERT_THAT(AreEqual(Bytes, Bowling->GetAllocatedSize()));
+			Bowling->Reset();
+			ASSERT_THAT(AreEqual(Bytes, Bowling->GetAllocatedSize()));
+		}
+	}
+
+	// One call has everything the per shot and frame getters do
+	TEST_METHOD(BowlingScore_Snapshot)
+	{
+		for (auto Pins : {10, 7, 3, 9, 0, 4})
+		{
+			Bowling->SetScore(Pins);
+		}
+
+		FBowlingScoreSnapshot Snapshot;
+		Bowling->GetSnapshot(Snapshot);
+		ASSERT_THAT(AreEqual(10, Snapshot.Frames.Num()));
+		ASSERT_THAT(AreEqual(4, Snapshot.CurrentFrame));
+		ASSERT_THAT(AreEqual(2, Snapshot.CurrentShot));
+		ASSERT_THAT(IsFalse(Snapshot.bGameOver));
+		ASSERT_THAT(AreEqual(Bowling->GetScore(10), Snapshot.Score));
+		ASSERT_THAT(AreEqual(Bowling->GetMaxPossibleScore(), Snapshot.MaxPossibleScore));
+
+		for (auto Frame = 1; Frame <= 10; Frame++)
+		{
+			const auto& FrameSnapshot = Snapshot.Frames[Frame - 1];
+			ASSERT_THAT(AreEqual(Bowling->GetFrameScore(Frame), FrameSnapshot.FrameScore));
+			ASSERT_THAT(AreEqual(Bowling->GetScore(Frame), FrameSnapshot.Score));
+			for (auto Shot = 1; Shot <= FrameSnapshot.Shots.Num(); Shot++)
+			{
+				ASSERT_THAT(AreEqual(Bowling->GetShotScore(Frame, Shot), FrameSnapshot.Shots[Shot - 1]));
+			}
+		}
+
+		using enum EBowlingShotMark;
+		ASSERT_THAT(IsTrue(Snapshot.Frames[0].Marks == TArray<EBowlingShotMark>{Strike, None}));
+		ASSERT_THAT(IsTrue(Snapshot.Frames[1].Marks == TArray<EBowlingShotMark>{Open, Spare}));
+		ASSERT_THAT(IsTrue(Snapshot.Frames[2].Marks == TArray<EBowlingShotMark>{Open, Open}));
+		ASSERT_THAT(IsTrue(Snapshot.Frames[3].Marks == TArray<EBowlingShotMark>{Open, None}));
+		ASSERT_THAT(AreEqual(1, Snapshot.Frames[0].NumShotsThrown));
+		ASSERT_THAT(AreEqual(1, Snapshot.Frames[3].NumShotsThrown));
+		ASSERT_THAT(AreEqual(0, Snapshot.Frames[4].NumShotsThrown));
+	}
+
+	// Asking again without the game changing hands back the same snapshot
+	TEST_METHOD(BowlingScore_SnapshotCached)
+	{
+		Bowling->SetScore(5);
+		const auto* Snapshot = &Bowling->GetCachedSnapshot();
+		const auto* Frames = Snapshot->Frames.GetData();
+		const auto Version = Snapshot->StateVersion;
+
+		ASSERT_THAT(AreEqual(Version, Bowling->GetCachedSnapshot().StateVersion));
+		ASSERT_THAT(IsTrue(Frames == Bowling->GetCachedSnapshot().Frames.GetData()));
+
+		Bowling->SetScore(5);
+		ASSERT_THAT(IsTrue(Bowling->GetCachedSnapshot().StateVersion > Version));
+		ASSERT_THAT(IsTrue(Bowling->GetCachedSnapshot().Frames[0].Marks[1] == EBowlingShotMark::Spare));
+
+		Bowling->Reset();
+		ASSERT_THAT(AreEqual(0, Bowling->GetCachedSnapshot().Frames[0].NumShotsThrown));
+		ASSERT_THAT(IsTrue(Bowling->GetCachedSnapshot().Frames[0].Marks[0] == EBowlingShotMark::None));
+	}
+
+	// Pins knocked down can be recorded instead of a count, and later balls can only knock down pins still standing
+	TEST_METHOD(BowlingScore_PinMasks)
+	{
+		// Everything but the 7 and 10 pins, leaving a split
+		constexpr auto Split = 0b0110111111;
+		ASSERT_THAT(IsTrue(Bowling->SetPinMask(Split)));
+		ASSERT_THAT(AreEqual(8, Bowling->GetShotScore(1, 1)));
+		ASSERT_THAT(AreEqual(Split, Bowling->GetPinMask(1, 1)));
+		ASSERT_THAT(AreEqual(0b1001000000, Bowling->GetPinsStandingMask()));
+
+		// The head pin is already down
+		ASSERT_THAT(IsFalse(Bowling->IsValidPinMask(0b0000000001)));
+		ASSERT_THAT(IsFalse(Bowling->SetPinMask(0b0000000001)));
+		ASSERT_THAT(IsFalse(Bowling->IsValidPinMask(1 << 10)));
+		ASSERT_THAT(IsTrue(Bowling->SetPinMask(0b1001000000)));
+		ASSERT_THAT(IsTrue(Bowling->IsSpare(1, 2)));
+		ASSERT_THAT(AreEqual(0b1111111111, Bowling->GetPinsStandingMask()));
+
+		// A count alone means the pins left standing aren't known, so any mask with a valid count is taken
+		ASSERT_THAT(IsTrue(Bowling->SetScore(3)));
+		ASSERT_THAT(AreEqual(0, Bowling->GetPinMask(2, 1)));
+		ASSERT_THAT(AreEqual(0, Bowling->GetPinsStandingMask()));
+		ASSERT_THAT(IsTrue(Bowling->IsValidPinMask(0b0000000001)));
+		ASSERT_THAT(IsFalse(Bowling->IsValidPinMask(0b1111111100)));
+		ASSERT_THAT(AreEqual(13, Bowling->GetScore(1)));
+
+		Bowling->Reset();
+		ASSERT_THAT(AreEqual(0, Bowling->GetPinMask(1, 1)));
+	}
 };
@@ -0,0 +1,150 @@
+﻿#include "BowlingScoreComponent.h"
+#include "BowlingScoreExporter.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+
+TEST_CLASS(BowlingScoreExporterTests, "Bowling.Export")
+{
+	FActorTestSpawner Spawner;
+	UBowlingScoreComponent* First;
+	UBowlingScoreComponent* Second;
+	UBowlingScoreExporter* Exporter;
+	int32 Consumer;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		First = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Second = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Exporter = NewObject<UBowlingScoreExporter>();
+		Exporter->AddGame(1, First);
+		Exporter->AddGame(2, Second);
+		Consumer = Exporter->AddConsumer();
+	}
+
+	static FString ToString(const TArray<uint8>& Json)
+	{
+		return FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num()));
+	}
+
+	TEST_METHOD(Export_FullSnapshot)
+	{
+		TArray<uint8> Json;
+		const auto Version = Exporter->ExportJson(Consumer, Json);
+		const auto Text = ToString(Json);
+
+		ASSERT_THAT(AreEqual(UBowlingScoreComponent::GetLatestStateVersion(), Version));
+		ASSERT_THAT(IsTrue(Text.StartsWith(FString::Printf(TEXT("{\"version\":%llu,\"games\":[{\"id\":1,\"full\":true,"
+			"\"frame\":1,\"shot\":1,\"over\":false,\"score\":0,\"frames\":[{\"frame\":1,\"shots\":[0,0],\"score\":0},"), Version))));
+		ASSERT_THAT(IsTrue(Text.Contains(TEXT("{\"frame\":10,\"shots\":[0,0,0],\"score\":0}]},{\"id\":2,"))));
+		ASSERT_THAT(IsTrue(Text.EndsWith(TEXT("]}],\"removed\":[]}"))));
+	}
+
+	// Only what changed since the last poll is sent, including bonus added to earlier frames
+	TEST_METHOD(Export_ChangeFeed)
+	{
+		TArray<uint8> Json;
+		auto Version = Exporter->ExportJson(Consumer, Json);
+
+		First->SetScore(10);
+		Version = Exporter->ExportJson(Consumer, Json);
+		ASSERT_THAT(AreEqual(FString::Printf(TEXT("{\"version\":%llu,\"games\":[{\"id\":1,\"full\":false,\"frame\":2,"
+			"\"shot\":1,\"over\":false,\"score\":10,\"frames\":[{\"frame\":1,\"shots\":[10,0],\"score\":10}]}],"
+			"\"removed\":[]}"), Version), ToString(Json)));
+
+		First->SetScore(3);
+		Version = Exporter->ExportJson(Consumer, Json);
+		ASSERT_THAT(AreEqual(FString::Printf(TEXT("{\"version\":%llu,\"games\":[{\"id\":1,\"full\":false,\"frame\":2,"
+			"\"shot\":2,\"over\":false,\"score\":16,\"frames\":[{\"frame\":1,\"shots\":[10,0],\"score\":13},"
+			"{\"frame\":2,\"shots\":[3,0],\"score\":3}]}],\"removed\":[]}"), Version), ToString(Json)));
+
+		// Nothing changed
+		const auto Since = Version;
+		Version = Exporter->ExportJson(Consumer, Json);
+		ASSERT_THAT(AreEqual(Since, Version));
+		ASSERT_THAT(AreEqual(FString::Printf(TEXT("{\"version\":%llu,\"games\":[],\"removed\":[]}"), Version),
+			ToString(Json)));
+
+		// Removed and newly added games
+		Exporter->RemoveGame(2);
+		Exporter->AddGame(3, Second);
+		Exporter->ExportJson(Consumer, Json);
+		const auto Text = ToString(Json);
+		ASSERT_THAT(IsTrue(Text.Contains(TEXT("{\"id\":3,\"full\":true,"))));
+		ASSERT_THAT(IsFalse(Text.Contains(TEXT("{\"id\":1,"))));
+		ASSERT_THAT(IsTrue(Text.EndsWith(TEXT("],\"removed\":[2]}"))));
+	}
+
+	TEST_METHOD(Export_Binary)
+	{
+		TArray<uint8> Data;
+		Exporter->ExportBinary(Consumer, Data);
+
+		Second->SetScore(7);
+		Second->SetScore(3);
+		const auto Version = Exporter->ExportBinary(Consumer, Data);
+
+		const TArray<uint8> Expected = {
+			// Version
+			static_cast<uint8>(Version), static_cast<uint8>(Version >> 8), static_cast<uint8>(Version >> 16),
+			static_cast<uint8>(Version >> 24), static_cast<uint8>(Version >> 32), static_cast<uint8>(Version >> 40),
+			static_cast<uint8>(Version >> 48), static_cast<uint8>(Version >> 56),
+			// One game, id 2, on frame 2 shot 1 with a score of 10 and one frame changed
+			1, 0, 2, 0, 0, 0, 0, 2, 1, 10, 0, 1,
+			// Frame 1 is a spare of 7, 3 scoring 10 so far
+			1, 2, 7, 3, 10, 0,
+			// Nothing removed
+			0, 0,
+		};
+		ASSERT_THAT(IsTrue(Expected == Data));
+	}
+
+	// Polling again writes into the same memory
+	TEST_METHOD(Export_ReusesBuffer)
+	{
+		TArray<uint8> Json;
+		Exporter->ExportJson(Consumer, Json);
+		const auto* Buffer = Json.GetData();
+		const auto Capacity = Json.Max();
+
+		for (auto Shot = 0; Shot < 10; Shot++)
+		{
+			First->SetScore(4);
+			Second->SetScore(5);
+			Exporter->ExportJson(Consumer, Json);
+			ASSERT_THAT(IsTrue(Buffer == Json.GetData()));
+			ASSERT_THAT(AreEqual(Capacity, Json.Max()));
+		}
+	}
+
+	// Removed games are told to every scoreboard once and then forgotten
+	TEST_METHOD(Export_RemovedForgotten)
+	{
+		const auto Other = Exporter->AddConsumer();
+		TArray<uint8> Json;
+		Exporter->ExportJson(Consumer, Json);
+		Exporter->ExportJson(Other, Json);
+
+		Exporter->RemoveGame(2);
+		Exporter->ExportJson(Consumer, Json);
+		ASSERT_THAT(IsTrue(ToString(Json).EndsWith(TEXT("\"removed\":[2]}"))));
+		ASSERT_THAT(AreEqual(1, Exporter->GetNumRemovedGames()));
+
+		Exporter->ExportJson(Other, Json);
+		ASSERT_THAT(IsTrue(ToString(Json).EndsWith(TEXT("\"removed\":[2]}"))));
+		ASSERT_THAT(AreEqual(0, Exporter->GetNumRemovedGames()));
+
+		// A scoreboard that stops polling doesn't hold on to them either
+		Exporter->RemoveGame(1);
+		ASSERT_THAT(AreEqual(1, Exporter->GetNumRemovedGames()));
+		Exporter->RemoveConsumer(Other);
+		Exporter->ExportJson(Consumer, Json);
+		ASSERT_THAT(AreEqual(0, Exporter->GetNumRemovedGames()));
+
+		// Nor is anything kept with nobody polling
+		Exporter->RemoveConsumer(Consumer);
+		Exporter->AddGame(4, First);
+		Exporter->RemoveGame(4);
+		ASSERT_THAT(AreEqual(0, Exporter->GetNumRemovedGames()));
+	}
+};
@@ -0,0 +1,151 @@
+﻿#include "Async/Async.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoreboardPublisher.h"
+#include "BowlingSharedScoreboard.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "Misc/Guid.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if PLATFORM_UNIX || PLATFORM_MAC
+#include "BowlingScoreboardReader.h"
+#endif
+
+TEST_CLASS(BowlingScoreboardPublisherTests, "Bowling.Scoreboard")
+{
+	FActorTestSpawner Spawner;
+	TStrongObjectPtr<UBowlingScoreboardPublisher> Publisher;
+	FString Name;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Publisher.Reset(NewObject<UBowlingScoreboardPublisher>());
+
+		// Unique so tests running side by side don't share a scoreboard
+		Name = FString::Printf(TEXT("BowlingTest%s"), *FGuid::NewGuid().ToString(EGuidFormats::Digits).Left(12));
+		ASSERT_THAT(IsTrue(Publisher->Open(Name, 4)));
+	}
+
+	AFTER_EACH()
+	{
+		Publisher->Close();
+	}
+
+	TEST_METHOD(Scoreboard_MirrorsLanes)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		auto* Other = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		ASSERT_THAT(AreEqual(0, Publisher->AddLane(7, Bowling)));
+		ASSERT_THAT(AreEqual(1, Publisher->AddLane(8, Other)));
+
+		for (auto Pins : {10, 7, 3, 4})
+		{
+			Bowling->SetScore(Pins);
+		}
+
+		// Mapped again the way another process would see it
+		const auto Size = FBowlingSharedScoreboardHeader::GetRegionSize(4);
+		auto* Region = FPlatformMemory::MapNamedSharedMemoryRegion(Name, false, FPlatformMemory::ESharedMemoryAccess::Read, Size);
+		ASSERT_THAT(IsNotNull(Region));
+		const auto& Header = *static_cast<const FBowlingSharedScoreboardHeader*>(Region->GetAddress());
+		ASSERT_THAT(IsTrue(Header.IsValid()));
+		ASSERT_THAT(AreEqual(4u, Header.NumSlots));
+
+		FBowlingSharedLaneState Lane;
+		ASSERT_THAT(IsTrue(Header.GetSlots()[0].Read(Lane)));
+		ASSERT_THAT(AreEqual(7u, Lane.LaneId));
+		ASSERT_THAT(AreEqual(Bowling->GetStateVersion(), Lane.Version));
+		ASSERT_THAT(AreEqual(3, static_cast<int32>(Lane.CurrentFrame)));
+		ASSERT_THAT(AreEqual(2, static_cast<int32>(Lane.CurrentShot)));
+		ASSERT_THAT(AreEqual(10, static_cast<int32>(Lane.Shots[0])));
+		ASSERT_THAT(AreEqual(7, static_cast<int32>(Lane.Shots[3])));
+		ASSERT_THAT(AreEqual(3, static_cast<int32>(Lane.Shots[4])));
+		ASSERT_THAT(AreEqual(20, static_cast<int32>(Lane.FrameTotals[0])));
+		ASSERT_THAT(AreEqual(34, static_cast<int32>(Lane.FrameTotals[1])));
+		ASSERT_THAT(AreEqual(Bowling->GetMaxPossibleScore(), static_cast<int32>(Lane.MaxPossibleScore)));
+
+		const auto PublishCount = Header.PublishCount.load();
+		Bowling->Reset();
+		ASSERT_THAT(IsTrue(Header.PublishCount.load() > PublishCount));
+		ASSERT_THAT(IsTrue(Header.GetSlots()[0].Read(Lane)));
+		ASSERT_THAT(AreEqual(1, static_cast<int32>(Lane.CurrentFrame)));
+		ASSERT_THAT(AreEqual(0, static_cast<int32>(Lane.FrameTotals[9])));
+
+		// Removed lanes are cleared, and their slot is given to the next lane added
+		Publisher->RemoveLane(7);
+		ASSERT_THAT(IsTrue(Header.GetSlots()[0].Read(Lane)));
+		ASSERT_THAT(AreEqual(0u, Lane.LaneId));
+		ASSERT_THAT(AreEqual(0, Publisher->AddLane(9, Bowling)));
+
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+	}
+
+	// A reader never sees half of one write and half of another, however often the slot is rewritten
+	TEST_METHOD(Scoreboard_ConsistentUnderWrites)
+	{
+		FBowlingSharedLaneSlot Slot = {};
+		std::atomic<bool> bDone = false;
+
+		auto Writer = Async(EAsyncExecution::Thread, [&Slot, &bDone]
+		{
+			for (uint64 Version = 1; Version <= 200000 and not bDone; Version++)
+			{
+				FBowlingSharedLaneState State = {};
+				State.Version = Version;
+				FMemory::Memset(State.Shots, static_cast<uint8>(Version), sizeof(State.Shots));
+				Slot.Write(State);
+			}
+			bDone = true;
+		});
+
+		// A failed assert returns straight away and would leave the writer using Slot after it's gone, so a torn read
+		// only stops the writer here and is asserted on once it has finished
+		auto NumReads = 0;
+		uint64 TornVersion = 0;
+		while (not bDone)
+		{
+			FBowlingSharedLaneState State;
+			if (not Slot.Read(State)) { continue; }
+
+			for (const auto Shot : State.Shots)
+			{
+				if (Shot != static_cast<uint8>(State.Version))
+				{
+					TornVersion = State.Version;
+					bDone = true;
+				}
+			}
+			NumReads++;
+		}
+		Writer.Wait();
+
+		TestRunner.AddInfo(FString::Printf(TEXT("%d reads"), NumReads));
+		ASSERT_THAT(AreEqual(0ull, TornVersion, TEXT("Read a version mixed with another write")));
+	}
+
+#if PLATFORM_UNIX || PLATFORM_MAC
+	TEST_METHOD(Scoreboard_Reader)
+	{
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Publisher->AddLane(3, Bowling);
+		Bowling->SetScore(9);
+
+		FBowlingScoreboardReader Reader;
+		ASSERT_THAT(IsTrue(Reader.Open(TCHAR_TO_UTF8(*Name))));
+		ASSERT_THAT(AreEqual(4u, Reader.GetNumSlots()));
+
+		uint32 LaneId = 0;
+		int32 FirstShot = 0;
+		ASSERT_THAT(IsTrue(Reader.VisitLane(0, [&](const FBowlingSharedLaneState& Lane)
+		{
+			LaneId = Lane.LaneId;
+			FirstShot = Lane.Shots[0];
+		})));
+		ASSERT_THAT(AreEqual(3u, LaneId));
+		ASSERT_THAT(AreEqual(9, FirstShot));
+
+		ASSERT_THAT(IsFalse(Reader.Open("BowlingTestMissing")));
+	}
+#endif
+};
@@ -0,0 +1,169 @@
+﻿#include "Async/Async.h"
+#include "BowlingScoreComponent.h"
+#include "BowlingScoringWorker.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "UObject/StrongObjectPtr.h"
+
+TEST_CLASS(BowlingScoringWorkerTests, "Bowling.ScoringWorker")
+{
+	FActorTestSpawner Spawner;
+	TStrongObjectPtr<UBowlingScoringWorker> Worker;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		Worker.Reset(NewObject<UBowlingScoringWorker>());
+	}
+
+	AFTER_EACH()
+	{
+		Worker->Stop();
+	}
+
+	// Take snapshots on this thread until the condition holds, as the ticker would
+	bool WaitFor(TFunctionRef<bool()> Condition)
+	{
+		const auto Timeout = FPlatformTime::Seconds() + 5.0;
+		while (FPlatformTime::Seconds() < Timeout)
+		{
+			Worker->UpdateSnapshots();
+			if (Condition()) { return true; }
+			FPlatformProcess::Sleep(0.001f);
+		}
+		return false;
+	}
+
+	// Every lane is fed by its own thread while the game thread only picks up snapshots
+	TEST_METHOD(ScoringWorker_LanesFedFromThreads)
+	{
+		constexpr auto NumLanes = 8;
+		for (auto LaneId = 1; LaneId <= NumLanes; LaneId++)
+		{
+			Worker->AddLane(LaneId);
+		}
+		Worker->Start();
+
+		// Odd lanes bowl perfect games, even lanes spares of 5, 5 all the way through
+		TArray<TFuture<void>> Producers;
+		for (auto LaneId = 1; LaneId <= NumLanes; LaneId++)
+		{
+			Producers.Add(Async(EAsyncExecution::Thread, [this, LaneId]
+			{
+				const auto NumShots = LaneId % 2 == 1 ? 12 : 21;
+				for (auto Shot = 0; Shot < NumShots; Shot++)
+				{
+					while (not Worker->PushShot(LaneId, LaneId % 2 == 1 ? 10 : 5))
+					{
+						FPlatformProcess::Yield();
+					}
+				}
+			}));
+		}
+		for (auto& Producer : Producers)
+		{
+			Producer.Wait();
+		}
+
+		ASSERT_THAT(IsTrue(WaitFor([this]
+		{
+			for (auto LaneId = 1; LaneId <= NumLanes; LaneId++)
+			{
+				if (not Worker->GetSnapshot(LaneId)->bGameOver) { return false; }
+			}
+			return true;
+		})));
+
+		for (auto LaneId = 1; LaneId <= NumLanes; LaneId++)
+		{
+			const auto& Snapshot = *Worker->GetSnapshot(LaneId);
+			ASSERT_THAT(AreEqual(LaneId % 2 == 1 ? 300 : 150, Snapshot.Score));
+			ASSERT_THAT(AreEqual(-1, Snapshot.CurrentFrame));
+		}
+		ASSERT_THAT(AreEqual(int64{NumLanes / 2 * (12 + 21)}, Worker->GetNumApplied()));
+		ASSERT_THAT(AreEqual(int64{0}, Worker->GetNumRejected()));
+	}
+
+	TEST_METHOD(ScoringWorker_Snapshot)
+	{
+		Worker->AddLane(3);
+		Worker->Start();
+		ASSERT_THAT(IsNull(Worker->GetSnapshot(4)));
+
+		// Only 3 pins are left for the 5
+		for (auto Pins : {10, 7, 5, 3})
+		{
+			ASSERT_THAT(IsTrue(Worker->PushShot(3, Pins)));
+		}
+		ASSERT_THAT(IsTrue(WaitFor([this] { return Worker->GetSnapshot(3)->CurrentFrame == 3; })));
+
+		const auto& Snapshot = *Worker->GetSnapshot(3);
+		ASSERT_THAT(AreEqual(int64{1}, Worker->GetNumRejected()));
+		ASSERT_THAT(AreEqual(30, Snapshot.Score));
+		ASSERT_THAT(AreEqual(20, Snapshot.Frames[0].Score));
+		ASSERT_THAT(IsTrue(Snapshot.Frames[0].Marks[0] == EBowlingShotMark::Strike));
+		ASSERT_THAT(IsTrue(Snapshot.Frames[1].Marks[1] == EBowlingShotMark::Spare));
+		ASSERT_THAT(AreEqual(2, Snapshot.Frames[1].NumShotsThrown));
+		ASSERT_THAT(AreEqual(280, Snapshot.MaxPossibleScore));
+
+		ASSERT_THAT(IsTrue(Worker->PushReset(3)));
+		ASSERT_THAT(IsTrue(WaitFor([this] { return Worker->GetSnapshot(3)->CurrentFrame == 1; })));
+		ASSERT_THAT(AreEqual(0, Worker->GetSnapshot(3)->Score));
+	}
+
+	// A component scored on the worker only records shots once they're published, with the usual broadcasts
+	TEST_METHOD(ScoringWorker_ScoreComponent)
+	{
+		Worker->AddLane(2);
+		Worker->Start();
+		auto* Bowling = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		Bowling->SetScoringWorker(Worker.Get(), 2);
+		ASSERT_THAT(IsTrue(Bowling->IsScoredOnWorker()));
+
+		auto NumAdvanced = 0;
+		Bowling->OnGameStateChanged.AddLambda([&NumAdvanced](UBowlingScoreComponent*) { NumAdvanced++; });
+
+		// Turned away at once without reaching the worker
+		ASSERT_THAT(IsFalse(Bowling->SetScore(11)));
+
+		ASSERT_THAT(IsTrue(Bowling->SetScore(10)));
+		ASSERT_THAT(AreEqual(0, Bowling->GetNumShotsRecorded()));
+		ASSERT_THAT(IsTrue(WaitFor([Bowling] { return Bowling->GetNumShotsRecorded() == 1; })));
+		ASSERT_THAT(AreEqual(2, Bowling->GetCurrentFrameNum()));
+		ASSERT_THAT(IsTrue(Bowling->IsStrike(1, 1)));
+
+		// Shots published together are each recorded and broadcast in turn
+		ASSERT_THAT(IsTrue(Worker->PushShot(2, 7)));
+		ASSERT_THAT(IsTrue(Worker->PushShot(2, 3)));
+		ASSERT_THAT(IsTrue(WaitFor([Bowling] { return Bowling->GetNumShotsRecorded() == 3; })));
+		ASSERT_THAT(AreEqual(3, NumAdvanced));
+		ASSERT_THAT(AreEqual(20, Bowling->GetScore(1)));
+		ASSERT_THAT(AreEqual(17, Bowling->GetScoreAt(2, 1)));
+		ASSERT_THAT(AreEqual(Worker->GetSnapshot(2)->Score, Bowling->GetScore(Bowling->GetNumFrames())));
+		ASSERT_THAT(IsTrue(Bowling->GetPublishedSnapshot() == Worker->GetSnapshot(2)));
+
+		// A reset and a shot after it in the same publish start the game over before the shot
+		Bowling->Reset();
+		ASSERT_THAT(IsTrue(Worker->PushShot(2, 4)));
+		ASSERT_THAT(IsTrue(WaitFor([Bowling] { return Bowling->GetNumShotsRecorded() == 1; })));
+		ASSERT_THAT(AreEqual(4, Bowling->GetShotScore(1, 1)));
+		ASSERT_THAT(AreEqual(2, Bowling->GetCurrentShotNum()));
+
+		Bowling->SetScoringWorker(nullptr, 0);
+		ASSERT_THAT(IsFalse(Bowling->IsScoredOnWorker()));
+		ASSERT_THAT(IsTrue(Bowling->SetScore(6)));
+		ASSERT_THAT(AreEqual(2, Bowling->GetNumShotsRecorded()));
+	}
+
+	TEST_METHOD(ScoringWorker_NotRunning)
+	{
+		Worker->AddLane(1);
+		ASSERT_THAT(IsFalse(Worker->PushShot(1, 5)));
+		ASSERT_THAT(IsNull(Worker->GetSnapshot(1)));
+
+		Worker->Start();
+		ASSERT_THAT(IsFalse(Worker->PushShot(2, 5)));
+		ASSERT_THAT(IsFalse(Worker->PushShot(1, -1)));
+		ASSERT_THAT(IsNotNull(Worker->GetSnapshot(1)));
+	}
+};
@@ -0,0 +1,100 @@
+﻿#include "BowlingScoreComponent.h"
+#include "BowlingShotLog.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+TEST_CLASS(BowlingShotLogTests, "Bowling.ShotLog")
+{
+	FActorTestSpawner Spawner;
+	FString LogPath;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+		LogPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("BowlingShotLogTest.bin"));
+		FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*LogPath);
+	}
+
+	AFTER_EACH()
+	{
+		FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*LogPath);
+	}
+
+	// Open a log in a "new process" with fresh lanes and recover it
+	TArray<UBowlingScoreComponent*> Recover(int32 NumLanes, int32& OutReplayed)
+	{
+		TArray<UBowlingScoreComponent*> Lanes;
+		auto* ShotLog = NewObject<UBowlingShotLog>();
+		ShotLog->Open(LogPath);
+		for (auto LaneId = 0; LaneId < NumLanes; LaneId++)
+		{
+			Lanes.Add(&Spawner.SpawnObject<UBowlingScoreComponent>());
+			ShotLog->AddLane(LaneId, Lanes.Last());
+		}
+		OutReplayed = ShotLog->Recover();
+		ShotLog->Close();
+		return Lanes;
+	}
+
+	TEST_METHOD(ShotLog_Recover)
+	{
+		auto* ShotLog = NewObject<UBowlingShotLog>();
+		ASSERT_THAT(IsTrue(ShotLog->Open(LogPath)));
+
+		auto* LaneOne = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		auto* LaneTwo = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		ShotLog->AddLane(0, LaneOne);
+		ShotLog->AddLane(1, LaneTwo);
+
+		// Lane one starts over partway through, lane two is mid-frame when the "crash" happens
+		LaneOne->SetScore(4);
+		LaneOne->SetScore(6);
+		LaneOne->Reset();
+		LaneOne->SetScore(10);
+		LaneOne->SetScore(3);
+		LaneTwo->SetScore(7);
+		LaneTwo->SetScore(2);
+		LaneTwo->SetScore(5);
+
+		ShotLog->Flush();
+		ASSERT_THAT(AreEqual(ShotLog->GetAppendedCount(), ShotLog->GetDurableCount()));
+		ShotLog->Close();
+
+		auto Replayed = 0;
+		auto Lanes = Recover(2, Replayed);
+		ASSERT_THAT(AreEqual(8, Replayed));
+
+		ASSERT_THAT(AreEqual(LaneOne->GetCurrentFrameNum(), Lanes[0]->GetCurrentFrameNum()));
+		ASSERT_THAT(AreEqual(LaneOne->GetCurrentShotNum(), Lanes[0]->GetCurrentShotNum()));
+		ASSERT_THAT(AreEqual(LaneOne->GetScore(10), Lanes[0]->GetScore(10)));
+		ASSERT_THAT(AreEqual(LaneTwo->GetCurrentFrameNum(), Lanes[1]->GetCurrentFrameNum()));
+		ASSERT_THAT(AreEqual(LaneTwo->GetCurrentShotNum(), Lanes[1]->GetCurrentShotNum()));
+		ASSERT_THAT(AreEqual(LaneTwo->GetScore(10), Lanes[1]->GetScore(10)));
+	}
+
+	// A crash in the middle of writing a batch leaves a partial record at the end of the log
+	TEST_METHOD(ShotLog_RecoverTornWrite)
+	{
+		auto* ShotLog = NewObject<UBowlingShotLog>();
+		ASSERT_THAT(IsTrue(ShotLog->Open(LogPath)));
+		auto* Lane = &Spawner.SpawnObject<UBowlingScoreComponent>();
+		ShotLog->AddLane(0, Lane);
+		Lane->SetScore(3);
+		Lane->SetScore(4);
+		ShotLog->Close();
+
+		TArray<uint8> Data;
+		ASSERT_THAT(IsTrue(FFileHelper::LoadFileToArray(Data, *LogPath)));
+		Data.Append({0xFF, 0x01, 0x07});
+		ASSERT_THAT(IsTrue(FFileHelper::SaveArrayToFile(Data, *LogPath)));
+
+		auto Replayed = 0;
+		auto Lanes = Recover(1, Replayed);
+		ASSERT_THAT(AreEqual(2, Replayed));
+		ASSERT_THAT(AreEqual(7, Lanes[0]->GetScore(10)));
+		ASSERT_THAT(AreEqual(2, Lanes[0]->GetCurrentFrameNum()));
+	}
+};
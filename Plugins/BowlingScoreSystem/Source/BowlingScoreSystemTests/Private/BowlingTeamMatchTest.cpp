@@ -0,0 +1,177 @@
+﻿#include "BowlingScoreComponent.h"
+#include "BowlingTeamMatch.h"
+#include "CQTest.h"
+#include "Components/ActorTestSpawner.h"
+#include "UObject/StrongObjectPtr.h"
+
+TEST_CLASS(BowlingTeamMatchTests, "Bowling.TeamMatch")
+{
+	FActorTestSpawner Spawner;
+
+	BEFORE_EACH()
+	{
+		Spawner = FActorTestSpawner();
+	}
+
+	// Knock down the same number of pins with every ball until the game is over
+	static void BowlGame(UBowlingScoreComponent& Bowling, int32 Pins)
+	{
+		while (not Bowling.IsGameOver())
+		{
+			Bowling.SetScore(FMath::Min(Pins, Bowling.GetPinsStanding()));
+		}
+	}
+
+	TEST_METHOD(TeamMatch_Pool)
+	{
+		FBowlingGamePool Pool;
+		TArray<FBowlingGameRecord*> Games;
+		for (auto Idx = 0; Idx < FBowlingGamePool::GamesPerSlab + 1; Idx++)
+		{
+			Games.Add(Pool.Allocate());
+		}
+		ASSERT_THAT(AreEqual(2, Pool.GetNumSlabs()));
+		ASSERT_THAT(AreEqual(FBowlingGamePool::GamesPerSlab + 1, Pool.GetNumAllocated()));
+
+		// Freed games come back zeroed instead of growing the pool
+		Games[3]->Score = 300;
+		Pool.Free(Games[3]);
+		auto* Reused = Pool.Allocate();
+		ASSERT_THAT(IsTrue(Reused == Games[3]));
+		ASSERT_THAT(AreEqual(0, Reused->Score));
+		ASSERT_THAT(AreEqual(2, Pool.GetNumSlabs()));
+
+		for (auto* Game : Games)
+		{
+			Pool.Free(Game);
+		}
+		ASSERT_THAT(AreEqual(0, Pool.GetNumAllocated()));
+		Pool.Empty();
+		ASSERT_THAT(AreEqual(0, Pool.GetNumSlabs()));
+	}
+
+	TEST_METHOD(TeamMatch_Totals)
+	{
+		FBowlingGamePool Pool;
+		{
+			FBowlingTeamMatch Match(3, Pool);
+			const auto Team = Match.AddTeam();
+			const auto Alice = Match.AddSeries(Team, 10);
+			const auto Bob = Match.AddSeries(Team, 0);
+
+			// Totals move with each game's cumulative score
+			ASSERT_THAT(IsTrue(Match.UpdateGame(Alice, {20, 20})));
+			ASSERT_THAT(IsTrue(Match.UpdateGame(Alice, {20, 35})));
+			ASSERT_THAT(IsTrue(Match.UpdateGame(Bob, {9})));
+			ASSERT_THAT(AreEqual(35, Match.GetSeriesTotal(Alice)));
+			ASSERT_THAT(AreEqual(45, Match.GetSeriesTotal(Alice, true)));
+			ASSERT_THAT(AreEqual(44, Match.GetTeamTotal(Team)));
+			ASSERT_THAT(AreEqual(54, Match.GetTeamTotal(Team, true)));
+			ASSERT_THAT(AreEqual(15, Match.GetGame(Alice, 1)->GetFrameScore(2)));
+
+			// A restarted game comes back off the totals, handicap and all
+			Match.AbandonGame(Bob);
+			ASSERT_THAT(AreEqual(35, Match.GetTeamTotal(Team)));
+			ASSERT_THAT(AreEqual(0, Match.GetNumGamesStarted(Bob)));
+
+			// Finished games stay counted and the next update starts the next game
+			Match.FinishGame(Alice);
+			ASSERT_THAT(IsTrue(Match.UpdateGame(Alice, {100})));
+			Match.FinishGame(Alice);
+			ASSERT_THAT(IsTrue(Match.UpdateGame(Alice, {150})));
+			Match.FinishGame(Alice);
+			ASSERT_THAT(IsTrue(Match.IsSeriesComplete(Alice)));
+			ASSERT_THAT(IsFalse(Match.UpdateGame(Alice, {10})));
+			ASSERT_THAT(AreEqual(285, Match.GetSeriesTotal(Alice)));
+			ASSERT_THAT(AreEqual(315, Match.GetSeriesTotal(Alice, true)));
+			ASSERT_THAT(AreEqual(110, Match.GetTeamGameTotal(Team, 2, true)));
+			ASSERT_THAT(AreEqual(3, Pool.GetNumAllocated()));
+
+			Match.ResetGames();
+			ASSERT_THAT(AreEqual(0, Match.GetTeamTotal(Team, true)));
+			ASSERT_THAT(AreEqual(0, Pool.GetNumAllocated()));
+
+			ASSERT_THAT(IsTrue(Match.UpdateGame(Bob, {7})));
+		}
+
+		// Games still in a match go back when it's gone
+		ASSERT_THAT(AreEqual(0, Pool.GetNumAllocated()));
+	}
+
+	TEST_METHOD(TeamMatch_Series)
+	{
+		TStrongObjectPtr<UBowlingTeamMatch> Match(NewObject<UBowlingTeamMatch>());
+		auto& Alice = Spawner.SpawnObject<UBowlingScoreComponent>();
+		auto& Bob = Spawner.SpawnObject<UBowlingScoreComponent>();
+
+		const auto Team = Match->AddTeam();
+		const auto Handicap = UBowlingTeamMatch::GetHandicap(180);
+		ASSERT_THAT(AreEqual(36, Handicap));
+		Match->AddBowler(Team, &Alice, 1, Handicap);
+		Match->AddBowler(Team, &Bob, 2);
+
+		for (auto Game = 0; Game < 3; Game++)
+		{
+			BowlGame(Alice, 10);
+			BowlGame(Bob, 5);
+
+			// The last game is left on the lanes
+			if (Game == 2) { break; }
+			Alice.Reset();
+			Bob.Reset();
+		}
+
+		ASSERT_THAT(AreEqual(900, Match->GetSeriesTotal(1, false)));
+		ASSERT_THAT(AreEqual(900 + 3 * Handicap, Match->GetSeriesTotal(1, true)));
+		ASSERT_THAT(AreEqual(450, Match->GetSeriesTotal(2, false)));
+		ASSERT_THAT(AreEqual(1350, Match->GetTeamTotal(Team, false)));
+		ASSERT_THAT(AreEqual(450 + Handicap, Match->GetTeamGameTotal(Team, 2, true)));
+		ASSERT_THAT(AreEqual(150, Match->GetGameScore(2, 3)));
+
+		// The series is over, so a fourth game isn't counted
+		Alice.Reset();
+		Alice.SetScore(7);
+		ASSERT_THAT(AreEqual(900, Match->GetSeriesTotal(1, false)));
+
+		// A new night starts over with the same bowlers, Alice's game in progress is their first
+		Match->ResetGames();
+		ASSERT_THAT(AreEqual(7, Match->GetSeriesTotal(1, false)));
+		ASSERT_THAT(AreEqual(7, Match->GetTeamTotal(Team, false)));
+
+		// Starting a game over takes it back off
+		Alice.Reset();
+		ASSERT_THAT(AreEqual(0, Match->GetTeamTotal(Team, true)));
+	}
+
+	TEST_METHOD(TeamMatch_Baker)
+	{
+		TStrongObjectPtr<UBowlingTeamMatch> Match(NewObject<UBowlingTeamMatch>());
+		auto& Bowling = Spawner.SpawnObject<UBowlingScoreComponent>();
+
+		const auto Team = Match->AddTeam();
+		Match->AddBakerGame(Team, &Bowling, {11, 12, 13, 14, 15}, 20);
+		ASSERT_THAT(AreEqual(11, Match->GetBakerBowler(&Bowling, 1)));
+		ASSERT_THAT(AreEqual(11, Match->GetBakerBowler(&Bowling, 6)));
+		ASSERT_THAT(AreEqual(15, Match->GetBakerBowler(&Bowling, 10)));
+
+		// Strikes in the first five frames, spares of 9 and 1 in the last five
+		for (auto Frame = 0; Frame < 5; Frame++)
+		{
+			Bowling.SetScore(10);
+		}
+		BowlGame(Bowling, 9);
+
+		const auto Score = Bowling.GetScore(10);
+		ASSERT_THAT(AreEqual(Score, Match->GetTeamTotal(Team, false)));
+		ASSERT_THAT(AreEqual(Score + 20, Match->GetTeamTotal(Team, true)));
+
+		// Each bowler is credited with the frames they bowled
+		auto Credited = 0;
+		for (const auto BowlerId : {11, 12, 13, 14, 15})
+		{
+			Credited += Match->GetBakerPinfall(BowlerId);
+		}
+		ASSERT_THAT(AreEqual(Score, Credited));
+		ASSERT_THAT(AreEqual(30 + 19, Match->GetBakerPinfall(12)));
+	}
+};
@@ -0,0 +1,259 @@
+﻿// Partly Atomic LLC 2025
+
+
+#include "BowlingFrameWidget.h"
+
+#include "BowlingLatencyTracker.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "Components/EditableTextBox.h"
+#include "Components/TextBlock.h"
+#include "GameFramework/PlayerState.h"
+
+namespace
+{
+	// Text for every score is made once and shared, so refreshing the scorecard doesn't allocate
+	const FText& GetScoreText(int32 Score)
+	{
+		static TArray<FText> ScoreTexts;
+		if (not ScoreTexts.IsValidIndex(Score))
+		{
+			// Enough for a perfect ten-pin game up front
+			const auto NumTexts = FMath::Max(Score, 300) + 1;
+			ScoreTexts.Reserve(NumTexts);
+			for (auto Text = ScoreTexts.Num(); Text < NumTexts; Text++)
+			{
+				ScoreTexts.Add(FText::AsCultureInvariant(FString::FromInt(Text)));
+			}
+		}
+		return ScoreTexts[Score];
+	}
+
+	const FText& GetStrikeText()
+	{
+		static const FText StrikeText = INVTEXT("X");
+		return StrikeText;
+	}
+
+	const FText& GetSpareText()
+	{
+		static const FText SpareText = INVTEXT("/");
+		return SpareText;
+	}
+}
+
+UBowlingFrameWidget::UBowlingFrameWidget(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer), FrameNumber(0)
+{
+	SetIsFocusable(true);
+}
+
+void UBowlingFrameWidget::SetFrame_Implementation(int32 InFrameNumber)
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	FrameNumber = InFrameNumber;
+
+	// No reason to keep the third shot textbox around unless the frame can take three shots
+	if (RuleSet->GetNumShots(FrameNumber - 1) < 3)
+	{
+		Shot3TextBox->RemoveFromParent();
+		Shot3TextBox = nullptr;
+	}
+}
+
+void UBowlingFrameWidget::Reset()
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	// Reset textboxes to disabled input and clear contents
+	for (auto&& TextBox : {Shot1TextBox, Shot2TextBox, Shot3TextBox})
+	{
+		if (!IsValid(TextBox)) { continue; }
+		TextBox->SetText(FText::GetEmpty());
+		TextBox->SetIsEnabled(false);
+		TextBox->SetIsReadOnly(true);
+	}
+
+	Shot1TextBox->OnTextChanged.AddUniqueDynamic(this, &UBowlingFrameWidget::ValidateShot1Entry);
+	Shot2TextBox->OnTextChanged.AddUniqueDynamic(this, &UBowlingFrameWidget::ValidateShot2Entry);
+	if (Shot3TextBox)
+	{
+		Shot3TextBox->OnTextChanged.AddUniqueDynamic(this, &UBowlingFrameWidget::ValidateShot3Entry);
+	}
+
+	ScoreText->SetText(FText::GetEmpty());
+}
+
+void UBowlingFrameWidget::SetCurrentGameState(int32 CurrentFrame, int32 CurrentShot)
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	if (CurrentFrame == FrameNumber)
+	{
+		auto* ShotBox = GetShotTextBox(CurrentShot);
+		if (not ensure(IsValid(ShotBox))) { return; }
+
+		// The textboxes will be disabled after submitting a score
+		ShotBox->SetIsReadOnly(false);
+		ShotBox->SetIsEnabled(true);
+		SetDesiredFocusWidget(ShotBox);
+		SetFocus();
+	}
+}
+
+void UBowlingFrameWidget::UpdateScore()
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	// Only set score text if at least one shot has been entered for the current frame
+	if (not Shot1TextBox->GetText().IsEmpty())
+	{
+		auto* BowlingScoreComponent = GetBowlingScoreComponent();
+		if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+
+		// Scored on a worker, the frame shows the results it last published rather than scoring them here
+		const auto* Published = BowlingScoreComponent->GetPublishedSnapshot();
+		const auto* PublishedFrame = Published and Published->Frames.IsValidIndex(FrameNumber - 1)
+			? &Published->Frames[FrameNumber - 1]
+			: nullptr;
+		auto Score = PublishedFrame ? PublishedFrame->Score : BowlingScoreComponent->GetScore(FrameNumber);
+
+		// Frames before the current one are refreshed every shot, most without their score changing
+		const auto& NewScoreText = GetScoreText(FMath::Max(Score, 0));
+		if (not ScoreText->GetText().IdenticalTo(NewScoreText))
+		{
+			ScoreText->SetText(NewScoreText);
+		}
+
+		// Entries only turn into / or X once the worker has scored them
+		for (auto ShotIdx = 0; PublishedFrame and ShotIdx < PublishedFrame->NumShotsThrown; ShotIdx++)
+		{
+			const auto Mark = PublishedFrame->Marks[ShotIdx];
+			auto* TextBox = GetShotTextBox(ShotIdx + 1);
+			if (not TextBox or (Mark != EBowlingShotMark::Strike and Mark != EBowlingShotMark::Spare)) { continue; }
+
+			const auto& MarkText = Mark == EBowlingShotMark::Strike ? GetStrikeText() : GetSpareText();
+			if (not TextBox->GetText().IdenticalTo(MarkText)) { TextBox->SetText(MarkText); }
+		}
+
+		FBowlingLatencyTracker::Get().Record(*BowlingScoreComponent, EBowlingLatencyStage::UpdateScore);
+	}
+}
+
+bool UBowlingFrameWidget::IsFinalFrame() const
+{
+	return FrameNumber == RuleSet->NumFrames;
+}
+
+UBowlingScoreComponent* UBowlingFrameWidget::GetBowlingScoreComponent() const
+{
+	// BowlingScoreComponent lives on PlayerState
+	auto* PlayerState = GetOwningPlayerState();
+	if (not ensure(IsValid(PlayerState))) { return nullptr; }
+
+	return PlayerState->GetComponentByClass<UBowlingScoreComponent>();
+}
+
+UEditableTextBox* UBowlingFrameWidget::GetShotTextBox(int32 Shot) const
+{
+	switch (Shot)
+	{
+	case 1: return Shot1TextBox;
+	case 2: return Shot2TextBox;
+	case 3: return Shot3TextBox;
+	default: return nullptr;
+	}
+}
+
+void UBowlingFrameWidget::ValidateShot1Entry(const FText& Text)
+{
+	ValidateTextEntry(Text, 1);
+}
+
+void UBowlingFrameWidget::ValidateShot2Entry(const FText& Text)
+{
+	ValidateTextEntry(Text, 2);
+}
+
+void UBowlingFrameWidget::ValidateShot3Entry(const FText& Text)
+{
+	ValidateTextEntry(Text, 3);
+}
+
+void UBowlingFrameWidget::ValidateTextEntry(const FText& Text, int32 Shot)
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	// Empty is OK
+	if (Text.IsEmpty()) { return; }
+
+	auto* TextBox = GetShotTextBox(Shot);
+	if (not ensureMsgf(IsValid(TextBox), TEXT("Could not find modified textbox")))
+	{
+		return;
+	}
+
+	// Only accept the first character, read in place rather than copying the text's string
+	const auto& String = Text.ToString();
+	const auto Entry = String[0];
+	const auto bStrikeOrSpare = Entry == 'X' or Entry == 'x' or Entry == '/';
+	const auto bNumeric = Entry >= '0' and Entry <= '9';
+	if (String.Len() > 1)
+	{
+		// Anything else is about to be cleared
+		if (bNumeric) { TextBox->SetText(GetScoreText(Entry - '0')); }
+		else if (bStrikeOrSpare) { TextBox->SetText(Entry == '/' ? GetSpareText() : GetStrikeText()); }
+	}
+
+	auto* BowlingScoreComponent = GetBowlingScoreComponent();
+	if (not ensure(IsValid(BowlingScoreComponent)))
+	{
+		TextBox->SetText(FText::GetEmpty());
+		return;
+	}
+
+	auto Success = false;
+
+	if (bStrikeOrSpare)
+	{
+		// Both mean knocking down every standing pin, strikes with the first ball at a rack and spares with the second
+		const auto RackBall = Entry == '/' ? 2 : 1;
+		if (BowlingScoreComponent->GetRackBallNum() == RackBall)
+		{
+			Success = BowlingScoreComponent->SetScore(BowlingScoreComponent->GetPinsStanding());
+		}
+	}
+	// Checked by hand since FString::IsNumeric would also accept ".", "+", and "-"
+	else if (bNumeric)
+	{
+		Success = BowlingScoreComponent->SetScore(Entry - '0');
+
+		// Convert number to / or X notation
+		if (Success)
+		{
+			if (BowlingScoreComponent->IsSpare(FrameNumber, Shot)) { TextBox->SetText(GetSpareText()); }
+			else if (BowlingScoreComponent->IsStrike(FrameNumber, Shot)) { TextBox->SetText(GetStrikeText()); }
+		}
+	}
+
+	if (Success)
+	{
+		// Disable the box, focus will be transferred to the next box with SetCurrentGameState
+		TextBox->SetIsReadOnly(true);
+		TextBox->SetIsEnabled(false);
+	}
+	else
+	{
+		TextBox->SetText(FText::GetEmpty());
+	}
+}
+
+void UBowlingFrameWidget::NativeConstruct()
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	Super::NativeConstruct();
+
+	Reset();
+}
@@ -0,0 +1,71 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BowlingScoreUI.h"
+
+#include "BowlingLatencyTracker.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreWidget.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "UObject/UObjectIterator.h"
+
+#define LOCTEXT_NAMESPACE "FBowlingScoreUIModule"
+
+namespace
+{
+	void ReportScorecardMemory(FOutputDevice& Ar)
+	{
+		SIZE_T WidgetBytes = 0;
+		auto NumTrees = 0;
+		for (TObjectIterator<UBowlingScoreWidget> It(RF_ClassDefaultObject | RF_ArchetypeObject); It; ++It)
+		{
+			const auto Bytes = It->GetWidgetObjectSize();
+			Ar.Logf(TEXT("Scorecard %s: %llu bytes of widget objects, %d Slate widgets"), *It->GetName(),
+			        static_cast<uint64>(Bytes), It->GetNumSlateWidgets());
+			WidgetBytes += Bytes;
+			NumTrees++;
+		}
+
+		Ar.Logf(TEXT("%d scorecards, %llu bytes of widget objects (%llu per scorecard)"), NumTrees,
+		        static_cast<uint64>(WidgetBytes), static_cast<uint64>(NumTrees > 0 ? WidgetBytes / NumTrees : 0));
+
+		// Slate widgets don't know their own size, but everything they allocate for a scorecard is tagged
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (FLowLevelMemTracker::IsEnabled())
+		{
+			const auto TaggedBytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(
+				ELLMTracker::Default, LLM_TAG_NAME(Bowling_Widgets), ELLMTagSet::None);
+			Ar.Logf(TEXT("Scorecards in all, Slate widgets and text included: %lld bytes (%lld per scorecard)"),
+			        TaggedBytes, NumTrees > 0 ? TaggedBytes / NumTrees : 0);
+			return;
+		}
+#endif
+		Ar.Logf(TEXT("Run with -llm for the scorecards in all, Slate widgets and text included"));
+	}
+}
+
+void FBowlingScoreUIModule::StartupModule()
+{
+	// The render thread gets to a command enqueued at the end of a frame once it has the rest of it, Slate's draw
+	// included
+	FBowlingLatencyTracker::Get().SetRenderFence([](TFunction<void()>&& OnceDrawn)
+	{
+		ENQUEUE_RENDER_COMMAND(BowlingLatencyRendered)(
+			[OnceDrawn = MoveTemp(OnceDrawn)](FRHICommandListImmediate&)
+			{
+				OnceDrawn();
+			});
+	});
+
+	MemoryReportHandle = FBowlingMemory::OnReport.AddStatic(&ReportScorecardMemory);
+}
+
+void FBowlingScoreUIModule::ShutdownModule()
+{
+	FBowlingLatencyTracker::Get().SetRenderFence(nullptr);
+	FBowlingMemory::OnReport.Remove(MemoryReportHandle);
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FBowlingScoreUIModule, BowlingScoreUI)
@@ -0,0 +1,236 @@
+﻿// Partly Atomic LLC 2025
+
+#include "BowlingScoreWidget.h"
+
+#include "Blueprint/WidgetTree.h"
+#include "BowlingFrameWidget.h"
+#include "BowlingLatencyTracker.h"
+#include "BowlingMemory.h"
+#include "BowlingScoreComponent.h"
+#include "Components/Button.h"
+#include "Components/HorizontalBox.h"
+#include "GameFramework/PlayerState.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+UBowlingScoreWidget::UBowlingScoreWidget(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	SetIsFocusable(true);
+	BowlingFrameWidgetClass = UBowlingFrameWidget::StaticClass();
+}
+
+namespace
+{
+	// Structure size of every widget in a user widget's tree, counting the trees of user widgets inside it too
+	SIZE_T GetWidgetTreeSize(const UUserWidget& UserWidget)
+	{
+		SIZE_T Bytes = UserWidget.GetClass()->GetStructureSize();
+		if (UserWidget.WidgetTree)
+		{
+			UserWidget.WidgetTree->ForEachWidget([&Bytes](UWidget* Widget)
+			{
+				if (const auto* ChildUserWidget = Cast<UUserWidget>(Widget))
+				{
+					Bytes += GetWidgetTreeSize(*ChildUserWidget);
+				}
+				else
+				{
+					Bytes += Widget->GetClass()->GetStructureSize();
+				}
+			});
+		}
+		return Bytes;
+	}
+}
+
+SIZE_T UBowlingScoreWidget::GetWidgetObjectSize() const
+{
+	return GetWidgetTreeSize(*this);
+}
+
+int32 UBowlingScoreWidget::GetNumSlateWidgets() const
+{
+	const auto Root = GetCachedWidget();
+	if (not Root) { return 0; }
+
+	auto NumWidgets = 0;
+	TArray<SWidget*, TInlineAllocator<64>> Pending = {Root.Get()};
+	while (Pending.Num() > 0)
+	{
+		auto* Children = Pending.Pop(EAllowShrinking::No)->GetChildren();
+		NumWidgets++;
+		for (auto ChildIdx = 0; ChildIdx < Children->Num(); ChildIdx++)
+		{
+			Pending.Add(&Children->GetChildAt(ChildIdx).Get());
+		}
+	}
+	return NumWidgets;
+}
+
+TSharedRef<SWidget> UBowlingScoreWidget::RebuildWidget()
+{
+	// Tagged like CreateFrameWidgets, so every Slate widget behind the scorecard is counted under Bowling_Widgets
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	return Super::RebuildWidget();
+}
+
+UBowlingScoreComponent* UBowlingScoreWidget::GetBowlingScoreComponent() const
+{
+	// The BowlingScoreComponent lives on PlayerState
+	auto* PlayerState = GetOwningPlayerState();
+	if (not ensure(PlayerState)) { return nullptr; }
+
+	return PlayerState->GetComponentByClass<UBowlingScoreComponent>();
+}
+
+void UBowlingScoreWidget::Reset()
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	// Reset all score frames
+	for (auto ChildNum = 0; ChildNum < FrameBox->GetChildrenCount(); ChildNum++)
+	{
+		auto* FrameWidget = Cast<UBowlingFrameWidget>(FrameBox->GetChildAt(ChildNum));
+		if (not ensure(IsValid(FrameWidget))) { continue; }
+
+		FrameWidget->Reset();
+	}
+
+	// Restart the game
+	auto* BowlingScoreComponent = GetBowlingScoreComponent();
+	if (not ensure(IsValid(BowlingScoreComponent))) { return; }
+	BowlingScoreComponent->Reset();
+}
+
+void UBowlingScoreWidget::GameAdvanced(UBowlingScoreComponent* BowlingScoreComponent, int32 Frame, int32 Shot)
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	// Scores will at most change the previous two scores. Since this could be the start of the "next" frame, go back three.
+	const auto UpdateFrom = FMath::Max(0, Frame - 1 - 3);
+	const auto UpdateTo = Frame;
+
+	for (auto ChildNum = 0; ChildNum < FrameBox->GetChildrenCount(); ChildNum++)
+	{
+		auto* FrameWidget = Cast<UBowlingFrameWidget>(FrameBox->GetChildAt(ChildNum));
+		if (not ensure(IsValid(FrameWidget))) { continue; }
+
+		FrameWidget->SetCurrentGameState(Frame, Shot);
+
+		// Update the score if the frames are in the range that the last shot could have modified their score
+		if (ChildNum >= UpdateFrom and ChildNum < UpdateTo)
+		{
+			FrameWidget->UpdateScore();
+		}
+	}
+
+	if (IsValid(BowlingScoreComponent))
+	{
+		FBowlingLatencyTracker::Get().Record(*BowlingScoreComponent, EBowlingLatencyStage::GameAdvanced);
+	}
+}
+
+void UBowlingScoreWidget::GameOver(UBowlingScoreComponent* BowlingScoreComponent)
+{
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	// Score needs updated for the final frame and possibly the one before it on game over
+	const auto NumFrames = FrameBox->GetChildrenCount();
+	for (auto ChildNum = FMath::Max(0, NumFrames - 2); ChildNum < NumFrames; ChildNum++)
+	{
+		auto* FrameWidget = Cast<UBowlingFrameWidget>(FrameBox->GetChildAt(ChildNum));
+		if (not ensure(IsValid(FrameWidget))) { continue; }
+		FrameWidget->UpdateScore();
+	}
+
+	// Focus on the reset button
+	SetDesiredFocusWidget(ResetButton);
+	SetFocus();
+}
+
+void UBowlingScoreWidget::CreateFrameWidgets()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreWidget::CreateFrameWidgets);
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	if (not ensure(FrameBox)) { return; }
+	if (not ensure(BowlingFrameWidgetClass)) { return; }
+
+	// The designer previews ten-pin, in game the frames are laid out for the component's rules
+	const auto* BowlingScoreComponent = IsDesignTime() ? nullptr : GetBowlingScoreComponent();
+	const auto& RuleSet = BowlingScoreComponent
+		? BowlingScoreComponent->GetRuleSet()
+		: FBowlingRuleSet::Get<FTenPinRules>();
+
+	// Frame widgets outlive the widget being removed and shown again, so they only need building once
+	if (FrameBox->GetChildrenCount() == RuleSet.NumFrames and FrameBox->GetChildAt(0)->IsA(BowlingFrameWidgetClass))
+	{
+		return;
+	}
+
+	// Since I expect frame numbers to line up with the horizontal box's children,
+	// clear anything that might have been put in via designer
+	FrameBox->ClearChildren();
+
+	// Create all the frame widgets
+	for (auto i = 0; i < RuleSet.NumFrames; i++)
+	{
+		auto* FrameWidget = CreateWidget<UBowlingFrameWidget>(this, BowlingFrameWidgetClass,
+		                                                      FName("Frame" + FString::FromInt(i + 1)));
+		FrameWidget->SetRuleSet(RuleSet);
+		FrameWidget->SetFrame(i + 1);
+		FrameBox->AddChild(FrameWidget);
+	}
+}
+
+void UBowlingScoreWidget::NativePreConstruct()
+{
+	Super::NativePreConstruct();
+
+	// Frames are only built here for the designer preview, in game NativeConstruct builds them straight after. Both
+	// only run once the scorecard's Slate widget is first built, so a scorecard created for a lane that's never shown
+	// doesn't build any frame widgets.
+	if (IsDesignTime())
+	{
+		CreateFrameWidgets();
+	}
+}
+
+void UBowlingScoreWidget::NativeConstruct()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBowlingScoreWidget::NativeConstruct);
+	LLM_SCOPE_BYTAG(Bowling_Widgets);
+
+	Super::NativeConstruct();
+
+	CreateFrameWidgets();
+
+	// Bind to reset button
+	if (ensure(ResetButton))
+	{
+		ResetButton->OnClicked.AddUniqueDynamic(this, &UBowlingScoreWidget::Reset);
+	}
+
+	auto* BowlingScoreComponent = GetBowlingScoreComponent();
+	if (not ensure(BowlingScoreComponent)) { return; }
+
+	// Listen to relevant game events and "start" the game
+	BowlingScoreComponent->OnGameAdvanced.AddUniqueDynamic(this, &UBowlingScoreWidget::GameAdvanced);
+	BowlingScoreComponent->OnGameOver.AddUniqueDynamic(this, &UBowlingScoreWidget::GameOver);
+
+	// A fresh game doesn't need another reset, the scorecard only has to catch up to the first shot
+	if (BowlingScoreComponent->HasStarted())
+	{
+		BowlingScoreComponent->Reset();
+	}
+	else
+	{
+		GameAdvanced(BowlingScoreComponent, BowlingScoreComponent->GetCurrentFrameNum(),
+		             BowlingScoreComponent->GetCurrentShotNum());
+	}
+
+	// Set focus to the first frame
+	if (not ensure(FrameBox)) { return; }
+	SetDesiredFocusWidget(FrameBox->GetChildAt(0));
+	SetFocus();
+}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "BowlingRuleSets.h"
 #include "BowlingFrameWidget.generated.h"
 
 class UTextBlock;
@@ -14,7 +15,7 @@ class UEditableTextBox;
  * Widget for a single frame of a bowling game.
  */
 UCLASS()
-class BOWLINGSCORESYSTEM_API UBowlingFrameWidget : public UUserWidget
+class BOWLINGSCOREUI_API UBowlingFrameWidget : public UUserWidget
 {
 	GENERATED_BODY()
 
@@ -33,7 +34,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	void SetCurrentGameState(int32 CurrentFrame, int32 CurrentShot);
 
-	// Update the widget's score from the bowling component
+	// Update the widget's score from the bowling component, or from what its scoring worker last published
 	UFUNCTION(BlueprintCallable, Category=Bowling)
 	void UpdateScore();
 
@@ -43,12 +44,20 @@ public:
 
 	int32 GetFrameNumber() const { return FrameNumber; }
 
+	// Set the rules the frame is laid out for, before SetFrame. Defaults to ten-pin.
+	void SetRuleSet(const FBowlingRuleSet& InRuleSet) { RuleSet = &InRuleSet; }
+
 protected:
 	UBowlingScoreComponent* GetBowlingScoreComponent() const;
 
+	// Textbox for a shot of the frame, 1 to 3. Null if the frame doesn't have the shot.
+	UEditableTextBox* GetShotTextBox(int32 Shot) const;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Bowling)
 	int32 FrameNumber;
 
+	const FBowlingRuleSet* RuleSet = &FBowlingRuleSet::Get<FTenPinRules>();
+
 	UPROPERTY(BlueprintReadWrite, Category=Bowling, meta=(BindWidget))
 	TObjectPtr<UEditableTextBox> Shot1TextBox;
 
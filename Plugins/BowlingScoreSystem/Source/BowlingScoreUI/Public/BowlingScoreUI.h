@@ -0,0 +1,21 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Modules/ModuleManager.h"
+
+/*
+ * Scorecard widgets for BowlingScoreSystem. Kept out of the scoring module so a headless lane server never loads UMG
+ * or Slate. Times shots to the screen for FBowlingLatencyTracker, since this is what draws them.
+ */
+class FBowlingScoreUIModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+private:
+	FDelegateHandle MemoryReportHandle;
+};
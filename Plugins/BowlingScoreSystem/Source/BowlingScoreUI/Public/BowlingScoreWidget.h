@@ -17,13 +17,20 @@ class UBowlingFrameWidget;
  * Scorecard can be reset
  */
 UCLASS()
-class BOWLINGSCORESYSTEM_API UBowlingScoreWidget : public UUserWidget
+class BOWLINGSCOREUI_API UBowlingScoreWidget : public UUserWidget
 {
 	GENERATED_BODY()
 
 public:
 	UBowlingScoreWidget(const FObjectInitializer& ObjectInitializer);
 
+	// Size of the UObjects making up the scorecard, every frame widget included. The Slate widgets behind them are
+	// built under LLM's Bowling_Widgets tag, which is where their bytes are counted (see Bowling.Memory).
+	SIZE_T GetWidgetObjectSize() const;
+
+	// Slate widgets behind the scorecard, 0 until it's first shown
+	int32 GetNumSlateWidgets() const;
+
 protected:
 	UBowlingScoreComponent* GetBowlingScoreComponent() const;
 
@@ -39,6 +46,9 @@ protected:
 	UFUNCTION()
 	void GameOver(UBowlingScoreComponent* BowlingScoreComponent);
 
+	// Fill FrameBox with a widget per frame, if it hasn't been already
+	void CreateFrameWidgets();
+
 	// This HorizontalBox holds all the frame widgets
 	UPROPERTY(BlueprintReadWrite, meta=(BindWidget))
 	TObjectPtr<UHorizontalBox> FrameBox;
@@ -51,6 +61,8 @@ protected:
 	TSubclassOf<UBowlingFrameWidget> BowlingFrameWidgetClass;
 
 protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
 	virtual void NativePreConstruct() override;
 
 	virtual void NativeConstruct() override;
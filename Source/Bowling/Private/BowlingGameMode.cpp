@@ -4,6 +4,7 @@
 
 #include "BowlingPlayerState.h"
 #include "Blueprint/UserWidget.h"
+#include "ProfilingDebugging/ScopedTimers.h"
 
 ABowlingGameMode::ABowlingGameMode()
 {
@@ -14,6 +15,9 @@ void ABowlingGameMode::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Startup cost of the scorecard, from creating the widget to it being constructed and focused
+	SCOPE_LOG_TIME_IN_SECONDS(TEXT("Bowling score widget startup"), nullptr);
+
 	// For the sake of simplicity, only displaying the first player's score
 	auto* PlayerController = GetWorld()->GetFirstPlayerController();
 	if (PlayerController and ensure(BowlingScoreWidgetClass))